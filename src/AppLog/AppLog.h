@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "AppLogLevels.h"
+#include "logging/LoggingManager.h"
+
+// Leveled log macros for hot paths.
+//
+// APP_LOG_COMPILE_LEVEL removes call sites above it at preprocessing time:
+// no argument evaluation, no format string in flash, no call.
+// Call sites that are compiled in check a runtime gate (one byte compare)
+// before any argument is evaluated or LoggingManager is entered.
+//
+//   APP_LOG_TRACE("PID", "in=%d out=%d", in, out);
+//
+// Build with -DAPP_LOG_COMPILE_LEVEL=5 to compile trace logging in.
+
+// Most verbose level any output consumes. setupLogging() derives it from the serial, GUI and global
+// levels it configures; code that changes an output level later must update it too.
+inline uint8_t appLogRuntimeLevel = APP_LOG_LEVEL_INFO;
+
+inline bool appLogEnabled(uint8_t level)
+{
+    return level <= appLogRuntimeLevel;
+}
+
+inline cm::LoggingManager::Level appLogToCm(uint8_t level)
+{
+    switch (level)
+    {
+    case APP_LOG_LEVEL_ERROR:
+        return cm::LoggingManager::Level::Error;
+    case APP_LOG_LEVEL_WARN:
+        return cm::LoggingManager::Level::Warn;
+    case APP_LOG_LEVEL_INFO:
+        return cm::LoggingManager::Level::Info;
+    case APP_LOG_LEVEL_DEBUG:
+        return cm::LoggingManager::Level::Debug;
+    default:
+        return cm::LoggingManager::Level::Trace;
+    }
+}
+
+inline uint8_t appLogFromCm(cm::LoggingManager::Level level)
+{
+    switch (level)
+    {
+    case cm::LoggingManager::Level::Off:
+        return APP_LOG_LEVEL_OFF;
+    case cm::LoggingManager::Level::Error:
+        return APP_LOG_LEVEL_ERROR;
+    case cm::LoggingManager::Level::Warn:
+        return APP_LOG_LEVEL_WARN;
+    case cm::LoggingManager::Level::Info:
+        return APP_LOG_LEVEL_INFO;
+    case cm::LoggingManager::Level::Debug:
+        return APP_LOG_LEVEL_DEBUG;
+    default:
+        return APP_LOG_LEVEL_TRACE;
+    }
+}
+
+// Compiled-in call site: runtime gate first, arguments are only evaluated when it passes.
+#define APP_LOG_IF(compiled, level, tag, ...)                                                    \
+    do                                                                                           \
+    {                                                                                            \
+        if ((compiled) && appLogEnabled(level))                                                  \
+        {                                                                                        \
+            cm::LoggingManager::instance().logTag(appLogToCm(level), tag, __VA_ARGS__);          \
+        }                                                                                        \
+    } while (0)
+
+#if APP_LOG_COMPILE_LEVEL >= APP_LOG_LEVEL_TRACE
+#define APP_LOG_TRACE(tag, ...) APP_LOG_IF(true, APP_LOG_LEVEL_TRACE, tag, __VA_ARGS__)
+#else
+#define APP_LOG_TRACE(tag, ...) ((void)0)
+#endif
+
+#if APP_LOG_COMPILE_LEVEL >= APP_LOG_LEVEL_DEBUG
+#define APP_LOG_DEBUG(tag, ...) APP_LOG_IF(true, APP_LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
+#else
+#define APP_LOG_DEBUG(tag, ...) ((void)0)
+#endif
+
+#if APP_LOG_COMPILE_LEVEL >= APP_LOG_LEVEL_INFO
+#define APP_LOG_INFO(tag, ...) APP_LOG_IF(true, APP_LOG_LEVEL_INFO, tag, __VA_ARGS__)
+#else
+#define APP_LOG_INFO(tag, ...) ((void)0)
+#endif
+
+// Prints per-tick cost of the control-step trace call sites in three modes
+// (compiled out, compiled in but gated off, enabled). Only built with -DAPP_LOG_BENCHMARK.
+void runLogBenchmark();
@@ -0,0 +1,79 @@
+#include "AppLog.h"
+
+#if defined(APP_LOG_BENCHMARK)
+
+#include <Arduino.h>
+
+#include "BinLog/BinLog.h"
+
+namespace
+{
+constexpr int BENCH_TICKS = 200;
+
+// Inputs are volatile so the compiler cannot fold the argument evaluation away.
+volatile int benchInputs[12] = {310, -120, 0, 120, 30, 190, 190, 190, 185, 0, 800, 185};
+
+// Same two call sites processRS485Tick() has per PID tick.
+template <bool Compiled>
+void controlTickLogs()
+{
+    APP_LOG_IF(Compiled, APP_LOG_LEVEL_TRACE, "RS485", "Controller enabled -> set inverter to %d W (calc=%d, corr=%d)",
+               benchInputs[11], benchInputs[8], benchInputs[8]);
+    APP_LOG_IF(Compiled, APP_LOG_LEVEL_TRACE, "PID", "inv=%d gridSigned=%d gridIn=%d gridOut=%d off=%d base=%d clamp=%d in=%d out=%d min=%d max=%d set=%d",
+               benchInputs[0], benchInputs[1], benchInputs[2], benchInputs[3], benchInputs[4], benchInputs[5],
+               benchInputs[6], benchInputs[7], benchInputs[8], benchInputs[9], benchInputs[10], benchInputs[11]);
+}
+
+// The same two records into the binary ring.
+void controlTickBinLogs()
+{
+    BINLOG_TRACE("BENCH", "Controller enabled -> set inverter to %d W (calc=%d, corr=%d)",
+                 benchInputs[11], benchInputs[8], benchInputs[8]);
+    BINLOG_TRACE("BENCH", "inv=%d gridSigned=%d gridIn=%d gridOut=%d off=%d base=%d clamp=%d in=%d out=%d min=%d max=%d set=%d",
+                 benchInputs[0], benchInputs[1], benchInputs[2], benchInputs[3], benchInputs[4], benchInputs[5],
+                 benchInputs[6], benchInputs[7], benchInputs[8], benchInputs[9], benchInputs[10], benchInputs[11]);
+}
+
+template <void (*Tick)()>
+uint32_t cyclesPerTick()
+{
+    const uint32_t start = ESP.getCycleCount();
+    for (int i = 0; i < BENCH_TICKS; ++i)
+    {
+        Tick();
+    }
+    return (ESP.getCycleCount() - start) / BENCH_TICKS;
+}
+} // namespace
+
+void runLogBenchmark()
+{
+    auto &lm = cm::LoggingManager::instance();
+    const uint8_t savedGate = appLogRuntimeLevel;
+    const uint32_t mhz = static_cast<uint32_t>(getCpuFrequencyMhz());
+
+    appLogRuntimeLevel = APP_LOG_LEVEL_DEBUG;
+    const uint32_t compiledOut = cyclesPerTick<controlTickLogs<false>>();
+    const uint32_t gatedOff = cyclesPerTick<controlTickLogs<true>>();
+    const uint32_t binary = cyclesPerTick<controlTickBinLogs>();
+
+    // "Enabled" goes through LoggingManager formatting and output filtering.
+    appLogRuntimeLevel = APP_LOG_LEVEL_TRACE;
+    lm.setGlobalLevel(cm::LoggingManager::Level::Trace);
+    const uint32_t enabled = cyclesPerTick<controlTickLogs<true>>();
+    lm.setGlobalLevel(appLogToCm(savedGate));
+    appLogRuntimeLevel = savedGate;
+
+    lm.logTag(cm::LoggingManager::Level::Info, "BENCH", "log cost per control tick (%d ticks): compiled out %lu cyc, gated off %lu cyc, binary %lu cyc, enabled %lu cyc (%lu us)",
+              BENCH_TICKS, static_cast<unsigned long>(compiledOut), static_cast<unsigned long>(gatedOff),
+              static_cast<unsigned long>(binary), static_cast<unsigned long>(enabled),
+              static_cast<unsigned long>(enabled / (mhz ? mhz : 1)));
+}
+
+#else
+
+void runLogBenchmark()
+{
+}
+
+#endif
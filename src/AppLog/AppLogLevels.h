@@ -0,0 +1,13 @@
+#pragma once
+
+// Log levels shared by the text macros (AppLog.h) and the binary logger (BinLog/BinLog.h).
+#define APP_LOG_LEVEL_OFF 0
+#define APP_LOG_LEVEL_ERROR 1
+#define APP_LOG_LEVEL_WARN 2
+#define APP_LOG_LEVEL_INFO 3
+#define APP_LOG_LEVEL_DEBUG 4
+#define APP_LOG_LEVEL_TRACE 5
+
+#ifndef APP_LOG_COMPILE_LEVEL
+#define APP_LOG_COMPILE_LEVEL APP_LOG_LEVEL_DEBUG
+#endif
@@ -0,0 +1,93 @@
+#include "BinLog.h"
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+namespace
+{
+portMUX_TYPE binLogMux = portMUX_INITIALIZER_UNLOCKED;
+
+struct BinLogLock
+{
+    BinLogLock() { portENTER_CRITICAL(&binLogMux); }
+    ~BinLogLock() { portEXIT_CRITICAL(&binLogMux); }
+};
+
+uint32_t binLogNowMs()
+{
+    return millis();
+}
+} // namespace
+#else
+#include <chrono>
+#include <mutex>
+
+namespace
+{
+std::mutex binLogMutex;
+
+struct BinLogLock
+{
+    BinLogLock() { binLogMutex.lock(); }
+    ~BinLogLock() { binLogMutex.unlock(); }
+};
+
+uint32_t binLogNowMs()
+{
+    using namespace std::chrono;
+    return static_cast<uint32_t>(duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+}
+} // namespace
+#endif
+
+BinLog binLog;
+
+void BinLog::dropOldest()
+{
+    const uint32_t meta = ring[(head + 2) % BINLOG_RING_WORDS];
+    const size_t words = BINLOG_HEADER_WORDS + ((meta >> 8) & 0xFF);
+    head = (head + words) % BINLOG_RING_WORDS;
+    used -= words;
+    ++overwritten;
+}
+
+void BinLog::record(uint32_t id, uint8_t level, const uint32_t *args, uint8_t argc)
+{
+    if (argc > MAX_ARGS)
+    {
+        argc = MAX_ARGS;
+    }
+    const size_t words = BINLOG_HEADER_WORDS + argc;
+    const uint32_t now = binLogNowMs();
+
+    BinLogLock lock;
+    while (used + words > BINLOG_RING_WORDS)
+    {
+        dropOldest();
+    }
+
+    size_t pos = (head + used) % BINLOG_RING_WORDS;
+    ring[pos] = id;
+    pos = (pos + 1) % BINLOG_RING_WORDS;
+    ring[pos] = now;
+    pos = (pos + 1) % BINLOG_RING_WORDS;
+    ring[pos] = static_cast<uint32_t>(level) | (static_cast<uint32_t>(argc) << 8) | (static_cast<uint32_t>(sequence++) << 16);
+    for (uint8_t i = 0; i < argc; ++i)
+    {
+        pos = (pos + 1) % BINLOG_RING_WORDS;
+        ring[pos] = args[i];
+    }
+    used += words;
+}
+
+size_t BinLog::snapshot(uint32_t *out, size_t maxWords) const
+{
+    BinLogLock lock;
+    const size_t count = used < maxWords ? used : maxWords;
+    for (size_t i = 0; i < count; ++i)
+    {
+        out[i] = ring[(head + i) % BINLOG_RING_WORDS];
+    }
+    return count;
+}
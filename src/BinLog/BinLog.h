@@ -0,0 +1,120 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#include "AppLog/AppLogLevels.h"
+
+// Deferred binary logger.
+//
+// A call site stores only a 32-bit format-string id (FNV-1a of "tag|format",
+// computed at compile time), a millisecond timestamp and its numeric arguments
+// as raw 32-bit words in a fixed RAM ring. Nothing is formatted on the device
+// and the format string itself is not linked into the firmware.
+//
+// The id -> (tag, format) table is collected from the sources at build time
+// (tools/binlog_strings.py) and served as /binlog-strings.json; the viewer at
+// /binlog or tools/binlog_decode.py do the printf-style formatting.
+//
+//   BINLOG_TRACE("PID", "in=%d out=%d kp=%.2f", in, out, kp);
+//
+// Arguments must be integers, enums or floating point (stored as float bits).
+// The tag and format must be string literals so the build-time scan finds them.
+
+// FEATURE_BINLOG_ENABLED=0 turns every BINLOG_* call into nothing; the ring, /binlog.bin and the
+// /binlog page are then not linked (the flag lives here because every call site includes this header).
+#ifndef FEATURE_BINLOG_ENABLED
+#define FEATURE_BINLOG_ENABLED 1
+#endif
+
+#ifndef BINLOG_RING_WORDS
+#define BINLOG_RING_WORDS 1024 // 4 KB; a 12-argument record takes 15 words
+#endif
+
+// Dump layout (little endian), served by GET /binlog.bin:
+//   "BLG1", u32 uptimeMs, u32 epochOffsetSec (0 = unknown), u32 overwrittenRecords, u32 wordCount, words...
+// Record: u32 id, u32 timestampMs, u32 (level | argc << 8 | seq << 16), argc argument words.
+static constexpr size_t BINLOG_HEADER_WORDS = 3;
+static constexpr size_t BINLOG_DUMP_HEADER_BYTES = 20;
+
+constexpr uint32_t binLogHash(const char *text)
+{
+    uint32_t hash = 2166136261u;
+    while (*text != '\0')
+    {
+        hash = (hash ^ static_cast<uint8_t>(*text)) * 16777619u;
+        ++text;
+    }
+    return hash;
+}
+
+class BinLog
+{
+public:
+    static constexpr size_t MAX_ARGS = 12;
+
+    void record(uint32_t id, uint8_t level, const uint32_t *args, uint8_t argc);
+
+    // Copies all records, oldest first, into out. Returns the number of words written.
+    size_t snapshot(uint32_t *out, size_t maxWords) const;
+
+    uint32_t overwrittenRecords() const { return overwritten; }
+    size_t usedWords() const { return used; }
+
+private:
+    uint32_t ring[BINLOG_RING_WORDS] = {};
+    size_t head = 0; // index of the oldest record
+    size_t used = 0; // words in use
+    uint16_t sequence = 0;
+    uint32_t overwritten = 0;
+
+    void dropOldest();
+};
+
+extern BinLog binLog;
+
+template <typename T>
+inline uint32_t binLogWord(T value)
+{
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "BINLOG arguments must be numeric");
+    if constexpr (std::is_floating_point<T>::value)
+    {
+        const float f = static_cast<float>(value);
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        return bits;
+    }
+    else
+    {
+        return static_cast<uint32_t>(value);
+    }
+}
+
+template <typename... Args>
+inline void binLogRecord(uint32_t id, uint8_t level, Args... args)
+{
+    static_assert(sizeof...(Args) <= BinLog::MAX_ARGS, "too many BINLOG arguments");
+    const uint32_t words[sizeof...(Args) + 1] = {binLogWord(args)..., 0};
+    binLog.record(id, level, words, static_cast<uint8_t>(sizeof...(Args)));
+}
+
+#if FEATURE_BINLOG_ENABLED
+#define BINLOG_AT(level, tag, fmt, ...) \
+    binLogRecord(std::integral_constant<uint32_t, binLogHash(tag "|" fmt)>::value, level, ##__VA_ARGS__)
+#else
+// Still takes the arguments, so values only computed for a trace do not become unused-variable warnings.
+template <typename... Args>
+inline void binLogDiscard(Args...)
+{
+}
+
+#define BINLOG_AT(level, tag, fmt, ...) binLogDiscard(level, ##__VA_ARGS__)
+#endif
+
+#define BINLOG_TRACE(tag, fmt, ...) BINLOG_AT(APP_LOG_LEVEL_TRACE, tag, fmt, ##__VA_ARGS__)
+#define BINLOG_DEBUG(tag, fmt, ...) BINLOG_AT(APP_LOG_LEVEL_DEBUG, tag, fmt, ##__VA_ARGS__)
+#define BINLOG_INFO(tag, fmt, ...) BINLOG_AT(APP_LOG_LEVEL_INFO, tag, fmt, ##__VA_ARGS__)
+#define BINLOG_WARN(tag, fmt, ...) BINLOG_AT(APP_LOG_LEVEL_WARN, tag, fmt, ##__VA_ARGS__)
+#define BINLOG_ERROR(tag, fmt, ...) BINLOG_AT(APP_LOG_LEVEL_ERROR, tag, fmt, ##__VA_ARGS__)
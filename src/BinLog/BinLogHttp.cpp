@@ -0,0 +1,60 @@
+#include "BinLogHttp.h"
+
+#include <memory>
+#include <time.h>
+
+namespace
+{
+struct BinLogDump
+{
+    uint8_t header[BINLOG_DUMP_HEADER_BYTES];
+    uint32_t words[BINLOG_RING_WORDS];
+    size_t totalBytes = 0;
+    size_t offset = 0;
+};
+
+void putU32(uint8_t *out, uint32_t value)
+{
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+    out[2] = static_cast<uint8_t>(value >> 16);
+    out[3] = static_cast<uint8_t>(value >> 24);
+}
+} // namespace
+
+void registerBinLogRoutes(AsyncWebServer &server, BinLog &log)
+{
+    server.on("/binlog.bin", HTTP_GET, [&log](AsyncWebServerRequest *request)
+              {
+        // Snapshot first so the download is consistent while the ring keeps filling.
+        auto dump = std::make_shared<BinLogDump>();
+        const uint32_t uptimeMs = millis();
+        const size_t wordCount = log.snapshot(dump->words, BINLOG_RING_WORDS);
+        const time_t epochNow = time(nullptr);
+        const uint32_t epochOffset = epochNow > 1600000000 ? static_cast<uint32_t>(epochNow) - uptimeMs / 1000UL : 0;
+
+        memcpy(dump->header, "BLG1", 4);
+        putU32(dump->header + 4, uptimeMs);
+        putU32(dump->header + 8, epochOffset);
+        putU32(dump->header + 12, log.overwrittenRecords());
+        putU32(dump->header + 16, static_cast<uint32_t>(wordCount));
+        dump->totalBytes = BINLOG_DUMP_HEADER_BYTES + wordCount * sizeof(uint32_t);
+
+        AsyncWebServerResponse *response = request->beginChunkedResponse("application/octet-stream",
+            [dump](uint8_t *buffer, size_t maxLen, size_t) -> size_t
+            {
+                size_t written = 0;
+                while (written < maxLen && dump->offset < dump->totalBytes)
+                {
+                    const size_t at = dump->offset;
+                    buffer[written++] = at < BINLOG_DUMP_HEADER_BYTES
+                                            ? dump->header[at]
+                                            : reinterpret_cast<const uint8_t *>(dump->words)[at - BINLOG_DUMP_HEADER_BYTES];
+                    ++dump->offset;
+                }
+                return written;
+            });
+        response->addHeader("Content-Disposition", "attachment; filename=\"binlog.bin\"");
+        response->addHeader("Cache-Control", "no-store");
+        request->send(response); });
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <ESPAsyncWebServer.h>
+
+#include "BinLog.h"
+
+// Registers GET /binlog.bin: a snapshot of the binary log ring (layout in BinLog.h).
+// Format it with /binlog in the browser or tools/binlog_decode.py.
+void registerBinLogRoutes(AsyncWebServer &server, BinLog &log);
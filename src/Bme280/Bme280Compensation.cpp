@@ -0,0 +1,157 @@
+#include "Bme280Compensation.h"
+
+namespace
+{
+constexpr int32_t SKIPPED_TP = 0x80000;
+constexpr int32_t SKIPPED_H = 0x8000;
+
+uint16_t u16le(const uint8_t *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+int16_t s16le(const uint8_t *p)
+{
+    return static_cast<int16_t>(u16le(p));
+}
+
+uint32_t oversamplingCount(uint8_t code)
+{
+    return code == 0 ? 0U : (1U << (code > 5 ? 4 : code - 1));
+}
+} // namespace
+
+uint32_t Bme280Oversampling::conversionTimeUs() const
+{
+    uint32_t us = 1250U + 2300U * oversamplingCount(temperature);
+    if (pressure != 0)
+    {
+        us += 2300U * oversamplingCount(pressure) + 575U;
+    }
+    if (humidity != 0)
+    {
+        us += 2300U * oversamplingCount(humidity) + 575U;
+    }
+    return us;
+}
+
+Bme280Oversampling Bme280Oversampling::forInterval(uint32_t intervalMs)
+{
+    Bme280Oversampling os;
+    if (intervalMs < 5000UL)
+    {
+        os.temperature = 1; // x1 / x1 / x1  ~ 9.3 ms
+        os.pressure = 1;
+        os.humidity = 1;
+    }
+    else if (intervalMs < 60000UL)
+    {
+        os.temperature = 2; // x2 / x4 / x2  ~ 21 ms
+        os.pressure = 3;
+        os.humidity = 2;
+    }
+    else
+    {
+        os.temperature = 3; // x4 / x16 / x4 ~ 58 ms
+        os.pressure = 5;
+        os.humidity = 3;
+    }
+    return os;
+}
+
+bool Bme280Compensator::setCalibration(const uint8_t *tp, const uint8_t *h)
+{
+    calibrated = false;
+    if (tp == nullptr || h == nullptr || u16le(&tp[0]) == 0 || u16le(&tp[6]) == 0)
+    {
+        return false;
+    }
+
+    t1 = u16le(&tp[0]);
+    t1x2 = t1 << 1;
+    t2 = s16le(&tp[2]);
+    t3 = s16le(&tp[4]);
+
+    p1 = u16le(&tp[6]);
+    p2 = s16le(&tp[8]);
+    p3 = s16le(&tp[10]);
+    p4x35 = static_cast<int64_t>(s16le(&tp[12])) * (static_cast<int64_t>(1) << 35);
+    p5 = s16le(&tp[14]);
+    p6 = s16le(&tp[16]);
+    p7x4 = static_cast<int64_t>(s16le(&tp[18])) * 16;
+    p8 = s16le(&tp[20]);
+    p9 = s16le(&tp[22]);
+
+    h1 = tp[25];
+    h2 = s16le(&h[0]);
+    h3 = h[2];
+    // dig_H4 / dig_H5 are 12-bit values sharing the nibbles of 0xE5.
+    const int32_t h4 = (static_cast<int32_t>(static_cast<int8_t>(h[3])) * 16) | (h[4] & 0x0F);
+    h4x20 = h4 * (1 << 20);
+    h5 = (static_cast<int32_t>(static_cast<int8_t>(h[5])) * 16) | (h[4] >> 4);
+    h6 = static_cast<int8_t>(h[6]);
+
+    calibrated = true;
+    return true;
+}
+
+int32_t Bme280Compensator::temperatureFine(int32_t adcT) const
+{
+    const int32_t var1 = (((adcT >> 3) - t1x2) * t2) >> 11;
+    const int32_t d = (adcT >> 4) - t1;
+    const int32_t var2 = (((d * d) >> 12) * t3) >> 14;
+    return var1 + var2;
+}
+
+uint32_t Bme280Compensator::pressureQ24_8(int32_t adcP, int32_t tFine) const
+{
+    int64_t var1 = static_cast<int64_t>(tFine) - 128000;
+    int64_t var2 = var1 * var1 * p6;
+    var2 += (var1 * p5) * 131072;
+    var2 += p4x35;
+    var1 = ((var1 * var1 * p3) >> 8) + ((var1 * p2) * 4096);
+    var1 = (((static_cast<int64_t>(1) << 47) + var1) * p1) >> 33;
+    if (var1 == 0)
+    {
+        return 0; // avoid division by zero
+    }
+    int64_t p = 1048576 - adcP;
+    p = (((p * (static_cast<int64_t>(1) << 31)) - var2) * 3125) / var1;
+    var1 = (p9 * (p >> 13) * (p >> 13)) >> 25;
+    var2 = (p8 * p) >> 19;
+    p = ((p + var1 + var2) >> 8) + p7x4;
+    return static_cast<uint32_t>(p);
+}
+
+uint32_t Bme280Compensator::humidityQ22_10(int32_t adcH, int32_t tFine) const
+{
+    int32_t v = tFine - 76800;
+    v = ((((adcH << 14) - h4x20 - (h5 * v)) + 16384) >> 15) *
+        (((((((v * h6) >> 10) * (((v * h3) >> 11) + 32768)) >> 10) + 2097152) * h2 + 8192) >> 14);
+    v = v - (((((v >> 15) * (v >> 15)) >> 7) * h1) >> 4);
+    v = v < 0 ? 0 : v;
+    v = v > 419430400 ? 419430400 : v;
+    return static_cast<uint32_t>(v >> 12);
+}
+
+bool Bme280Compensator::compensate(const uint8_t *data, Bme280Reading &out) const
+{
+    if (!calibrated || data == nullptr)
+    {
+        return false;
+    }
+
+    const int32_t adcP = (static_cast<int32_t>(data[0]) << 12) | (data[1] << 4) | (data[2] >> 4);
+    const int32_t adcT = (static_cast<int32_t>(data[3]) << 12) | (data[4] << 4) | (data[5] >> 4);
+    const int32_t adcH = (static_cast<int32_t>(data[6]) << 8) | data[7];
+    if (adcT == SKIPPED_TP)
+    {
+        return false;
+    }
+
+    const int32_t tFine = temperatureFine(adcT);
+    out.temperatureC = static_cast<float>((tFine * 5 + 128) >> 8) / 100.0f;
+    out.pressureHpa = adcP == SKIPPED_TP ? 0.0f : static_cast<float>(pressureQ24_8(adcP, tFine)) / 25600.0f;
+    out.humidityPct = adcH == SKIPPED_H ? 0.0f : static_cast<float>(humidityQ22_10(adcH, tFine)) / 1024.0f;
+    return true;
+}
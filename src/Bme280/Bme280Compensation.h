@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// BME280 register map (subset used by the forced-mode driver).
+static constexpr uint8_t BME280_REG_CALIB_TP = 0x88; // 26 bytes: dig_T1..dig_P9, dig_H1 at 0xA1
+static constexpr uint8_t BME280_REG_CHIP_ID = 0xD0;
+static constexpr uint8_t BME280_REG_RESET = 0xE0;
+static constexpr uint8_t BME280_REG_CALIB_H = 0xE1;  // 7 bytes: dig_H2..dig_H6
+static constexpr uint8_t BME280_REG_CTRL_HUM = 0xF2;
+static constexpr uint8_t BME280_REG_CTRL_MEAS = 0xF4;
+static constexpr uint8_t BME280_REG_CONFIG = 0xF5;
+static constexpr uint8_t BME280_REG_DATA = 0xF7;     // 8 bytes: press[3], temp[3], hum[2]
+static constexpr uint8_t BME280_CHIP_ID = 0x60;
+static constexpr size_t BME280_CALIB_TP_BYTES = 26;
+static constexpr size_t BME280_CALIB_H_BYTES = 7;
+static constexpr size_t BME280_DATA_BYTES = 8;
+
+struct Bme280Reading
+{
+    float temperatureC = 0.0f;
+    float pressureHpa = 0.0f;
+    float humidityPct = 0.0f;
+};
+
+// Oversampling register codes (0 = skipped, 1..5 = x1, x2, x4, x8, x16).
+struct Bme280Oversampling
+{
+    uint8_t temperature = 1;
+    uint8_t pressure = 1;
+    uint8_t humidity = 1;
+
+    // Worst-case forced-mode conversion time from the datasheet (microseconds).
+    uint32_t conversionTimeUs() const;
+
+    // Longer read intervals get more oversampling (less noise per reading);
+    // short intervals stay at x1 so each conversion is only a few milliseconds.
+    static Bme280Oversampling forInterval(uint32_t intervalMs);
+};
+
+// Integer compensation from the Bosch datasheet with the calibration words
+// parsed and pre-shifted once, so a reading only costs the per-sample math.
+class Bme280Compensator
+{
+public:
+    // tp: 26 bytes from 0x88, h: 7 bytes from 0xE1. Returns false for an all-zero (unread) block.
+    bool setCalibration(const uint8_t *tp, const uint8_t *h);
+    bool valid() const { return calibrated; }
+
+    // data: 8-byte burst from 0xF7. Returns false if the sample was skipped or no calibration is loaded.
+    bool compensate(const uint8_t *data, Bme280Reading &out) const;
+
+private:
+    bool calibrated = false;
+
+    // temperature
+    int32_t t1x2 = 0; // dig_T1 << 1
+    int32_t t1 = 0;
+    int32_t t2 = 0;
+    int32_t t3 = 0;
+    // pressure
+    int64_t p1 = 0;
+    int64_t p2 = 0;
+    int64_t p3 = 0;
+    int64_t p4x35 = 0; // dig_P4 << 35
+    int64_t p5 = 0;
+    int64_t p6 = 0;
+    int64_t p7x4 = 0;  // dig_P7 << 4
+    int64_t p8 = 0;
+    int64_t p9 = 0;
+    // humidity
+    int32_t h1 = 0;
+    int32_t h2 = 0;
+    int32_t h3 = 0;
+    int32_t h4x20 = 0; // dig_H4 << 20
+    int32_t h5 = 0;
+    int32_t h6 = 0;
+
+    int32_t temperatureFine(int32_t adcT) const;
+    uint32_t pressureQ24_8(int32_t adcP, int32_t tFine) const;
+    uint32_t humidityQ22_10(int32_t adcH, int32_t tFine) const;
+};
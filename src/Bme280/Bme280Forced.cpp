@@ -0,0 +1,133 @@
+#include "Bme280Forced.h"
+
+namespace
+{
+constexpr uint8_t MODE_FORCED = 0x01;
+constexpr uint8_t CONFIG_FILTER_OFF = 0x00; // single forced readings, IIR filter would only lag
+constexpr uint8_t SOFT_RESET = 0xB6;
+constexpr unsigned long RESET_STARTUP_MS = 3;
+} // namespace
+
+bool Bme280Forced::begin(uint8_t address)
+{
+    currentState = State::Off;
+    device = bus.addDevice("bme280", address);
+    if (device < 0)
+    {
+        return false;
+    }
+
+    const uint8_t idReg = BME280_REG_CHIP_ID;
+    uint8_t chipId = 0;
+    if (!bus.transferNow(device, &idReg, 1, &chipId, 1) || chipId != BME280_CHIP_ID)
+    {
+        return false;
+    }
+
+    const uint8_t reset[] = {BME280_REG_RESET, SOFT_RESET};
+    if (!bus.transferNow(device, reset, sizeof(reset)))
+    {
+        return false;
+    }
+    delay(RESET_STARTUP_MS);
+
+    uint8_t tp[BME280_CALIB_TP_BYTES];
+    uint8_t h[BME280_CALIB_H_BYTES];
+    const uint8_t tpReg = BME280_REG_CALIB_TP;
+    const uint8_t hReg = BME280_REG_CALIB_H;
+    if (!bus.transferNow(device, &tpReg, 1, tp, sizeof(tp)) ||
+        !bus.transferNow(device, &hReg, 1, h, sizeof(h)) ||
+        !compensator.setCalibration(tp, h))
+    {
+        return false;
+    }
+
+    // Filter and standby time live in CONFIG, which is only writable in sleep mode (after reset).
+    const uint8_t config[] = {BME280_REG_CONFIG, CONFIG_FILTER_OFF};
+    if (!bus.transferNow(device, config, sizeof(config)))
+    {
+        return false;
+    }
+
+    currentState = State::Idle;
+    return true;
+}
+
+bool Bme280Forced::trigger(uint32_t intervalMs)
+{
+    if (currentState != State::Idle)
+    {
+        return false;
+    }
+
+    oversampling = Bme280Oversampling::forInterval(intervalMs);
+    conversionMs = (oversampling.conversionTimeUs() + 999U) / 1000U;
+
+    // CTRL_HUM only takes effect with the following CTRL_MEAS write, so both go in one transaction.
+    const uint8_t cmd[] = {
+        BME280_REG_CTRL_HUM, oversampling.humidity,
+        BME280_REG_CTRL_MEAS, static_cast<uint8_t>((oversampling.temperature << 5) | (oversampling.pressure << 2) | MODE_FORCED),
+    };
+    if (!bus.write(device, cmd, sizeof(cmd), onTriggered, this))
+    {
+        return false;
+    }
+    currentState = State::Triggering;
+    return true;
+}
+
+void Bme280Forced::poll(unsigned long nowMs)
+{
+    if (currentState != State::Converting || static_cast<long>(nowMs - readyAtMs) < 0)
+    {
+        return;
+    }
+
+    const uint8_t reg = BME280_REG_DATA;
+    if (bus.writeRead(device, &reg, 1, BME280_DATA_BYTES, onData, this))
+    {
+        currentState = State::Reading;
+    }
+    // queue full: stay in Converting and retry on the next pass
+}
+
+bool Bme280Forced::takeReading(Bme280Reading &out)
+{
+    if (!readingAvailable)
+    {
+        return false;
+    }
+    out = lastReading;
+    readingAvailable = false;
+    return true;
+}
+
+void Bme280Forced::fail()
+{
+    ++failureCount;
+    currentState = State::Idle;
+}
+
+void Bme280Forced::onTriggered(void *ctx, bool ok, const uint8_t *, size_t)
+{
+    Bme280Forced *self = static_cast<Bme280Forced *>(ctx);
+    if (!ok)
+    {
+        self->fail();
+        return;
+    }
+    self->readyAtMs = millis() + self->conversionMs;
+    self->currentState = State::Converting;
+}
+
+void Bme280Forced::onData(void *ctx, bool ok, const uint8_t *rx, size_t rxLen)
+{
+    Bme280Forced *self = static_cast<Bme280Forced *>(ctx);
+    if (!ok || rxLen != BME280_DATA_BYTES || !self->compensator.compensate(rx, self->lastReading))
+    {
+        self->fail();
+        return;
+    }
+    self->readingAvailable = true;
+    self->currentState = State::Idle;
+}
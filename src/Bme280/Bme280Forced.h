@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "Bme280Compensation.h"
+#include "I2CBus/I2CBus.h"
+
+#ifndef BME280_I2C_ADDRESS
+#define BME280_I2C_ADDRESS 0x76
+#endif
+
+// BME280 in forced mode on the shared I2C bus.
+// The sensor sleeps between readings; trigger() queues one conversion,
+// poll() queues the result burst once the conversion time has passed and
+// takeReading() hands out the compensated values. Nothing here blocks
+// except begin(), which reads the chip id and calibration during setup.
+class Bme280Forced
+{
+public:
+    enum class State : uint8_t
+    {
+        Off,        // not initialized
+        Idle,       // sleeping, ready for trigger()
+        Triggering, // ctrl_meas write queued
+        Converting, // waiting for the conversion time
+        Reading,    // data burst queued
+    };
+
+    explicit Bme280Forced(I2CBus &bus) : bus(bus) {}
+
+    bool begin(uint8_t address = BME280_I2C_ADDRESS);
+
+    // Starts one conversion with oversampling chosen for the read interval.
+    // Returns false if a measurement is still in flight or the bus queue is full.
+    bool trigger(uint32_t intervalMs);
+
+    // Advances the state machine; call every loop pass.
+    void poll(unsigned long nowMs);
+
+    // Returns true once per completed measurement.
+    bool takeReading(Bme280Reading &out);
+
+    State state() const { return currentState; }
+    uint32_t failures() const { return failureCount; }
+    uint32_t conversionTimeMs() const { return conversionMs; }
+
+private:
+    I2CBus &bus;
+    int device = -1;
+    Bme280Compensator compensator;
+    State currentState = State::Off;
+    Bme280Oversampling oversampling;
+    uint32_t conversionMs = 0;
+    unsigned long readyAtMs = 0;
+    Bme280Reading lastReading;
+    bool readingAvailable = false;
+    uint32_t failureCount = 0;
+
+    void fail();
+    static void onTriggered(void *ctx, bool ok, const uint8_t *rx, size_t rxLen);
+    static void onData(void *ctx, bool ok, const uint8_t *rx, size_t rxLen);
+};
@@ -0,0 +1,64 @@
+#include "BootSequence.h"
+
+#include <Arduino.h>
+#include <stdio.h>
+
+bool BootSequence::add(const char *name, Stage stage)
+{
+    if (stageCount >= BOOT_SEQUENCE_MAX_STAGES || stage == nullptr)
+    {
+        return false;
+    }
+    stages[stageCount++] = Entry{name, stage};
+    return true;
+}
+
+void BootSequence::record(const char *name, uint32_t startUs, uint32_t endUs)
+{
+    if (timings >= BOOT_SEQUENCE_MAX_STAGES * 2)
+    {
+        return;
+    }
+    timeline[timings++] = BootStageTiming{name, startUs, endUs - startUs};
+}
+
+bool BootSequence::runNext()
+{
+    if (done())
+    {
+        return false;
+    }
+
+    const Entry &entry = stages[nextStage++];
+    const uint32_t startUs = micros();
+    entry.stage();
+    const uint32_t endUs = micros();
+    record(entry.name, startUs, endUs);
+    if (done())
+    {
+        completedAtUs = endUs;
+    }
+    return !done();
+}
+
+size_t BootSequence::toJson(char *out, size_t maxLen) const
+{
+    if (maxLen == 0)
+    {
+        return 0;
+    }
+    size_t pos = static_cast<size_t>(snprintf(out, maxLen, "{\"safeSetpointUs\":%lu,\"completedUs\":%lu,\"stages\":[",
+                                              static_cast<unsigned long>(safeSetpointAtUs), static_cast<unsigned long>(completedAtUs)));
+    for (size_t i = 0; i < timings && pos < maxLen; ++i)
+    {
+        pos += static_cast<size_t>(snprintf(out + pos, maxLen - pos, "%s{\"name\":\"%s\",\"startUs\":%lu,\"us\":%lu}",
+                                            i == 0 ? "" : ",", timeline[i].name != nullptr ? timeline[i].name : "?",
+                                            static_cast<unsigned long>(timeline[i].startUs),
+                                            static_cast<unsigned long>(timeline[i].durationUs)));
+    }
+    if (pos < maxLen)
+    {
+        pos += static_cast<size_t>(snprintf(out + pos, maxLen - pos, "]}"));
+    }
+    return pos < maxLen ? pos : maxLen - 1;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef BOOT_SEQUENCE_MAX_STAGES
+#define BOOT_SEQUENCE_MAX_STAGES 16
+#endif
+
+struct BootStageTiming
+{
+    const char *name;
+    uint32_t startUs; // since reset
+    uint32_t durationUs;
+};
+
+// Staged startup with a timeline.
+// setup() times its own blocking steps with record(); everything that is not needed to
+// command the inverter is add()ed as a background stage and run one stage per loop() pass.
+class BootSequence
+{
+public:
+    using Stage = void (*)();
+
+    // Queues a background stage; returns false when the table is full.
+    bool add(const char *name, Stage stage);
+
+    // Records a step that already ran (times in micros()).
+    void record(const char *name, uint32_t startUs, uint32_t endUs);
+
+    // Runs the next queued stage. Returns true while stages remain afterwards.
+    bool runNext();
+
+    bool done() const { return nextStage >= stageCount; }
+    size_t timingCount() const { return timings; }
+    const BootStageTiming &timing(size_t index) const { return timeline[index]; }
+
+    // micros() when the boot-safe setpoint went out (0 = not yet) and when the last stage finished.
+    void markSafeSetpoint(uint32_t nowUs) { safeSetpointAtUs = nowUs; }
+    uint32_t safeSetpointUs() const { return safeSetpointAtUs; }
+    uint32_t completedUs() const { return completedAtUs; }
+
+    // {"safeSetpointUs":n,"completedUs":n,"stages":[{"name":"...","startUs":n,"us":n},...]}
+    size_t toJson(char *out, size_t maxLen) const;
+
+private:
+    struct Entry
+    {
+        const char *name;
+        Stage stage;
+    };
+
+    Entry stages[BOOT_SEQUENCE_MAX_STAGES] = {};
+    size_t stageCount = 0;
+    size_t nextStage = 0;
+    BootStageTiming timeline[BOOT_SEQUENCE_MAX_STAGES * 2] = {};
+    size_t timings = 0;
+    uint32_t safeSetpointAtUs = 0;
+    uint32_t completedAtUs = 0;
+};
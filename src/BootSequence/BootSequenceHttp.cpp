@@ -0,0 +1,10 @@
+#include "BootSequenceHttp.h"
+
+void registerBootSequenceRoutes(AsyncWebServer &server, BootSequence &boot)
+{
+    server.on("/boot/timeline", HTTP_GET, [&boot](AsyncWebServerRequest *request)
+              {
+        char json[96 + BOOT_SEQUENCE_MAX_STAGES * 2 * 72];
+        boot.toJson(json, sizeof(json));
+        request->send(200, "application/json", json); });
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <ESPAsyncWebServer.h>
+
+#include "BootSequence.h"
+
+// Registers GET /boot/timeline: per-stage start and duration since reset, plus when
+// the boot-safe setpoint was sent (JSON).
+void registerBootSequenceRoutes(AsyncWebServer &server, BootSequence &boot);
@@ -0,0 +1,288 @@
+#include "ControlLog.h"
+
+#include <string.h>
+
+#include "logging/LoggingManager.h"
+
+namespace
+{
+constexpr size_t SECTOR_BYTES = 4096;
+constexpr uint32_t BLOCKS_PER_SECTOR = SECTOR_BYTES / CONTROL_LOG_BLOCK_BYTES;
+constexpr esp_partition_subtype_t CONTROL_LOG_SUBTYPE = static_cast<esp_partition_subtype_t>(0x40);
+
+uint32_t getLe32(const uint8_t *in)
+{
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+           (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+} // namespace
+
+bool ControlLog::begin()
+{
+    using LL = cm::LoggingManager::Level;
+    auto &lmg = cm::LoggingManager::instance();
+
+    partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, CONTROL_LOG_SUBTYPE, CONTROL_LOG_PARTITION_LABEL);
+    if (partition == nullptr)
+    {
+        lmg.logTag(LL::Warn, "CLOG", "Partition '%s' missing -> control log disabled", CONTROL_LOG_PARTITION_LABEL);
+        return false;
+    }
+
+    slotCount = partition->size / CONTROL_LOG_BLOCK_BYTES;
+    slotCount -= slotCount % BLOCKS_PER_SECTOR;
+
+    // Locate the newest block by sequence number; 8 bytes per slot are enough for that.
+    bool found = false;
+    uint32_t newestSlot = 0;
+    uint32_t newestSequence = 0;
+    for (uint32_t slot = 0; slot < slotCount; ++slot)
+    {
+        uint8_t head[8];
+        if (esp_partition_read(partition, slot * CONTROL_LOG_BLOCK_BYTES, head, sizeof(head)) != ESP_OK)
+        {
+            continue;
+        }
+        if (getLe32(head) != CONTROL_LOG_MAGIC)
+        {
+            continue;
+        }
+        const uint32_t seq = getLe32(head + 4);
+        if (!found || static_cast<int32_t>(seq - newestSequence) > 0)
+        {
+            found = true;
+            newestSlot = slot;
+            newestSequence = seq;
+        }
+    }
+
+    if (found)
+    {
+        nextSlot = (newestSlot + 1) % slotCount;
+        sequence = newestSequence + 1;
+        // Leftovers behind the newest block (torn write, foreign data): continue at the next sector.
+        if (nextSlot % BLOCKS_PER_SECTOR != 0 && !slotIsBlank(nextSlot))
+        {
+            nextSlot = ((nextSlot / BLOCKS_PER_SECTOR + 1) * BLOCKS_PER_SECTOR) % slotCount;
+        }
+    }
+
+    lmg.logTag(LL::Info, "CLOG", "Ready: %lu blocks, next=%lu seq=%lu",
+               static_cast<unsigned long>(slotCount), static_cast<unsigned long>(nextSlot), static_cast<unsigned long>(sequence));
+    return true;
+}
+
+void ControlLog::record(const ControlLogRecord &rec, bool epochTime)
+{
+    if (partition == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    // Never mix uptime and epoch timestamps in one block.
+    if (!builder.empty() && epochTime != builderEpoch && !sealLocked())
+    {
+        ++counters.droppedRecords;
+        return;
+    }
+
+    if (builder.empty())
+    {
+        builderEpoch = epochTime;
+    }
+    if (builder.add(rec))
+    {
+        return;
+    }
+
+    if (!sealLocked())
+    {
+        ++counters.droppedRecords;
+        return;
+    }
+    builderEpoch = epochTime;
+    builder.add(rec);
+}
+
+void ControlLog::service(unsigned long nowMs)
+{
+    if (partition == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (sealedCount > 0 && (!hasWritten || (nowMs - lastWriteMs) >= CONTROL_LOG_MIN_BLOCK_INTERVAL_MS))
+    {
+        writeSealedLocked();
+        return;
+    }
+    const uint32_t sector = nextSlot / BLOCKS_PER_SECTOR;
+    if (nextSlot % BLOCKS_PER_SECTOR == 0 && erasedSector != sector)
+    {
+        eraseSectorLocked(sector);
+    }
+}
+
+bool ControlLog::flush()
+{
+    if (partition == nullptr)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    bool ok = builder.empty() || sealLocked();
+    while (sealedCount > 0)
+    {
+        ok = writeSealedLocked() && ok;
+    }
+    return ok;
+}
+
+bool ControlLog::sealLocked()
+{
+    if (sealedCount >= CONTROL_LOG_SEALED_BLOCKS)
+    {
+        return false;
+    }
+    builder.encode(sealed[(sealedHead + sealedCount) % CONTROL_LOG_SEALED_BLOCKS], sequence++, builderEpoch);
+    builder.reset();
+    ++sealedCount;
+    return true;
+}
+
+bool ControlLog::writeSealedLocked()
+{
+    const uint32_t sector = nextSlot / BLOCKS_PER_SECTOR;
+    bool ok = true;
+    if (nextSlot % BLOCKS_PER_SECTOR == 0 && erasedSector != sector)
+    {
+        ok = eraseSectorLocked(sector); // service() did not get to it in time
+    }
+
+    const uint32_t startUs = micros();
+    if (ok)
+    {
+        ok = esp_partition_write(partition, static_cast<size_t>(nextSlot) * CONTROL_LOG_BLOCK_BYTES, sealed[sealedHead],
+                                 CONTROL_LOG_BLOCK_BYTES) == ESP_OK;
+    }
+    counters.lastWriteUs = micros() - startUs;
+
+    sealedHead = (sealedHead + 1) % CONTROL_LOG_SEALED_BLOCKS;
+    --sealedCount;
+    lastWriteMs = millis();
+    hasWritten = true;
+    nextSlot = (nextSlot + 1) % slotCount;
+
+    if (!ok)
+    {
+        ++counters.writeErrors;
+        return false;
+    }
+    ++counters.blocksWritten;
+    return true;
+}
+
+bool ControlLog::eraseSectorLocked(uint32_t sector)
+{
+    const uint32_t startUs = micros();
+    const esp_err_t err = esp_partition_erase_range(partition, static_cast<size_t>(sector) * SECTOR_BYTES, SECTOR_BYTES);
+    counters.lastEraseUs = micros() - startUs;
+    if (err != ESP_OK)
+    {
+        ++counters.writeErrors;
+        return false;
+    }
+    erasedSector = sector;
+    return true;
+}
+
+bool ControlLog::slotIsBlank(uint32_t slot)
+{
+    uint8_t head[CONTROL_LOG_HEADER_BYTES];
+    if (esp_partition_read(partition, slot * CONTROL_LOG_BLOCK_BYTES, head, sizeof(head)) != ESP_OK)
+    {
+        return false;
+    }
+    for (uint8_t b : head)
+    {
+        if (b != 0xFF)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ControlLog::openCursor(Cursor &cursor)
+{
+    cursor.slotsVisited = 0;
+    cursor.offset = CONTROL_LOG_BLOCK_BYTES;
+    cursor.pendingSent = 0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    cursor.pendingCount = 0;
+    for (size_t i = 0; i < sealedCount; ++i)
+    {
+        memcpy(cursor.pending[cursor.pendingCount++], sealed[(sealedHead + i) % CONTROL_LOG_SEALED_BLOCKS], CONTROL_LOG_BLOCK_BYTES);
+    }
+    if (!builder.empty())
+    {
+        builder.encode(cursor.pending[cursor.pendingCount++], sequence, builderEpoch);
+    }
+}
+
+size_t ControlLog::read(Cursor &cursor, uint8_t *out, size_t outSize)
+{
+    size_t pos = 0;
+    while (pos < outSize)
+    {
+        if (cursor.offset >= CONTROL_LOG_BLOCK_BYTES)
+        {
+            // Next non-blank flash block, oldest first (starting behind the newest one).
+            bool loaded = false;
+            while (partition != nullptr && cursor.slotsVisited < slotCount && !loaded)
+            {
+                const uint32_t slot = (nextSlot + cursor.slotsVisited) % slotCount;
+                ++cursor.slotsVisited;
+                if (esp_partition_read(partition, slot * CONTROL_LOG_BLOCK_BYTES, cursor.block, CONTROL_LOG_BLOCK_BYTES) == ESP_OK &&
+                    getLe32(cursor.block) == CONTROL_LOG_MAGIC)
+                {
+                    loaded = true;
+                }
+            }
+            if (!loaded)
+            {
+                if (cursor.pendingSent >= cursor.pendingCount)
+                {
+                    break;
+                }
+                memcpy(cursor.block, cursor.pending[cursor.pendingSent++], CONTROL_LOG_BLOCK_BYTES);
+            }
+            cursor.offset = 0;
+        }
+
+        size_t n = CONTROL_LOG_BLOCK_BYTES - cursor.offset;
+        if (n > outSize - pos)
+        {
+            n = outSize - pos;
+        }
+        memcpy(out + pos, cursor.block + cursor.offset, n);
+        pos += n;
+        cursor.offset = static_cast<uint16_t>(cursor.offset + n);
+    }
+    return pos;
+}
+
+ControlLog::Stats ControlLog::stats()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats s = counters;
+    s.slotCount = slotCount;
+    s.nextSlot = nextSlot;
+    s.sequence = sequence;
+    s.pendingRecords = static_cast<uint32_t>(builder.size());
+    s.sealedBlocks = static_cast<uint32_t>(sealedCount);
+    return s;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include <mutex>
+
+#include "ControlLogFormat.h"
+
+// Partition label from partitions.csv (data, subtype 0x40).
+#ifndef CONTROL_LOG_PARTITION_LABEL
+#define CONTROL_LOG_PARTITION_LABEL "ctrllog"
+#endif
+
+// Lower bound between two block writes (bounded flash write rate).
+#ifndef CONTROL_LOG_MIN_BLOCK_INTERVAL_MS
+#define CONTROL_LOG_MIN_BLOCK_INTERVAL_MS 60000UL
+#endif
+
+// Full blocks waiting in RAM for service(). Records that arrive while all of them are
+// still waiting are dropped.
+#ifndef CONTROL_LOG_SEALED_BLOCKS
+#define CONTROL_LOG_SEALED_BLOCKS 2
+#endif
+
+// Append-only control log in a dedicated flash partition.
+// record() only appends to RAM: records are collected into a 512-byte columnar block,
+// which is sealed once full. service() does the flash work, at most one operation per
+// call: write the oldest sealed block, or erase the sector the next block goes to, ahead
+// of time, so a block write never waits for an erase. Blocks are written round-robin over
+// the whole partition and each 4 KB sector is erased once per lap (wear levelling by
+// construction). On boot the newest block is located by its sequence number and writing
+// continues behind it.
+class ControlLog
+{
+public:
+    struct Stats
+    {
+        uint32_t slotCount = 0;
+        uint32_t nextSlot = 0;
+        uint32_t sequence = 0;
+        uint32_t blocksWritten = 0;
+        uint32_t droppedRecords = 0;
+        uint32_t writeErrors = 0;
+        uint32_t lastWriteUs = 0;
+        uint32_t lastEraseUs = 0;
+        uint32_t pendingRecords = 0; // in the open block
+        uint32_t sealedBlocks = 0;   // full, waiting for service()
+    };
+
+    // Streaming position for downloads (oldest flash block first, then the sealed and the open RAM blocks).
+    struct Cursor
+    {
+        uint32_t slotsVisited = 0;
+        uint16_t offset = CONTROL_LOG_BLOCK_BYTES;
+        uint8_t pendingSent = 0;
+        uint8_t pendingCount = 0;
+        uint8_t block[CONTROL_LOG_BLOCK_BYTES];
+        uint8_t pending[CONTROL_LOG_SEALED_BLOCKS + 1][CONTROL_LOG_BLOCK_BYTES];
+    };
+
+    bool begin();
+    bool isReady() const { return partition != nullptr; }
+
+    // RAM only; safe to call from the control tick.
+    void record(const ControlLogRecord &record, bool epochTime);
+
+    // One flash operation at most (block write or sector pre-erase); call from loop() away from the control tick.
+    void service(unsigned long nowMs);
+
+    // Seals the open block and writes everything synchronously, e.g. before a planned restart.
+    bool flush();
+
+    void openCursor(Cursor &cursor);
+    size_t read(Cursor &cursor, uint8_t *out, size_t outSize);
+
+    Stats stats();
+
+private:
+    const esp_partition_t *partition = nullptr;
+    ControlLogBlockBuilder builder;
+    bool builderEpoch = false;
+    uint32_t slotCount = 0;
+    uint32_t nextSlot = 0;
+    uint32_t sequence = 1;
+    unsigned long lastWriteMs = 0;
+    bool hasWritten = false;
+    uint32_t erasedSector = UINT32_MAX; // sector erased ahead of the ring, UINT32_MAX = none
+    uint8_t sealed[CONTROL_LOG_SEALED_BLOCKS][CONTROL_LOG_BLOCK_BYTES];
+    size_t sealedHead = 0;
+    size_t sealedCount = 0;
+    Stats counters;
+    std::mutex mutex;
+
+    bool sealLocked();
+    bool writeSealedLocked();
+    bool eraseSectorLocked(uint32_t sector);
+    bool slotIsBlank(uint32_t slot);
+};
@@ -0,0 +1,185 @@
+#include "ControlLogFormat.h"
+
+#include <string.h>
+
+namespace
+{
+size_t varintSize(uint32_t value)
+{
+    size_t n = 1;
+    while (value >= 0x80U)
+    {
+        value >>= 7;
+        ++n;
+    }
+    return n;
+}
+
+size_t putVarint(uint32_t value, uint8_t *out)
+{
+    size_t n = 0;
+    while (value >= 0x80U)
+    {
+        out[n++] = static_cast<uint8_t>(value | 0x80U);
+        value >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(value);
+    return n;
+}
+
+void putLe16(uint8_t *out, uint16_t value)
+{
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void putLe32(uint8_t *out, uint32_t value)
+{
+    putLe16(out, static_cast<uint16_t>(value));
+    putLe16(out + 2, static_cast<uint16_t>(value >> 16));
+}
+
+uint32_t getLe32(const uint8_t *in)
+{
+    return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) |
+           (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+uint16_t getLe16(const uint8_t *in)
+{
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+} // namespace
+
+void ControlLogBlockBuilder::columnValues(const ControlLogRecord &record, int32_t (&out)[CONTROL_LOG_COLUMNS])
+{
+    out[0] = static_cast<int32_t>(record.time);
+    out[1] = record.gridW;
+    out[2] = record.solarW;
+    out[3] = record.calcW;
+    out[4] = record.setW;
+    out[5] = record.flags;
+}
+
+uint32_t ControlLogBlockBuilder::columnCode(size_t column, int32_t value, int32_t previous)
+{
+    const int32_t delta = static_cast<int32_t>(static_cast<uint32_t>(value) - static_cast<uint32_t>(previous));
+    if (column == 0)
+    {
+        return static_cast<uint32_t>(delta); // time is monotonic, no zig-zag needed
+    }
+    return (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+}
+
+bool ControlLogBlockBuilder::add(const ControlLogRecord &record)
+{
+    if (count >= CONTROL_LOG_MAX_RECORDS)
+    {
+        return false;
+    }
+
+    int32_t values[CONTROL_LOG_COLUMNS];
+    int32_t previous[CONTROL_LOG_COLUMNS] = {};
+    columnValues(record, values);
+    if (count > 0)
+    {
+        columnValues(records[count - 1], previous);
+    }
+    else
+    {
+        previous[0] = values[0];
+    }
+
+    size_t added[CONTROL_LOG_COLUMNS];
+    size_t total = 0;
+    for (size_t c = 0; c < CONTROL_LOG_COLUMNS; ++c)
+    {
+        added[c] = varintSize(columnCode(c, values[c], previous[c]));
+        total += columnBytes[c] + added[c];
+    }
+    if (total > CONTROL_LOG_PAYLOAD_BYTES)
+    {
+        return false;
+    }
+
+    for (size_t c = 0; c < CONTROL_LOG_COLUMNS; ++c)
+    {
+        columnBytes[c] += added[c];
+    }
+    records[count++] = record;
+    return true;
+}
+
+void ControlLogBlockBuilder::encode(uint8_t (&block)[CONTROL_LOG_BLOCK_BYTES], uint32_t sequence, bool epochTime) const
+{
+    memset(block, 0xFF, sizeof(block));
+
+    putLe32(block, CONTROL_LOG_MAGIC);
+    putLe32(block + 4, sequence);
+    putLe32(block + 8, firstTime());
+    putLe16(block + 12, static_cast<uint16_t>(count));
+    block[14] = epochTime ? 0x01 : 0x00;
+    block[15] = static_cast<uint8_t>(CONTROL_LOG_COLUMNS);
+
+    size_t pos = CONTROL_LOG_HEADER_BYTES;
+    for (size_t c = 0; c < CONTROL_LOG_COLUMNS; ++c)
+    {
+        putLe16(block + 16 + 2 * c, static_cast<uint16_t>(columnBytes[c]));
+
+        int32_t previous = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            int32_t values[CONTROL_LOG_COLUMNS];
+            columnValues(records[i], values);
+            if (i == 0 && c == 0)
+            {
+                previous = values[0];
+            }
+            pos += putVarint(columnCode(c, values[c], previous), block + pos);
+            previous = values[c];
+        }
+    }
+
+    uint16_t crc = crc16(block, 28);
+    crc = crc16(block + CONTROL_LOG_HEADER_BYTES, pos - CONTROL_LOG_HEADER_BYTES, crc);
+    putLe16(block + 28, crc);
+}
+
+void ControlLogBlockBuilder::reset()
+{
+    count = 0;
+    memset(columnBytes, 0, sizeof(columnBytes));
+}
+
+bool ControlLogBlockBuilder::isValidBlock(const uint8_t *block)
+{
+    if (getLe32(block) != CONTROL_LOG_MAGIC || block[15] != CONTROL_LOG_COLUMNS)
+    {
+        return false;
+    }
+    size_t payload = 0;
+    for (size_t c = 0; c < CONTROL_LOG_COLUMNS; ++c)
+    {
+        payload += getLe16(block + 16 + 2 * c);
+    }
+    if (payload > CONTROL_LOG_PAYLOAD_BYTES)
+    {
+        return false;
+    }
+    uint16_t crc = crc16(block, 28);
+    crc = crc16(block + CONTROL_LOG_HEADER_BYTES, payload, crc);
+    return crc == getLe16(block + 28);
+}
+
+uint16_t ControlLogBlockBuilder::crc16(const uint8_t *data, size_t len, uint16_t crc)
+{
+    for (size_t i = 0; i < len; ++i)
+    {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (uint8_t bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 0x8000U) ? static_cast<uint16_t>((crc << 1) ^ 0x1021U) : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
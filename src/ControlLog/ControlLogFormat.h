@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// On-flash format of the persistent control log.
+// The log partition is a ring of 512-byte blocks. Every block is self-contained:
+//
+//   offset size
+//   0      4    magic "CLG1"
+//   4      4    sequence number (monotonic over the partition lifetime)
+//   8      4    time of the first record (epoch or uptime seconds, see flags)
+//   12     2    record count
+//   14     1    flags (bit0: epoch timestamps)
+//   15     1    column count (CONTROL_LOG_COLUMNS)
+//   16     12   byte length of each column (uint16 each)
+//   28     2    CRC-16/CCITT-FALSE over bytes 0..27 and the column data
+//   30     2    reserved (0xFFFF)
+//   32     480  column data, one column after the other:
+//                 time   : unsigned varint delta to the previous record (first: 0)
+//                 grid/solar/calc/set/flags : zig-zag varint delta to the previous record (first: against 0)
+//
+// All integers are little-endian. tools/ctrllog_decode.py decodes downloaded logs.
+
+static constexpr size_t CONTROL_LOG_BLOCK_BYTES = 512;
+static constexpr size_t CONTROL_LOG_HEADER_BYTES = 32;
+static constexpr size_t CONTROL_LOG_PAYLOAD_BYTES = CONTROL_LOG_BLOCK_BYTES - CONTROL_LOG_HEADER_BYTES;
+static constexpr size_t CONTROL_LOG_COLUMNS = 6;
+static constexpr uint32_t CONTROL_LOG_MAGIC = 0x31474C43UL; // "CLG1"
+
+// Each column costs at least one byte per record.
+static constexpr size_t CONTROL_LOG_MAX_RECORDS = CONTROL_LOG_PAYLOAD_BYTES / CONTROL_LOG_COLUMNS;
+
+enum ControlLogFlags : uint8_t
+{
+    CONTROL_LOG_FLAG_PID = 0x01,
+    CONTROL_LOG_FLAG_ENABLED = 0x02,
+    CONTROL_LOG_FLAG_NEGATIVE_PRICE = 0x04,
+};
+
+struct ControlLogRecord
+{
+    uint32_t time = 0;
+    int16_t gridW = 0;
+    int16_t solarW = 0;
+    int16_t calcW = 0;
+    int16_t setW = 0;
+    uint8_t flags = 0;
+};
+
+// Collects records for one block and encodes them column by column.
+// The encoded size is tracked incrementally, so add() knows exactly when the block is full.
+class ControlLogBlockBuilder
+{
+public:
+    // Returns false when the record does not fit; the builder is unchanged in that case.
+    bool add(const ControlLogRecord &record);
+
+    // Encodes the collected records into a full block (padding with 0xFF).
+    void encode(uint8_t (&block)[CONTROL_LOG_BLOCK_BYTES], uint32_t sequence, bool epochTime) const;
+
+    void reset();
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    uint32_t firstTime() const { return count > 0 ? records[0].time : 0; }
+
+    static bool isValidBlock(const uint8_t *block);
+    static uint16_t crc16(const uint8_t *data, size_t len, uint16_t crc = 0xFFFF);
+
+private:
+    ControlLogRecord records[CONTROL_LOG_MAX_RECORDS];
+    size_t count = 0;
+    size_t columnBytes[CONTROL_LOG_COLUMNS] = {};
+
+    static void columnValues(const ControlLogRecord &record, int32_t (&out)[CONTROL_LOG_COLUMNS]);
+    static uint32_t columnCode(size_t column, int32_t value, int32_t previous);
+};
@@ -0,0 +1,38 @@
+#include "ControlLogHttp.h"
+
+#include <memory>
+#include <stdio.h>
+
+void registerControlLogRoutes(AsyncWebServer &server, ControlLog &log)
+{
+    server.on("/ctrllog.bin", HTTP_GET, [&log](AsyncWebServerRequest *request)
+              {
+        if (!log.isReady())
+        {
+            request->send(404, "text/plain", "control log partition missing");
+            return;
+        }
+        auto cursor = std::make_shared<ControlLog::Cursor>();
+        log.openCursor(*cursor);
+        AsyncWebServerResponse *response = request->beginChunkedResponse("application/octet-stream",
+            [&log, cursor](uint8_t *buffer, size_t maxLen, size_t) -> size_t
+            { return log.read(*cursor, buffer, maxLen); });
+        response->addHeader("Content-Disposition", "attachment; filename=\"ctrllog.bin\"");
+        response->addHeader("Cache-Control", "no-store");
+        request->send(response); });
+
+    server.on("/ctrllog/stats", HTTP_GET, [&log](AsyncWebServerRequest *request)
+              {
+        const ControlLog::Stats s = log.stats();
+        char json[288];
+        snprintf(json, sizeof(json),
+                 "{\"ready\":%s,\"slots\":%lu,\"next\":%lu,\"seq\":%lu,\"written\":%lu,\"dropped\":%lu,\"errors\":%lu,"
+                 "\"lastWriteUs\":%lu,\"lastEraseUs\":%lu,\"pending\":%lu,\"sealed\":%lu}",
+                 log.isReady() ? "true" : "false",
+                 static_cast<unsigned long>(s.slotCount), static_cast<unsigned long>(s.nextSlot),
+                 static_cast<unsigned long>(s.sequence), static_cast<unsigned long>(s.blocksWritten),
+                 static_cast<unsigned long>(s.droppedRecords), static_cast<unsigned long>(s.writeErrors),
+                 static_cast<unsigned long>(s.lastWriteUs), static_cast<unsigned long>(s.lastEraseUs),
+                 static_cast<unsigned long>(s.pendingRecords), static_cast<unsigned long>(s.sealedBlocks));
+        request->send(200, "application/json", json); });
+}
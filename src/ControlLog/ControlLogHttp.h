@@ -0,0 +1,11 @@
+#pragma once
+
+#include <ESPAsyncWebServer.h>
+
+#include "ControlLog.h"
+
+// Registers the control log endpoints:
+//   GET /ctrllog.bin     all valid blocks, oldest first, plus the pending RAM block
+//   GET /ctrllog/stats   JSON write statistics
+// Decode downloads with tools/ctrllog_decode.py.
+void registerControlLogRoutes(AsyncWebServer &server, ControlLog &log);
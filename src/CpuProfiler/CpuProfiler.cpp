@@ -0,0 +1,218 @@
+#include "CpuProfiler.h"
+
+#if defined(CPU_PROFILER_ENABLED)
+
+#include <Arduino.h>
+#include <esp_debug_helpers.h>
+#include <esp_freertos_hooks.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <string.h>
+
+#if __has_include(<esp_memory_utils.h>)
+#include <esp_memory_utils.h>
+#else
+#include <soc/soc_memory_layout.h>
+#endif
+
+namespace
+{
+// Leading words of XtExcFrame (xtensa_context.h). On interrupt entry the port saves the
+// interrupted context there and stores its address in pxCurrentTCB->pxTopOfStack.
+struct InterruptedFrame
+{
+    uint32_t exit;
+    uint32_t pc;
+    uint32_t ps;
+    uint32_t a0;
+    uint32_t a1;
+};
+
+CpuProfileSample samples[CPU_PROFILER_SAMPLES];
+TaskHandle_t taskHandles[CPU_PROFILER_TASKS];
+char taskNames[CPU_PROFILER_TASKS][CPU_PROFILER_TASK_NAME];
+volatile uint32_t taskCount = 0;
+volatile uint32_t sampleCount = 0;
+volatile uint32_t skippedTicks = 0;
+volatile bool armed = false;
+volatile uint32_t sampleDivider = 1;
+uint32_t tickCounter[portNUM_PROCESSORS];
+bool hooksRegistered = false;
+portMUX_TYPE profilerMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Called inside profilerMux.
+uint8_t IRAM_ATTR internTask(TaskHandle_t task)
+{
+    for (uint32_t i = 0; i < taskCount; ++i)
+    {
+        if (taskHandles[i] == task)
+        {
+            return static_cast<uint8_t>(i);
+        }
+    }
+    if (taskCount >= CPU_PROFILER_TASKS)
+    {
+        return 0xFF; // table full; reported as "?"
+    }
+    const uint32_t index = taskCount;
+    taskHandles[index] = task;
+    const char *name = pcTaskGetName(task);
+    size_t i = 0;
+    for (; name != nullptr && i < CPU_PROFILER_TASK_NAME - 1 && name[i] != '\0'; ++i)
+    {
+        taskNames[index][i] = name[i];
+    }
+    taskNames[index][i] = '\0';
+    taskCount = index + 1;
+    return static_cast<uint8_t>(index);
+}
+
+void IRAM_ATTR sampleTick()
+{
+    if (!armed)
+    {
+        return;
+    }
+    const int core = xPortGetCoreID();
+    if (++tickCounter[core] < sampleDivider)
+    {
+        return;
+    }
+    tickCounter[core] = 0;
+
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    const InterruptedFrame *frame = task ? *reinterpret_cast<InterruptedFrame *const *>(task) : nullptr;
+    if (frame == nullptr || !esp_stack_ptr_is_sane(reinterpret_cast<uint32_t>(frame)))
+    {
+        ++skippedTicks;
+        return;
+    }
+
+    portENTER_CRITICAL_ISR(&profilerMux);
+    const uint32_t slot = sampleCount;
+    if (slot >= CPU_PROFILER_SAMPLES)
+    {
+        armed = false;
+        portEXIT_CRITICAL_ISR(&profilerMux);
+        return;
+    }
+    sampleCount = slot + 1;
+    const uint8_t taskIndex = internTask(task);
+    portEXIT_CRITICAL_ISR(&profilerMux);
+
+    CpuProfileSample &sample = samples[slot];
+    sample.core = static_cast<uint8_t>(core);
+    sample.task = taskIndex;
+    sample.pc[0] = frame->pc;
+    uint8_t depth = 1;
+    // The interrupt entry spilled the register windows, so the base save areas are on the stack.
+    esp_backtrace_frame_t walk;
+    memset(&walk, 0, sizeof(walk));
+    walk.pc = frame->pc;
+    walk.sp = frame->a1;
+    walk.next_pc = frame->a0;
+    while (depth < CPU_PROFILER_DEPTH && walk.next_pc != 0 && esp_backtrace_get_next_frame(&walk))
+    {
+        sample.pc[depth++] = walk.pc;
+    }
+    sample.depth = depth;
+}
+} // namespace
+
+bool cpuProfilerBegin()
+{
+    if (hooksRegistered)
+    {
+        return true;
+    }
+    for (int core = 0; core < portNUM_PROCESSORS; ++core)
+    {
+        if (esp_register_freertos_tick_hook_for_cpu(sampleTick, core) != ESP_OK)
+        {
+            return false;
+        }
+    }
+    hooksRegistered = true;
+    return true;
+}
+
+void cpuProfilerStart(uint32_t divider)
+{
+    portENTER_CRITICAL(&profilerMux);
+    armed = false;
+    sampleDivider = divider == 0 ? 1 : divider;
+    sampleCount = 0;
+    skippedTicks = 0;
+    taskCount = 0;
+    for (int core = 0; core < portNUM_PROCESSORS; ++core)
+    {
+        tickCounter[core] = 0;
+    }
+    armed = hooksRegistered;
+    portEXIT_CRITICAL(&profilerMux);
+}
+
+void cpuProfilerStop()
+{
+    portENTER_CRITICAL(&profilerMux);
+    armed = false;
+    portEXIT_CRITICAL(&profilerMux);
+}
+
+CpuProfilerStatus cpuProfilerStatus()
+{
+    CpuProfilerStatus status;
+    status.available = hooksRegistered;
+    status.armed = armed;
+    status.samples = sampleCount;
+    status.capacity = CPU_PROFILER_SAMPLES;
+    status.skipped = skippedTicks;
+    status.divider = sampleDivider;
+    status.tickHz = configTICK_RATE_HZ;
+    status.tasks = taskCount;
+    return status;
+}
+
+const CpuProfileSample *cpuProfilerSamples()
+{
+    return samples;
+}
+
+const char *cpuProfilerTaskName(uint32_t index)
+{
+    return index < taskCount ? taskNames[index] : "?";
+}
+
+#else
+
+bool cpuProfilerBegin()
+{
+    return false;
+}
+
+void cpuProfilerStart(uint32_t)
+{
+}
+
+void cpuProfilerStop()
+{
+}
+
+CpuProfilerStatus cpuProfilerStatus()
+{
+    CpuProfilerStatus status{};
+    status.capacity = CPU_PROFILER_SAMPLES;
+    return status;
+}
+
+const CpuProfileSample *cpuProfilerSamples()
+{
+    return nullptr;
+}
+
+const char *cpuProfilerTaskName(uint32_t)
+{
+    return "?";
+}
+
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Sampling CPU profiler for both cores. Only built with -DCPU_PROFILER_ENABLED (usb_cpuprofile).
+//
+// Samples are taken from the FreeRTOS tick interrupt of each core (CONFIG_FREERTOS_HZ, 1 kHz on
+// Arduino): the interrupted task's PC plus up to CPU_PROFILER_DEPTH - 1 return addresses.
+// A capture fills a fixed buffer and then stops; /profile.bin downloads it and
+// tools/cpu_profile.py symbolizes it against the firmware ELF into folded stacks.
+
+#ifndef CPU_PROFILER_SAMPLES
+#define CPU_PROFILER_SAMPLES 1024
+#endif
+
+#ifndef CPU_PROFILER_DEPTH
+#define CPU_PROFILER_DEPTH 8
+#endif
+
+#ifndef CPU_PROFILER_TASKS
+#define CPU_PROFILER_TASKS 24
+#endif
+
+static constexpr size_t CPU_PROFILER_TASK_NAME = 16; // configMAX_TASK_NAME_LEN on ESP32
+
+struct CpuProfileSample
+{
+    uint8_t core;
+    uint8_t task;  // index into the task name table
+    uint8_t depth; // valid entries in pc[]; pc[0] is the interrupted PC, then raw return addresses (a0)
+    uint8_t reserved;
+    uint32_t pc[CPU_PROFILER_DEPTH];
+};
+static_assert(sizeof(CpuProfileSample) == 4 + 4 * CPU_PROFILER_DEPTH, "profile.bin sample layout");
+
+struct CpuProfilerStatus
+{
+    bool available; // compiled in and tick hooks registered
+    bool armed;
+    uint32_t samples;
+    uint32_t capacity;
+    uint32_t skipped; // ticks whose interrupted frame looked invalid
+    uint32_t divider; // sample every Nth tick per core
+    uint32_t tickHz;
+    uint32_t tasks;
+};
+
+// Registers the tick hooks; returns false when not compiled in or registration failed.
+bool cpuProfilerBegin();
+
+// Clears the buffer and starts sampling every `divider`-th tick per core.
+void cpuProfilerStart(uint32_t divider);
+void cpuProfilerStop();
+CpuProfilerStatus cpuProfilerStatus();
+
+// Valid while the profiler is stopped.
+const CpuProfileSample *cpuProfilerSamples();
+const char *cpuProfilerTaskName(uint32_t index);
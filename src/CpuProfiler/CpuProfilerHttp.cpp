@@ -0,0 +1,121 @@
+#include "CpuProfilerHttp.h"
+
+#if defined(CPU_PROFILER_ENABLED)
+
+#include <memory>
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+constexpr size_t DUMP_HEADER_BYTES = 24;
+
+struct ProfileDump
+{
+    uint8_t header[DUMP_HEADER_BYTES];
+    uint32_t tasks = 0;
+    size_t totalBytes = 0;
+    size_t offset = 0;
+};
+
+void putU32(uint8_t *out, uint32_t value)
+{
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+    out[2] = static_cast<uint8_t>(value >> 16);
+    out[3] = static_cast<uint8_t>(value >> 24);
+}
+
+// Names are NUL padded to CPU_PROFILER_TASK_NAME bytes.
+uint8_t nameByte(const char *name, size_t index)
+{
+    const size_t len = strnlen(name, CPU_PROFILER_TASK_NAME - 1);
+    return index < len ? static_cast<uint8_t>(name[index]) : 0;
+}
+
+void sendStatus(AsyncWebServerRequest *request)
+{
+    const CpuProfilerStatus s = cpuProfilerStatus();
+    char json[192];
+    snprintf(json, sizeof(json),
+             "{\"available\":%s,\"armed\":%s,\"samples\":%lu,\"capacity\":%lu,\"skipped\":%lu,\"divider\":%lu,\"tickHz\":%lu,\"tasks\":%lu}",
+             s.available ? "true" : "false", s.armed ? "true" : "false", static_cast<unsigned long>(s.samples),
+             static_cast<unsigned long>(s.capacity), static_cast<unsigned long>(s.skipped),
+             static_cast<unsigned long>(s.divider), static_cast<unsigned long>(s.tickHz),
+             static_cast<unsigned long>(s.tasks));
+    request->send(200, "application/json", json);
+}
+} // namespace
+
+void registerCpuProfilerRoutes(AsyncWebServer &server)
+{
+    server.on("/profiler/start", HTTP_POST, [](AsyncWebServerRequest *request)
+              {
+        uint32_t divider = 1;
+        if (request->hasParam("divider"))
+        {
+            divider = static_cast<uint32_t>(request->getParam("divider")->value().toInt());
+        }
+        cpuProfilerStart(divider);
+        sendStatus(request); });
+
+    server.on("/profiler/status", HTTP_GET, [](AsyncWebServerRequest *request)
+              { sendStatus(request); });
+
+    server.on("/profile.bin", HTTP_GET, [](AsyncWebServerRequest *request)
+              {
+        // The buffer is only read once sampling has stopped; a new capture needs /profiler/start.
+        cpuProfilerStop();
+        const CpuProfilerStatus s = cpuProfilerStatus();
+        auto dump = std::make_shared<ProfileDump>();
+        memcpy(dump->header, "CPF1", 4);
+        putU32(dump->header + 4, s.tickHz);
+        putU32(dump->header + 8, s.divider);
+        putU32(dump->header + 12, s.samples);
+        putU32(dump->header + 16, s.skipped);
+        dump->header[20] = static_cast<uint8_t>(CPU_PROFILER_DEPTH);
+        dump->header[21] = 0;
+        dump->header[22] = static_cast<uint8_t>(s.tasks);
+        dump->header[23] = static_cast<uint8_t>(s.tasks >> 8);
+        dump->tasks = s.tasks;
+        dump->totalBytes = DUMP_HEADER_BYTES + s.tasks * CPU_PROFILER_TASK_NAME + s.samples * sizeof(CpuProfileSample);
+
+        AsyncWebServerResponse *response = request->beginChunkedResponse("application/octet-stream",
+            [dump](uint8_t *buffer, size_t maxLen, size_t) -> size_t
+            {
+                const size_t namesEnd = DUMP_HEADER_BYTES + dump->tasks * CPU_PROFILER_TASK_NAME;
+                const uint8_t *samples = reinterpret_cast<const uint8_t *>(cpuProfilerSamples());
+                size_t written = 0;
+                while (written < maxLen && dump->offset < dump->totalBytes)
+                {
+                    const size_t at = dump->offset;
+                    if (at < DUMP_HEADER_BYTES)
+                    {
+                        buffer[written] = dump->header[at];
+                    }
+                    else if (at < namesEnd)
+                    {
+                        const size_t rel = at - DUMP_HEADER_BYTES;
+                        buffer[written] = nameByte(cpuProfilerTaskName(rel / CPU_PROFILER_TASK_NAME), rel % CPU_PROFILER_TASK_NAME);
+                    }
+                    else
+                    {
+                        buffer[written] = samples[at - namesEnd];
+                    }
+                    ++written;
+                    ++dump->offset;
+                }
+                return written;
+            });
+        response->addHeader("Content-Disposition", "attachment; filename=\"profile.bin\"");
+        response->addHeader("Cache-Control", "no-store");
+        request->send(response); });
+}
+
+#else
+
+void registerCpuProfilerRoutes(AsyncWebServer &)
+{
+}
+
+#endif
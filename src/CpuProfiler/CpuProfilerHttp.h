@@ -0,0 +1,15 @@
+#pragma once
+
+#include <ESPAsyncWebServer.h>
+
+#include "CpuProfiler.h"
+
+// Registers the profiler routes (usb_cpuprofile only):
+//   POST /profiler/start?divider=N   clear the buffer and start a capture
+//   GET  /profiler/status            capture progress (JSON)
+//   GET  /profile.bin                stop and download the capture, see tools/cpu_profile.py
+//
+// Dump layout (little endian): "CPF1", u32 tickHz, u32 divider, u32 samples, u32 skipped,
+// u16 depth, u16 tasks, tasks x 16 byte names, then samples x (u8 core, u8 task, u8 depth,
+// u8 reserved, depth x u32 pc).
+void registerCpuProfilerRoutes(AsyncWebServer &server);
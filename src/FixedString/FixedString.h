@@ -0,0 +1,155 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// NUL-terminated string with a fixed capacity of N characters in static or stack storage.
+// Never allocates. Writes that do not fit are cut at the capacity and set truncated();
+// the content is always terminated, so c_str() can go straight to printf/MQTT/log calls.
+//
+//   FixedString<64> topic;
+//   topic.format("%s/SetValue", base);
+//   if (topic.truncated()) { ... }
+template <size_t N>
+class FixedString
+{
+    static_assert(N > 0 && N < 0xFFFF, "FixedString capacity out of range");
+
+public:
+    FixedString()
+    {
+        buf[0] = '\0';
+    }
+
+    FixedString(const char *text)
+    {
+        assign(text);
+    }
+
+    static constexpr size_t capacity()
+    {
+        return N;
+    }
+
+    size_t length() const { return len; }
+    bool isEmpty() const { return len == 0; }
+    bool truncated() const { return cut; }
+    const char *c_str() const { return buf; }
+    char operator[](size_t index) const { return index < len ? buf[index] : '\0'; }
+
+    void clear()
+    {
+        len = 0;
+        cut = false;
+        buf[0] = '\0';
+    }
+
+    FixedString &assign(const char *text)
+    {
+        clear();
+        return append(text);
+    }
+
+    FixedString &append(const char *text)
+    {
+        return text ? append(text, strlen(text)) : *this;
+    }
+
+    FixedString &append(const char *text, size_t count)
+    {
+        const size_t room = N - len;
+        if (count > room)
+        {
+            count = room;
+            cut = true;
+        }
+        memcpy(buf + len, text, count);
+        len = static_cast<uint16_t>(len + count);
+        buf[len] = '\0';
+        return *this;
+    }
+
+    FixedString &append(char c)
+    {
+        return append(&c, 1);
+    }
+
+    FixedString &appendf(const char *fmt, ...) __attribute__((format(printf, 2, 3)))
+    {
+        va_list args;
+        va_start(args, fmt);
+        vappendf(fmt, args);
+        va_end(args);
+        return *this;
+    }
+
+    FixedString &format(const char *fmt, ...) __attribute__((format(printf, 2, 3)))
+    {
+        clear();
+        va_list args;
+        va_start(args, fmt);
+        vappendf(fmt, args);
+        va_end(args);
+        return *this;
+    }
+
+    FixedString &vappendf(const char *fmt, va_list args)
+    {
+        const int written = vsnprintf(buf + len, N + 1 - len, fmt, args);
+        if (written < 0)
+        {
+            buf[len] = '\0';
+            return *this;
+        }
+        if (static_cast<size_t>(written) > N - len)
+        {
+            len = static_cast<uint16_t>(N);
+            cut = true;
+        }
+        else
+        {
+            len = static_cast<uint16_t>(len + written);
+        }
+        return *this;
+    }
+
+    // Strips leading and trailing whitespace in place.
+    FixedString &trim()
+    {
+        size_t start = 0;
+        while (start < len && isSpace(buf[start]))
+        {
+            ++start;
+        }
+        size_t end = len;
+        while (end > start && isSpace(buf[end - 1]))
+        {
+            --end;
+        }
+        len = static_cast<uint16_t>(end - start);
+        memmove(buf, buf + start, len);
+        buf[len] = '\0';
+        return *this;
+    }
+
+    bool equals(const char *text) const
+    {
+        return text != nullptr && strcmp(buf, text) == 0;
+    }
+
+    bool operator==(const char *text) const { return equals(text); }
+    bool operator!=(const char *text) const { return !equals(text); }
+
+private:
+    static bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    char buf[N + 1];
+    uint16_t len = 0;
+    bool cut = false;
+};
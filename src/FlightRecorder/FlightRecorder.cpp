@@ -0,0 +1,121 @@
+#include "FlightRecorder.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(ARDUINO)
+#include <esp_attr.h>
+RTC_NOINIT_ATTR FlightRecorderStore flightRecorderRtcStore;
+#else
+FlightRecorderStore flightRecorderRtcStore;
+#endif
+
+namespace
+{
+constexpr uint32_t FLIGHT_RECORDER_MAGIC = 0x31524446UL; // "FDR1"
+
+uint32_t guardOf(uint16_t head, uint16_t count)
+{
+    return ~(static_cast<uint32_t>(head) | (static_cast<uint32_t>(count) << 16));
+}
+} // namespace
+
+bool FlightRecorder::storeValid() const
+{
+    return store.magic == FLIGHT_RECORDER_MAGIC &&
+           store.head < FLIGHT_RECORDER_TICKS &&
+           store.count <= FLIGHT_RECORDER_TICKS &&
+           store.guard == guardOf(store.head, store.count);
+}
+
+void FlightRecorder::begin(uint8_t resetReason, const char *resetReasonText, bool powerOn)
+{
+    reason = resetReason;
+    reasonText = resetReasonText != nullptr ? resetReasonText : "";
+
+    const bool valid = !powerOn && storeValid();
+    previousTicks = 0;
+    if (valid)
+    {
+        const size_t first = (store.head + FLIGHT_RECORDER_TICKS - store.count) % FLIGHT_RECORDER_TICKS;
+        for (size_t i = 0; i < store.count; ++i)
+        {
+            previous[i] = store.ticks[(first + i) % FLIGHT_RECORDER_TICKS];
+        }
+        previousTicks = store.count;
+    }
+
+    store.bootCount = valid ? store.bootCount + 1 : 1;
+    store.head = 0;
+    store.count = 0;
+    store.guard = guardOf(0, 0);
+    store.magic = FLIGHT_RECORDER_MAGIC;
+}
+
+void FlightRecorder::record(const FlightTick &tick)
+{
+    const uint16_t head = store.head;
+    store.ticks[head] = tick;
+    const uint16_t nextHead = static_cast<uint16_t>((head + 1) % FLIGHT_RECORDER_TICKS);
+    const uint16_t nextCount = store.count < FLIGHT_RECORDER_TICKS ? static_cast<uint16_t>(store.count + 1) : store.count;
+    store.head = nextHead;
+    store.count = nextCount;
+    store.guard = guardOf(nextHead, nextCount);
+}
+
+bool FlightRecorder::nextJsonLine(JsonCursor &cursor) const
+{
+    const size_t first = (cursor.lastTicks != 0 && cursor.lastTicks < previousTicks) ? previousTicks - cursor.lastTicks : 0;
+    int written;
+    if (cursor.row < 0)
+    {
+        written = snprintf(cursor.line, sizeof(cursor.line),
+                           "{\"boot\":%lu,\"reason\":\"%s\",\"resetCode\":%u,\"columns\":[\"ms\",\"grid\",\"solar\",\"calc\",\"set\",\"loopUs\",\"heap\",\"flags\"],\"rows\":[",
+                           static_cast<unsigned long>(store.bootCount), reasonText, static_cast<unsigned int>(reason));
+        cursor.row = static_cast<int>(first);
+    }
+    else if (static_cast<size_t>(cursor.row) < previousTicks)
+    {
+        const FlightTick &t = previous[cursor.row];
+        written = snprintf(cursor.line, sizeof(cursor.line), "%s[%lu,%d,%d,%d,%d,%u,%lu,%u]",
+                           static_cast<size_t>(cursor.row) == first ? "" : ",",
+                           static_cast<unsigned long>(t.uptimeMs), t.gridW, t.solarW, t.calcW, t.setW,
+                           static_cast<unsigned int>(t.loopMaxUs), static_cast<unsigned long>(t.freeHeap),
+                           static_cast<unsigned int>(t.flags));
+        ++cursor.row;
+    }
+    else if (!cursor.done)
+    {
+        written = snprintf(cursor.line, sizeof(cursor.line), "]}");
+        cursor.done = true;
+    }
+    else
+    {
+        return false;
+    }
+
+    cursor.lineLength = written > 0 ? static_cast<size_t>(written) : 0;
+    if (cursor.lineLength >= sizeof(cursor.line))
+    {
+        cursor.lineLength = sizeof(cursor.line) - 1;
+    }
+    cursor.lineOffset = 0;
+    return true;
+}
+
+size_t FlightRecorder::readJson(JsonCursor &cursor, uint8_t *out, size_t maxLen) const
+{
+    size_t written = 0;
+    while (written < maxLen)
+    {
+        if (cursor.lineOffset == cursor.lineLength && !nextJsonLine(cursor))
+        {
+            break;
+        }
+        const size_t chunk = cursor.lineLength - cursor.lineOffset < maxLen - written ? cursor.lineLength - cursor.lineOffset : maxLen - written;
+        memcpy(out + written, cursor.line + cursor.lineOffset, chunk);
+        cursor.lineOffset += chunk;
+        written += chunk;
+    }
+    return written;
+}
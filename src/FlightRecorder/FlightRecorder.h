@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+// Number of control ticks kept across a reset (20 bytes each, RTC slow memory).
+#ifndef FLIGHT_RECORDER_TICKS
+#define FLIGHT_RECORDER_TICKS 64
+#endif
+
+// Plain struct without member initializers: a constructor would wipe the RTC copy at every boot.
+struct FlightTick
+{
+    uint32_t uptimeMs;
+    int16_t gridW;
+    int16_t solarW;
+    int16_t calcW;
+    int16_t setW;
+    uint16_t loopMaxUs; // longest loop() pass since the previous tick, saturated
+    uint8_t flags;      // CONTROL_LOG_FLAG_* bits
+    uint8_t reserved;
+    uint32_t freeHeap;
+};
+
+// Raw ring as it lives in RTC memory. Left uninitialized by the startup code,
+// so after a soft reset, panic, watchdog or brownout it still holds the last ticks.
+struct FlightRecorderStore
+{
+    uint32_t magic;
+    uint32_t bootCount;
+    uint16_t head;  // next slot to write
+    uint16_t count; // valid slots
+    uint32_t guard; // ~(head | count << 16), catches a reset in the middle of record()
+    FlightTick ticks[FLIGHT_RECORDER_TICKS];
+};
+static_assert(std::is_trivially_default_constructible<FlightRecorderStore>::value, "RTC_NOINIT storage must not be initialized");
+
+// The RTC_NOINIT instance (a plain global on host builds).
+extern FlightRecorderStore flightRecorderRtcStore;
+
+// Flight recorder of the last control ticks.
+// begin() moves the ticks of the previous run into RAM (unless the chip was powered on,
+// which leaves RTC memory random) and restarts the RTC ring; record() is a handful of
+// stores per tick. The previous run is read back via previousTick() or as JSON.
+class FlightRecorder
+{
+public:
+    explicit FlightRecorder(FlightRecorderStore &store) : store(store) {}
+
+    void begin(uint8_t resetReason, const char *resetReasonText, bool powerOn);
+    void record(const FlightTick &tick);
+
+    uint32_t bootCount() const { return store.bootCount; }
+    uint8_t resetReason() const { return reason; }
+    const char *resetReasonText() const { return reasonText; }
+
+    // Ticks of the run before the last reset, oldest first.
+    size_t previousCount() const { return previousTicks; }
+    const FlightTick &previousTick(size_t index) const { return previous[index]; }
+
+    // Streams the previous run as JSON:
+    //   {"boot":n (this boot),"reason":"PANIC","resetCode":4,"columns":[...],"rows":[[ms,grid,solar,calc,set,loopUs,heap,flags],...]}
+    // lastTicks limits the rows to the newest ticks (0 = all).
+    struct JsonCursor
+    {
+        size_t lastTicks = 0;
+        int row = -1;
+        char line[160];
+        size_t lineLength = 0;
+        size_t lineOffset = 0;
+        bool done = false;
+    };
+    size_t readJson(JsonCursor &cursor, uint8_t *out, size_t maxLen) const;
+
+private:
+    FlightRecorderStore &store;
+    FlightTick previous[FLIGHT_RECORDER_TICKS];
+    size_t previousTicks = 0;
+    uint8_t reason = 0;
+    const char *reasonText = "";
+
+    bool storeValid() const;
+    bool nextJsonLine(JsonCursor &cursor) const;
+};
@@ -0,0 +1,15 @@
+#include "FlightRecorderHttp.h"
+
+#include <memory>
+
+void registerFlightRecorderRoutes(AsyncWebServer &server, FlightRecorder &recorder)
+{
+    server.on("/flightrec.json", HTTP_GET, [&recorder](AsyncWebServerRequest *request)
+              {
+        auto cursor = std::make_shared<FlightRecorder::JsonCursor>();
+        AsyncWebServerResponse *response = request->beginChunkedResponse("application/json",
+            [&recorder, cursor](uint8_t *buffer, size_t maxLen, size_t) -> size_t
+            { return recorder.readJson(*cursor, buffer, maxLen); });
+        response->addHeader("Cache-Control", "no-store");
+        request->send(response); });
+}
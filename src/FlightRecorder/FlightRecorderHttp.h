@@ -0,0 +1,9 @@
+#pragma once
+
+#include <ESPAsyncWebServer.h>
+
+#include "FlightRecorder.h"
+
+// Registers GET /flightrec.json: the control ticks recorded before the last reset,
+// with the reset reason and boot counter (layout in FlightRecorder.h).
+void registerFlightRecorderRoutes(AsyncWebServer &server, FlightRecorder &recorder);
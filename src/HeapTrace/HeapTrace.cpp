@@ -0,0 +1,280 @@
+#include "HeapTrace.h"
+
+#include <atomic>
+#include <stdlib.h>
+
+#if defined(ARDUINO)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#else
+#include <new>
+#include <thread>
+#endif
+
+namespace
+{
+std::atomic<uint32_t> totalAllocs{0};
+std::atomic<uint32_t> totalFrees{0};
+std::atomic<uint32_t> totalBytes{0};
+std::atomic<uint32_t> taskAllocs{0};
+std::atomic<uint32_t> taskFrees{0};
+std::atomic<uint32_t> taskBytes{0};
+std::atomic<bool> steadyState{false};
+
+HeapScopeStats scopeStats[static_cast<size_t>(HeapTag::Count)];
+
+#if defined(ARDUINO)
+TaskHandle_t tracedTask = nullptr;
+
+bool onTracedTask()
+{
+    return tracedTask != nullptr && xTaskGetCurrentTaskHandle() == tracedTask;
+}
+#else
+std::atomic<bool> tracedTaskSet{false};
+std::thread::id tracedTask;
+
+bool onTracedTask()
+{
+    return tracedTaskSet.load(std::memory_order_acquire) && std::this_thread::get_id() == tracedTask;
+}
+#endif
+
+bool zeroAllocScope(HeapTag tag)
+{
+    return tag == HeapTag::ControlTick || tag == HeapTag::Publish;
+}
+} // namespace
+
+#if defined(HEAP_TRACE_ENABLED)
+namespace
+{
+void noteAlloc(size_t size)
+{
+    totalAllocs.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(static_cast<uint32_t>(size), std::memory_order_relaxed);
+    if (onTracedTask())
+    {
+        taskAllocs.fetch_add(1, std::memory_order_relaxed);
+        taskBytes.fetch_add(static_cast<uint32_t>(size), std::memory_order_relaxed);
+    }
+}
+
+void noteFree()
+{
+    totalFrees.fetch_add(1, std::memory_order_relaxed);
+    if (onTracedTask())
+    {
+        taskFrees.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+} // namespace
+
+#if defined(ARDUINO)
+// Linked with -Wl,--wrap=malloc -Wl,--wrap=calloc -Wl,--wrap=realloc -Wl,--wrap=free.
+extern "C"
+{
+    void *__real_malloc(size_t size);
+    void *__real_calloc(size_t count, size_t size);
+    void *__real_realloc(void *ptr, size_t size);
+    void __real_free(void *ptr);
+
+    void *__wrap_malloc(size_t size)
+    {
+        void *ptr = __real_malloc(size);
+        if (ptr != nullptr)
+        {
+            noteAlloc(size);
+        }
+        return ptr;
+    }
+
+    void *__wrap_calloc(size_t count, size_t size)
+    {
+        void *ptr = __real_calloc(count, size);
+        if (ptr != nullptr)
+        {
+            noteAlloc(count * size);
+        }
+        return ptr;
+    }
+
+    // A growing String is a realloc; count it like an allocation.
+    void *__wrap_realloc(void *ptr, size_t size)
+    {
+        void *next = __real_realloc(ptr, size);
+        if (next != nullptr && size > 0)
+        {
+            noteAlloc(size);
+        }
+        return next;
+    }
+
+    void __wrap_free(void *ptr)
+    {
+        if (ptr != nullptr)
+        {
+            noteFree();
+        }
+        __real_free(ptr);
+    }
+}
+#else
+void *operator new(size_t size)
+{
+    void *ptr = malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    noteAlloc(size);
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    void *ptr = malloc(size == 0 ? 1 : size);
+    if (ptr != nullptr)
+    {
+        noteAlloc(size);
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    if (ptr != nullptr)
+    {
+        noteFree();
+    }
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+#endif
+#endif
+
+bool heapTraceCompiledIn()
+{
+#if defined(HEAP_TRACE_ENABLED)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void heapTraceBegin()
+{
+#if defined(ARDUINO)
+    tracedTask = xTaskGetCurrentTaskHandle();
+#else
+    tracedTask = std::this_thread::get_id();
+    tracedTaskSet.store(true, std::memory_order_release);
+#endif
+}
+
+HeapCounters heapTraceTotals()
+{
+    HeapCounters counters;
+    counters.allocs = totalAllocs.load(std::memory_order_relaxed);
+    counters.frees = totalFrees.load(std::memory_order_relaxed);
+    counters.bytes = totalBytes.load(std::memory_order_relaxed);
+    return counters;
+}
+
+HeapCounters heapTraceTracedTask()
+{
+    HeapCounters counters;
+    counters.allocs = taskAllocs.load(std::memory_order_relaxed);
+    counters.frees = taskFrees.load(std::memory_order_relaxed);
+    counters.bytes = taskBytes.load(std::memory_order_relaxed);
+    return counters;
+}
+
+void heapTraceArmSteadyState()
+{
+    steadyState.store(true, std::memory_order_relaxed);
+}
+
+bool heapTraceSteadyState()
+{
+    return steadyState.load(std::memory_order_relaxed);
+}
+
+const char *heapTagName(HeapTag tag)
+{
+    switch (tag)
+    {
+    case HeapTag::Loop:
+        return "loop";
+    case HeapTag::ControlTick:
+        return "controlTick";
+    case HeapTag::Publish:
+        return "publish";
+    case HeapTag::Bench:
+        return "bench";
+    default:
+        return "?";
+    }
+}
+
+HeapScopeStats heapScopeStats(HeapTag tag)
+{
+    return scopeStats[static_cast<size_t>(tag)];
+}
+
+HeapTraceScope::HeapTraceScope(HeapTag scopeTag)
+    : tag(scopeTag), start(heapTraceTracedTask())
+{
+}
+
+uint32_t HeapTraceScope::allocs() const
+{
+    return heapTraceTracedTask().allocs - start.allocs;
+}
+
+HeapTraceScope::~HeapTraceScope()
+{
+    const HeapCounters now = heapTraceTracedTask();
+    const uint32_t allocs = now.allocs - start.allocs;
+    HeapScopeStats &stats = scopeStats[static_cast<size_t>(tag)];
+    ++stats.passes;
+    stats.allocs += allocs;
+    stats.bytes += now.bytes - start.bytes;
+    stats.lastAllocs = static_cast<uint16_t>(allocs > 0xFFFF ? 0xFFFF : allocs);
+    if (stats.lastAllocs > stats.maxAllocs)
+    {
+        stats.maxAllocs = stats.lastAllocs;
+    }
+    if (allocs > 0)
+    {
+        ++stats.allocatingPasses;
+        if (zeroAllocScope(tag) && heapTraceSteadyState())
+        {
+            ++stats.violations;
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Heap allocation counters per loop() pass and per tagged scope.
+//
+// Allocations are only counted in builds with -DHEAP_TRACE_ENABLED:
+//   ESP32 (usb_heaptrace): malloc/calloc/realloc/free are wrapped at link time
+//                          (-Wl,--wrap=...), which covers new, String and the libraries.
+//   Host:                  the global operator new/delete are replaced.
+// heap_caps_* calls that bypass malloc are not seen. Without the flag every counter stays 0.
+//
+// Scopes are meant for the loop task (the task that called heapTraceBegin()):
+//
+//   HeapTraceScope scope(HeapTag::ControlTick);
+//
+// After heapTraceArmSteadyState(), an allocation inside a zero-allocation scope
+// (ControlTick, Publish) counts as a violation.
+
+#ifndef HEAP_TRACE_SETTLE_MS
+#define HEAP_TRACE_SETTLE_MS 120000UL // after startup: WiFi, MQTT and the first publishes have allocated
+#endif
+
+#ifndef HEAP_TRACE_WARN_INTERVAL_MS
+#define HEAP_TRACE_WARN_INTERVAL_MS 60000UL
+#endif
+
+enum class HeapTag : uint8_t
+{
+    Loop,
+    ControlTick, // processRS485Tick(); zero allocations expected
+    Publish,     // publishMqttNow(); zero allocations expected
+    Bench,       // KernelBench per-kernel measurement
+    Count
+};
+
+struct HeapCounters
+{
+    uint32_t allocs = 0;
+    uint32_t frees = 0;
+    uint32_t bytes = 0; // requested bytes, wraps; use differences
+};
+
+struct HeapScopeStats
+{
+    uint32_t passes = 0;
+    uint32_t allocs = 0;
+    uint32_t bytes = 0;
+    uint32_t allocatingPasses = 0;
+    uint32_t violations = 0; // allocating passes after the steady state was armed
+    uint16_t lastAllocs = 0;
+    uint16_t maxAllocs = 0;
+};
+
+bool heapTraceCompiledIn();
+
+// Marks the calling task as the traced task (call from setup()).
+void heapTraceBegin();
+
+HeapCounters heapTraceTotals();     // all tasks
+HeapCounters heapTraceTracedTask(); // the task that called heapTraceBegin()
+
+void heapTraceArmSteadyState();
+bool heapTraceSteadyState();
+
+const char *heapTagName(HeapTag tag);
+HeapScopeStats heapScopeStats(HeapTag tag);
+
+class HeapTraceScope
+{
+public:
+    explicit HeapTraceScope(HeapTag tag);
+    ~HeapTraceScope();
+    HeapTraceScope(const HeapTraceScope &) = delete;
+    HeapTraceScope &operator=(const HeapTraceScope &) = delete;
+
+    uint32_t allocs() const; // allocations so far inside this scope
+
+private:
+    HeapTag tag;
+    HeapCounters start;
+};
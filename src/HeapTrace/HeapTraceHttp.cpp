@@ -0,0 +1,42 @@
+#include "HeapTraceHttp.h"
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <stdio.h>
+
+void registerHeapTraceRoutes(AsyncWebServer &server)
+{
+    server.on("/heapstats.json", HTTP_GET, [](AsyncWebServerRequest *request)
+              {
+        const HeapCounters totals = heapTraceTotals();
+        const HeapCounters loopTask = heapTraceTracedTask();
+        char json[1024];
+        int len = snprintf(json, sizeof(json),
+                           "{\"traced\":%s,\"steady\":%s,\"free\":%lu,\"minFree\":%lu,\"largest\":%lu,\"size\":%lu,"
+                           "\"allocs\":%lu,\"frees\":%lu,\"bytes\":%lu,\"loopAllocs\":%lu,\"loopBytes\":%lu,\"scopes\":[",
+                           heapTraceCompiledIn() ? "true" : "false", heapTraceSteadyState() ? "true" : "false",
+                           static_cast<unsigned long>(ESP.getFreeHeap()), static_cast<unsigned long>(ESP.getMinFreeHeap()),
+                           static_cast<unsigned long>(heap_caps_get_largest_free_block(MALLOC_CAP_8BIT)),
+                           static_cast<unsigned long>(ESP.getHeapSize()), static_cast<unsigned long>(totals.allocs),
+                           static_cast<unsigned long>(totals.frees), static_cast<unsigned long>(totals.bytes),
+                           static_cast<unsigned long>(loopTask.allocs), static_cast<unsigned long>(loopTask.bytes));
+        for (uint8_t i = 0; i < static_cast<uint8_t>(HeapTag::Count) && len > 0 && len < static_cast<int>(sizeof(json)); ++i)
+        {
+            const HeapTag tag = static_cast<HeapTag>(i);
+            const HeapScopeStats s = heapScopeStats(tag);
+            len += snprintf(json + len, sizeof(json) - len,
+                            "%s{\"tag\":\"%s\",\"passes\":%lu,\"allocs\":%lu,\"bytes\":%lu,\"allocPasses\":%lu,"
+                            "\"violations\":%lu,\"last\":%u,\"max\":%u}",
+                            i == 0 ? "" : ",", heapTagName(tag), static_cast<unsigned long>(s.passes),
+                            static_cast<unsigned long>(s.allocs), static_cast<unsigned long>(s.bytes),
+                            static_cast<unsigned long>(s.allocatingPasses), static_cast<unsigned long>(s.violations),
+                            static_cast<unsigned int>(s.lastAllocs), static_cast<unsigned int>(s.maxAllocs));
+        }
+        if (len > 0 && len < static_cast<int>(sizeof(json)) - 2)
+        {
+            json[len++] = ']';
+            json[len++] = '}';
+            json[len] = '\0';
+        }
+        request->send(200, "application/json", json); });
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <ESPAsyncWebServer.h>
+
+#include "HeapTrace.h"
+
+// Registers GET /heapstats.json: free heap, low-water mark, largest free block and the
+// per-scope allocation counters (JSON, polled by the /heap page).
+void registerHeapTraceRoutes(AsyncWebServer &server);
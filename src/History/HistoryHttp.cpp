@@ -0,0 +1,74 @@
+#include "HistoryHttp.h"
+
+#include <memory>
+#include <stdio.h>
+#include <time.h>
+
+namespace
+{
+HistoryStore::Tier tierFromRequest(AsyncWebServerRequest *request)
+{
+    if (request->hasParam("res") && request->getParam("res")->value() == "1m")
+    {
+        return HistoryStore::Tier::Coarse;
+    }
+    return HistoryStore::Tier::Fine;
+}
+
+int appendCoverage(char *out, size_t size, const char *name, const HistoryStore::Coverage &c)
+{
+    return snprintf(out, size,
+                    "\"%s\":{\"resolutionSec\":%u,\"targetSec\":%lu,\"coveredSec\":%lu,\"samples\":%lu,"
+                    "\"bytesUsed\":%lu,\"bytesCapacity\":%lu,\"bytesPerSample\":%.2f,\"earlyEvictions\":%lu}",
+                    name, static_cast<unsigned>(c.resolutionSec), static_cast<unsigned long>(c.targetSec),
+                    static_cast<unsigned long>(c.coveredSec), static_cast<unsigned long>(c.samples),
+                    static_cast<unsigned long>(c.bytesUsed), static_cast<unsigned long>(c.bytesCapacity),
+                    c.samples > 0 ? static_cast<double>(c.bytesUsed) / c.samples : 0.0,
+                    static_cast<unsigned long>(c.earlyEvictions));
+}
+
+int64_t currentEpochOffset()
+{
+    const time_t now = time(nullptr);
+    if (now < 1600000000)
+    {
+        return 0;
+    }
+    return static_cast<int64_t>(now) - static_cast<int64_t>(millis() / 1000UL);
+}
+} // namespace
+
+void registerHistoryRoutes(AsyncWebServer &server, HistoryStore &store)
+{
+    server.on("/history.csv", HTTP_GET, [&store](AsyncWebServerRequest *request)
+              {
+        auto cursor = std::make_shared<HistoryStore::Cursor>();
+        cursor->tier = tierFromRequest(request);
+        const int64_t epochOffset = currentEpochOffset();
+        AsyncWebServerResponse *response = request->beginChunkedResponse("text/csv",
+            [&store, cursor, epochOffset](uint8_t *buffer, size_t maxLen, size_t) -> size_t
+            { return store.readCsv(*cursor, reinterpret_cast<char *>(buffer), maxLen, epochOffset); });
+        response->addHeader("Cache-Control", "no-store");
+        request->send(response); });
+
+    server.on("/history.bin", HTTP_GET, [&store](AsyncWebServerRequest *request)
+              {
+        auto cursor = std::make_shared<HistoryStore::Cursor>();
+        cursor->tier = tierFromRequest(request);
+        const int64_t epochOffset = currentEpochOffset();
+        AsyncWebServerResponse *response = request->beginChunkedResponse("application/octet-stream",
+            [&store, cursor, epochOffset](uint8_t *buffer, size_t maxLen, size_t) -> size_t
+            { return store.readBinary(*cursor, buffer, maxLen, epochOffset); });
+        response->addHeader("Cache-Control", "no-store");
+        request->send(response); });
+
+    server.on("/history.json", HTTP_GET, [&store](AsyncWebServerRequest *request)
+              {
+        char body[512];
+        int len = snprintf(body, sizeof(body), "{");
+        len += appendCoverage(body + len, sizeof(body) - len, "fine", store.coverage(HistoryStore::Tier::Fine));
+        len += snprintf(body + len, sizeof(body) - len, ",");
+        len += appendCoverage(body + len, sizeof(body) - len, "coarse", store.coverage(HistoryStore::Tier::Coarse));
+        snprintf(body + len, sizeof(body) - len, "}");
+        request->send(200, "application/json", body); });
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <ESPAsyncWebServer.h>
+
+#include "HistoryStore.h"
+
+// Registers the history endpoints:
+//   GET /history.csv?res=10s|1m      decoded samples as CSV
+//   GET /history.bin?res=10s|1m      raw encoded chunks (see HistoryStore::readBinary)
+//   GET /history.json                covered span, bytes per sample and early evictions per tier
+// Timestamps are epoch seconds once NTP has synced, uptime seconds before.
+// The chart page (/history) is a web asset, see web/history.html.
+void registerHistoryRoutes(AsyncWebServer &server, HistoryStore &store);
@@ -0,0 +1,408 @@
+#include "HistoryStore.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+constexpr uint16_t FINE_RESOLUTION_SEC = 10;
+constexpr uint32_t FINE_SPAN_SEC = 3600UL;
+constexpr uint16_t COARSE_RESOLUTION_SEC = 60;
+constexpr uint32_t COARSE_SPAN_SEC = 86400UL;
+
+constexpr size_t MAX_VARINT_BYTES = 5;
+constexpr size_t MAX_CSV_LINE = 64;
+constexpr size_t FILE_HEADER_BYTES = 8;
+constexpr size_t CHUNK_HEADER_BYTES = 12 + 4 * HistoryStore::CHANNELS;
+
+uint32_t zigzag(int32_t value)
+{
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+int32_t unzigzag(uint32_t value)
+{
+    return static_cast<int32_t>((value >> 1) ^ (~(value & 1U) + 1U));
+}
+
+size_t putVarint(uint32_t value, uint8_t *out)
+{
+    size_t n = 0;
+    while (value >= 0x80U)
+    {
+        out[n++] = static_cast<uint8_t>(value | 0x80U);
+        value >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(value);
+    return n;
+}
+
+uint32_t getVarint(const uint8_t *data, size_t size, uint16_t &pos)
+{
+    uint32_t value = 0;
+    for (uint8_t shift = 0; pos < size && shift < 35; shift += 7)
+    {
+        const uint8_t b = data[pos++];
+        value |= static_cast<uint32_t>(b & 0x7FU) << shift;
+        if ((b & 0x80U) == 0)
+        {
+            break;
+        }
+    }
+    return value;
+}
+
+void putLe16(uint8_t *out, uint16_t value)
+{
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void putLe32(uint8_t *out, uint32_t value)
+{
+    putLe16(out, static_cast<uint16_t>(value));
+    putLe16(out + 2, static_cast<uint16_t>(value >> 16));
+}
+} // namespace
+
+HistoryStore::HistoryStore()
+{
+    rings[0].chunks = fineChunks;
+    rings[0].capacity = HISTORY_FINE_CHUNKS;
+    rings[0].resolutionSec = FINE_RESOLUTION_SEC;
+    rings[0].spanSec = FINE_SPAN_SEC;
+
+    rings[1].chunks = coarseChunks;
+    rings[1].capacity = HISTORY_COARSE_CHUNKS;
+    rings[1].resolutionSec = COARSE_RESOLUTION_SEC;
+    rings[1].spanSec = COARSE_SPAN_SEC;
+}
+
+void HistoryStore::addSample(uint32_t uptimeSec, const int32_t (&values)[CHANNELS])
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    accumulate(rings[0], uptimeSec, values, true);
+}
+
+void HistoryStore::accumulate(Ring &ring, uint32_t timeSec, const int32_t *values, bool forward)
+{
+    const uint32_t bucket = timeSec / ring.resolutionSec;
+    if (ring.samples > 0 && bucket != ring.bucket)
+    {
+        int32_t average[CHANNELS];
+        for (size_t c = 0; c < CHANNELS; ++c)
+        {
+            average[c] = static_cast<int32_t>(ring.sum[c] / static_cast<int64_t>(ring.samples));
+            ring.sum[c] = 0;
+        }
+        ring.samples = 0;
+
+        const uint32_t bucketStart = ring.bucket * ring.resolutionSec;
+        append(ring, bucketStart, average);
+        if (forward)
+        {
+            accumulate(rings[1], bucketStart, average, false);
+        }
+    }
+
+    for (size_t c = 0; c < CHANNELS; ++c)
+    {
+        ring.sum[c] += values[c];
+    }
+    ++ring.samples;
+    ring.bucket = bucket;
+}
+
+void HistoryStore::append(Ring &ring, uint32_t timeSec, const int32_t *values)
+{
+    Chunk *chunk = ring.live > 0 ? &ring.chunks[(ring.oldest + ring.live - 1) % ring.capacity] : nullptr;
+    if (chunk == nullptr || timeSec != chunk->startSec + static_cast<uint32_t>(chunk->count) * ring.resolutionSec)
+    {
+        chunk = &openChunk(ring, timeSec);
+    }
+
+    uint8_t encoded[CHANNELS * MAX_VARINT_BYTES];
+    size_t len = chunk->count == 0 ? 0 : encodeDelta(*chunk, values, encoded);
+    if (chunk->used + len > HISTORY_CHUNK_BYTES)
+    {
+        chunk = &openChunk(ring, timeSec);
+        len = 0;
+    }
+
+    if (chunk->count == 0)
+    {
+        memcpy(chunk->first, values, sizeof(chunk->first)); // absolute, in the header
+    }
+    memcpy(chunk->data + chunk->used, encoded, len);
+    chunk->used = static_cast<uint16_t>(chunk->used + len);
+    memcpy(chunk->last, values, sizeof(chunk->last));
+    ++chunk->count;
+
+    expire(ring, timeSec);
+}
+
+HistoryStore::Chunk &HistoryStore::openChunk(Ring &ring, uint32_t timeSec)
+{
+    if (ring.live == ring.capacity)
+    {
+        // expire() already dropped everything older than the span, so this chunk is still inside it.
+        ++ring.earlyEvictions;
+        ring.oldest = (ring.oldest + 1) % ring.capacity;
+        --ring.live;
+    }
+
+    Chunk &chunk = ring.chunks[(ring.oldest + ring.live) % ring.capacity];
+    ++ring.live;
+    chunk.serial = nextSerial++;
+    chunk.startSec = timeSec;
+    chunk.count = 0;
+    chunk.used = 0;
+    memset(chunk.first, 0, sizeof(chunk.first));
+    memset(chunk.last, 0, sizeof(chunk.last));
+    return chunk;
+}
+
+void HistoryStore::expire(Ring &ring, uint32_t nowSec)
+{
+    while (ring.live > 1)
+    {
+        const Chunk &oldest = ring.chunks[ring.oldest];
+        const uint32_t endSec = oldest.startSec + static_cast<uint32_t>(oldest.count) * ring.resolutionSec;
+        if (static_cast<int32_t>(nowSec - endSec) < static_cast<int32_t>(ring.spanSec))
+        {
+            return;
+        }
+        ring.oldest = (ring.oldest + 1) % ring.capacity;
+        --ring.live;
+    }
+}
+
+const HistoryStore::Chunk *HistoryStore::findChunk(const Ring &ring, uint32_t minSerial, bool &isNewest) const
+{
+    for (size_t i = 0; i < ring.live; ++i)
+    {
+        const Chunk &chunk = ring.chunks[(ring.oldest + i) % ring.capacity];
+        if (chunk.serial >= minSerial)
+        {
+            isNewest = (i + 1 == ring.live);
+            return &chunk;
+        }
+    }
+    isNewest = false;
+    return nullptr;
+}
+
+size_t HistoryStore::encodeDelta(const Chunk &chunk, const int32_t *values, uint8_t *out)
+{
+    size_t len = 0;
+    for (size_t c = 0; c < CHANNELS; ++c)
+    {
+        const int32_t delta = static_cast<int32_t>(static_cast<uint32_t>(values[c]) - static_cast<uint32_t>(chunk.last[c]));
+        len += putVarint(zigzag(delta), out + len);
+    }
+    return len;
+}
+
+size_t HistoryStore::readCsv(Cursor &cursor, char *out, size_t outSize, int64_t epochOffset) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const Ring &ring = rings[static_cast<uint8_t>(cursor.tier)];
+    size_t pos = 0;
+
+    if (!cursor.headerDone)
+    {
+        const int written = snprintf(out, outSize, "t,grid_w,set_w,solar_w,temp_c\n");
+        if (written < 0 || static_cast<size_t>(written) >= outSize)
+        {
+            return 0;
+        }
+        pos = static_cast<size_t>(written);
+        cursor.headerDone = true;
+    }
+
+    while (outSize - pos > MAX_CSV_LINE)
+    {
+        bool newest = false;
+        const Chunk *chunk = findChunk(ring, cursor.chunkSerial, newest);
+        if (chunk == nullptr)
+        {
+            break;
+        }
+        if (!cursor.inChunk || chunk->serial != cursor.chunkSerial)
+        {
+            // Start of a chunk, or the one being read was evicted meanwhile.
+            cursor.chunkSerial = chunk->serial;
+            cursor.sample = 0;
+            cursor.bytePos = 0;
+            memset(cursor.running, 0, sizeof(cursor.running));
+            cursor.inChunk = true;
+        }
+        if (cursor.sample >= chunk->count)
+        {
+            if (newest)
+            {
+                break;
+            }
+            cursor.chunkSerial = chunk->serial + 1;
+            cursor.inChunk = false;
+            continue;
+        }
+
+        if (cursor.sample == 0)
+        {
+            memcpy(cursor.running, chunk->first, sizeof(cursor.running));
+        }
+        else
+        {
+            for (size_t c = 0; c < CHANNELS; ++c)
+            {
+                cursor.running[c] += unzigzag(getVarint(chunk->data, chunk->used, cursor.bytePos));
+            }
+        }
+
+        const int64_t t = static_cast<int64_t>(chunk->startSec) +
+                          static_cast<int64_t>(cursor.sample) * ring.resolutionSec + epochOffset;
+        const int32_t temp = cursor.running[TemperatureDeciC];
+        const uint32_t tempAbs = temp < 0 ? static_cast<uint32_t>(-temp) : static_cast<uint32_t>(temp);
+        const int written = snprintf(out + pos, outSize - pos, "%lld,%ld,%ld,%ld,%s%lu.%lu\n",
+                                     static_cast<long long>(t),
+                                     static_cast<long>(cursor.running[GridW]),
+                                     static_cast<long>(cursor.running[SetpointW]),
+                                     static_cast<long>(cursor.running[SolarW]),
+                                     temp < 0 ? "-" : "",
+                                     static_cast<unsigned long>(tempAbs / 10U),
+                                     static_cast<unsigned long>(tempAbs % 10U));
+        if (written < 0 || static_cast<size_t>(written) >= outSize - pos)
+        {
+            break;
+        }
+        pos += static_cast<size_t>(written);
+        ++cursor.sample;
+    }
+    return pos;
+}
+
+size_t HistoryStore::readBinary(Cursor &cursor, uint8_t *out, size_t outSize, int64_t epochOffset) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const Ring &ring = rings[static_cast<uint8_t>(cursor.tier)];
+    size_t pos = 0;
+
+    if (!cursor.headerDone)
+    {
+        if (outSize < FILE_HEADER_BYTES)
+        {
+            return 0;
+        }
+        memcpy(out, "SIH2", 4);
+        out[4] = static_cast<uint8_t>(CHANNELS);
+        out[5] = epochOffset != 0 ? 1 : 0;
+        putLe16(out + 6, 0);
+        pos = FILE_HEADER_BYTES;
+        cursor.headerDone = true;
+    }
+
+    while (pos < outSize)
+    {
+        bool newest = false;
+        if (!cursor.inChunk)
+        {
+            const Chunk *chunk = findChunk(ring, cursor.chunkSerial, newest);
+            if (chunk == nullptr || outSize - pos < CHUNK_HEADER_BYTES)
+            {
+                break;
+            }
+            uint8_t *header = out + pos;
+            putLe32(header, static_cast<uint32_t>(static_cast<int64_t>(chunk->startSec) + epochOffset));
+            putLe16(header + 4, ring.resolutionSec);
+            putLe16(header + 6, chunk->count);
+            putLe16(header + 8, chunk->used);
+            putLe16(header + 10, 0);
+            for (size_t c = 0; c < CHANNELS; ++c)
+            {
+                putLe32(header + 12 + 4 * c, static_cast<uint32_t>(chunk->first[c]));
+            }
+            pos += CHUNK_HEADER_BYTES;
+
+            cursor.chunkSerial = chunk->serial;
+            cursor.chunkBytes = chunk->used;
+            cursor.bytePos = 0;
+            cursor.inChunk = true;
+        }
+
+        const Chunk *chunk = findChunk(ring, cursor.chunkSerial, newest);
+        const bool valid = chunk != nullptr && chunk->serial == cursor.chunkSerial;
+        size_t n = cursor.chunkBytes - cursor.bytePos;
+        if (n > outSize - pos)
+        {
+            n = outSize - pos;
+        }
+        if (valid)
+        {
+            memcpy(out + pos, chunk->data + cursor.bytePos, n);
+        }
+        else
+        {
+            // Evicted while streaming: keep the framing intact, the chunk decodes as flat values.
+            memset(out + pos, 0, n);
+        }
+        pos += n;
+        cursor.bytePos = static_cast<uint16_t>(cursor.bytePos + n);
+
+        if (cursor.bytePos < cursor.chunkBytes)
+        {
+            break;
+        }
+        cursor.inChunk = false;
+        ++cursor.chunkSerial;
+    }
+    return pos;
+}
+
+size_t HistoryStore::sampleCount(Tier tier) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const Ring &ring = rings[static_cast<uint8_t>(tier)];
+    size_t total = 0;
+    for (size_t i = 0; i < ring.live; ++i)
+    {
+        total += ring.chunks[(ring.oldest + i) % ring.capacity].count;
+    }
+    return total;
+}
+
+size_t HistoryStore::bytesUsed(Tier tier) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const Ring &ring = rings[static_cast<uint8_t>(tier)];
+    size_t total = 0;
+    for (size_t i = 0; i < ring.live; ++i)
+    {
+        total += ring.chunks[(ring.oldest + i) % ring.capacity].used;
+    }
+    return total;
+}
+
+HistoryStore::Coverage HistoryStore::coverage(Tier tier) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const Ring &ring = rings[static_cast<uint8_t>(tier)];
+    Coverage result;
+    result.resolutionSec = ring.resolutionSec;
+    result.targetSec = ring.spanSec;
+    result.bytesCapacity = static_cast<uint32_t>(ring.capacity * HISTORY_CHUNK_BYTES);
+    result.earlyEvictions = ring.earlyEvictions;
+    for (size_t i = 0; i < ring.live; ++i)
+    {
+        const Chunk &chunk = ring.chunks[(ring.oldest + i) % ring.capacity];
+        result.samples += chunk.count;
+        result.bytesUsed += chunk.used;
+    }
+    if (ring.live > 0)
+    {
+        const Chunk &oldest = ring.chunks[ring.oldest];
+        const Chunk &newest = ring.chunks[(ring.oldest + ring.live - 1) % ring.capacity];
+        result.coveredSec = newest.startSec + static_cast<uint32_t>(newest.count) * ring.resolutionSec - oldest.startSec;
+    }
+    return result;
+}
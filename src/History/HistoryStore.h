@@ -0,0 +1,138 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <mutex>
+
+// RAM budget of the history store. Each chunk costs HISTORY_CHUNK_BYTES plus a 44 byte header.
+// A two-day closed-loop replay (tools/limiter_replay.py) stored 4.0-4.4 bytes per sample in
+// both tiers. The counts below hold the span at 6 bytes per sample plus one chunk that is
+// partly expired; /history.json reports the real figure and any early eviction.
+#ifndef HISTORY_CHUNK_BYTES
+#define HISTORY_CHUNK_BYTES 240
+#endif
+
+// Fine tier: 10 s resolution, 1 h span (360 samples).
+#ifndef HISTORY_FINE_CHUNKS
+#define HISTORY_FINE_CHUNKS 11
+#endif
+
+// Coarse tier: 1 min resolution, 24 h span (1440 samples).
+#ifndef HISTORY_COARSE_CHUNKS
+#define HISTORY_COARSE_CHUNKS 37
+#endif
+
+// Multi-resolution time-series history held in RAM.
+// Control ticks are averaged into 10 s buckets (fine tier) and those into 1 min
+// buckets (coarse tier). Each tier is a ring of fixed-size chunks. The first sample of a
+// chunk is kept as absolute values in the chunk header; every later sample is stored as
+// zig-zag varint deltas against the previous one, so slowly changing values cost one byte
+// per channel. Sample times are implicit (chunk start + index * resolution); a gap in the
+// data starts a new chunk. When a ring runs out of chunks before its span is covered, the
+// oldest chunk is dropped early and counted (see Coverage).
+class HistoryStore
+{
+public:
+    static constexpr size_t CHANNELS = 4;
+    enum Channel : uint8_t
+    {
+        GridW = 0,
+        SetpointW = 1,
+        SolarW = 2,
+        TemperatureDeciC = 3
+    };
+
+    enum class Tier : uint8_t
+    {
+        Fine = 0,
+        Coarse = 1
+    };
+
+    // Read position for streaming a tier out in pieces (HTTP chunked responses).
+    struct Cursor
+    {
+        Tier tier = Tier::Fine;
+        bool headerDone = false;
+        bool inChunk = false;
+        uint32_t chunkSerial = 0; // serial of the chunk being read (or the next one wanted)
+        uint16_t sample = 0;
+        uint16_t bytePos = 0;
+        uint16_t chunkBytes = 0; // binary: byte count announced in the chunk header
+        int32_t running[CHANNELS] = {};
+    };
+
+    // What a tier actually holds; coveredSec < targetSec with earlyEvictions > 0 means the chunk budget is too small.
+    struct Coverage
+    {
+        uint16_t resolutionSec = 0;
+        uint32_t targetSec = 0;
+        uint32_t coveredSec = 0;
+        uint32_t samples = 0;
+        uint32_t bytesUsed = 0;     // delta bytes of the live chunks
+        uint32_t bytesCapacity = 0; // chunk count * HISTORY_CHUNK_BYTES
+        uint32_t earlyEvictions = 0; // chunks dropped while still inside the span
+    };
+
+    HistoryStore();
+
+    // Feeds one control-step reading. Values are averaged into the current 10 s bucket.
+    void addSample(uint32_t uptimeSec, const int32_t (&values)[CHANNELS]);
+
+    // Writes complete CSV lines ("t,grid_w,set_w,solar_w,temp_c") into out.
+    // epochOffset is added to uptime seconds (0 keeps uptime). Returns bytes written, 0 at the end.
+    size_t readCsv(Cursor &cursor, char *out, size_t outSize, int64_t epochOffset) const;
+
+    // Writes the raw encoded chunks into out. Layout (little-endian):
+    //   file header  : "SIH2", uint8 channels, uint8 flags (bit0: epoch timestamps), uint16 reserved
+    //   chunk header : uint32 startTime, uint16 resolutionSec, uint16 sampleCount, uint16 byteCount, uint16 reserved,
+    //                  int32 first sample per channel
+    //   chunk data   : byteCount bytes of zig-zag varint deltas for samples 1..sampleCount-1, channel-interleaved
+    // Returns bytes written, 0 at the end.
+    size_t readBinary(Cursor &cursor, uint8_t *out, size_t outSize, int64_t epochOffset) const;
+
+    size_t sampleCount(Tier tier) const;
+    size_t bytesUsed(Tier tier) const;
+    Coverage coverage(Tier tier) const;
+    static constexpr size_t ramBytes() { return sizeof(HistoryStore); }
+
+private:
+    struct Chunk
+    {
+        uint32_t serial = 0;
+        uint32_t startSec = 0;
+        uint16_t count = 0;
+        uint16_t used = 0;
+        int32_t first[CHANNELS] = {};
+        int32_t last[CHANNELS] = {};
+        uint8_t data[HISTORY_CHUNK_BYTES];
+    };
+
+    struct Ring
+    {
+        Chunk *chunks = nullptr;
+        size_t capacity = 0;
+        size_t oldest = 0;
+        size_t live = 0;
+        uint16_t resolutionSec = 0;
+        uint32_t spanSec = 0;
+        uint32_t earlyEvictions = 0;
+
+        // bucket accumulation feeding this ring
+        int64_t sum[CHANNELS] = {};
+        uint32_t samples = 0;
+        uint32_t bucket = 0;
+    };
+
+    Chunk fineChunks[HISTORY_FINE_CHUNKS];
+    Chunk coarseChunks[HISTORY_COARSE_CHUNKS];
+    Ring rings[2];
+    uint32_t nextSerial = 1;
+    mutable std::mutex mutex;
+
+    void accumulate(Ring &ring, uint32_t timeSec, const int32_t *values, bool forward);
+    void append(Ring &ring, uint32_t timeSec, const int32_t *values);
+    Chunk &openChunk(Ring &ring, uint32_t timeSec);
+    void expire(Ring &ring, uint32_t nowSec);
+    const Chunk *findChunk(const Ring &ring, uint32_t minSerial, bool &isNewest) const;
+    static size_t encodeDelta(const Chunk &chunk, const int32_t *values, uint8_t *out);
+};
@@ -0,0 +1,210 @@
+#include "I2CBus.h"
+
+#include <string.h>
+
+namespace
+{
+constexpr uint8_t SHORT_READ_ERROR = 0xFF;
+} // namespace
+
+void I2CBus::begin(int sdaPin, int sclPin, uint32_t frequencyHz)
+{
+    wire.begin(sdaPin, sclPin);
+    wire.setClock(frequencyHz);
+}
+
+int I2CBus::addDevice(const char *name, uint8_t address)
+{
+    for (int i = 0; i < devices; ++i)
+    {
+        if (deviceStats[i].address == address)
+        {
+            return i;
+        }
+    }
+    if (devices >= I2C_BUS_MAX_DEVICES)
+    {
+        return -1;
+    }
+    deviceStats[devices].name = name;
+    deviceStats[devices].address = address;
+    return devices++;
+}
+
+I2CBus::Transaction *I2CBus::reserve(int device)
+{
+    if (device < 0 || device >= devices)
+    {
+        return nullptr;
+    }
+    if (count >= I2C_BUS_QUEUE_DEPTH)
+    {
+        ++deviceStats[device].queueFull;
+        return nullptr;
+    }
+    Transaction &t = queue[(head + count) % I2C_BUS_QUEUE_DEPTH];
+    t = Transaction{};
+    t.device = static_cast<uint8_t>(device);
+    return &t;
+}
+
+bool I2CBus::write(int device, const uint8_t *data, size_t len, Completion done, void *ctx)
+{
+    if (len == 0 || len > I2C_BUS_MAX_PAYLOAD)
+    {
+        return false;
+    }
+    Transaction *t = reserve(device);
+    if (t == nullptr)
+    {
+        return false;
+    }
+    t->kind = Kind::Write;
+    t->txLen = static_cast<uint8_t>(len);
+    memcpy(t->data, data, len);
+    t->done = done;
+    t->ctx = ctx;
+    ++count;
+    return true;
+}
+
+bool I2CBus::writeRead(int device, const uint8_t *tx, size_t txLen, size_t rxLen, Completion done, void *ctx)
+{
+    if (txLen == 0 || txLen > I2C_BUS_MAX_PAYLOAD || rxLen == 0 || rxLen > I2C_BUS_MAX_PAYLOAD)
+    {
+        return false;
+    }
+    Transaction *t = reserve(device);
+    if (t == nullptr)
+    {
+        return false;
+    }
+    t->kind = Kind::WriteRead;
+    t->txLen = static_cast<uint8_t>(txLen);
+    t->rxLen = static_cast<uint8_t>(rxLen);
+    memcpy(t->data, tx, txLen);
+    t->done = done;
+    t->ctx = ctx;
+    ++count;
+    return true;
+}
+
+bool I2CBus::execute(const Transaction &t, uint8_t *rx)
+{
+    const uint8_t address = deviceStats[t.device].address;
+    const uint32_t start = micros();
+
+    wire.beginTransmission(address);
+    wire.write(t.data, t.txLen);
+    uint8_t error = wire.endTransmission(t.kind == Kind::Write);
+    bool ok = error == 0;
+    if (ok && t.kind == Kind::WriteRead)
+    {
+        const size_t got = wire.requestFrom(address, static_cast<uint8_t>(t.rxLen));
+        for (size_t i = 0; i < got && i < t.rxLen; ++i)
+        {
+            rx[i] = static_cast<uint8_t>(wire.read());
+        }
+        if (got != t.rxLen)
+        {
+            ok = false;
+            error = SHORT_READ_ERROR;
+        }
+    }
+
+    account(t.device, micros() - start, ok, error);
+    return ok;
+}
+
+void I2CBus::account(int device, uint32_t elapsedUs, bool ok, uint8_t error)
+{
+    I2CDeviceStats &s = deviceStats[device];
+    ++s.transactions;
+    s.busyUs += elapsedUs;
+    if (elapsedUs > s.maxUs)
+    {
+        s.maxUs = elapsedUs;
+    }
+    if (!ok)
+    {
+        ++s.errors;
+        s.lastError = error;
+    }
+}
+
+bool I2CBus::transferNow(int device, const uint8_t *tx, size_t txLen, uint8_t *rx, size_t rxLen)
+{
+    if (device < 0 || device >= devices)
+    {
+        return false;
+    }
+    const uint8_t address = deviceStats[device].address;
+    const uint32_t start = micros();
+
+    wire.beginTransmission(address);
+    if (txLen > 0)
+    {
+        wire.write(tx, txLen);
+    }
+    uint8_t error = wire.endTransmission(rxLen == 0);
+    bool ok = error == 0;
+    if (ok && rxLen > 0 && rx != nullptr)
+    {
+        const size_t got = wire.requestFrom(address, static_cast<uint8_t>(rxLen));
+        for (size_t i = 0; i < got && i < rxLen; ++i)
+        {
+            rx[i] = static_cast<uint8_t>(wire.read());
+        }
+        if (got != rxLen)
+        {
+            ok = false;
+            error = SHORT_READ_ERROR;
+        }
+    }
+
+    account(device, micros() - start, ok, error);
+    return ok;
+}
+
+size_t I2CBus::service(uint32_t budgetUs)
+{
+    const uint32_t start = micros();
+    size_t executed = 0;
+    uint8_t rx[I2C_BUS_MAX_PAYLOAD];
+
+    while (count > 0)
+    {
+        if (executed > 0 && (micros() - start) >= budgetUs)
+        {
+            break;
+        }
+
+        // Copy out first: the completion may enqueue the next transaction.
+        const Transaction t = queue[head];
+        head = (head + 1) % I2C_BUS_QUEUE_DEPTH;
+        --count;
+
+        const bool ok = execute(t, rx);
+        ++executed;
+        if (t.done != nullptr)
+        {
+            t.done(t.ctx, ok, t.kind == Kind::WriteRead && ok ? rx : nullptr, ok ? t.rxLen : 0);
+        }
+    }
+
+    const uint32_t elapsed = micros() - start;
+    if (elapsed > longestServiceUs)
+    {
+        longestServiceUs = elapsed;
+    }
+    return executed;
+}
+
+I2CDeviceStats I2CBus::stats(int device) const
+{
+    if (device < 0 || device >= devices)
+    {
+        return I2CDeviceStats{};
+    }
+    return deviceStats[device];
+}
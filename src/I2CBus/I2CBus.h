@@ -0,0 +1,101 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// Number of queued transactions (each slot holds up to I2C_BUS_MAX_PAYLOAD bytes).
+// 24 slots fit one full 128x32 OLED redraw (4 pages x (1 window + 5 data chunks)).
+#ifndef I2C_BUS_QUEUE_DEPTH
+#define I2C_BUS_QUEUE_DEPTH 24
+#endif
+
+#ifndef I2C_BUS_MAX_DEVICES
+#define I2C_BUS_MAX_DEVICES 4
+#endif
+
+// Bus time one service() call may use before it yields back to loop() (microseconds).
+// At least one transaction is always run so the queue keeps moving at low bus clocks.
+#ifndef I2C_BUS_SLICE_US
+#define I2C_BUS_SLICE_US 2000
+#endif
+
+static constexpr size_t I2C_BUS_MAX_PAYLOAD = 32;
+
+struct I2CDeviceStats
+{
+    const char *name = nullptr;
+    uint8_t address = 0;
+    uint8_t lastError = 0;   // Wire endTransmission() code or 0xFF for a short read
+    uint32_t transactions = 0;
+    uint32_t errors = 0;
+    uint32_t queueFull = 0;  // enqueue attempts rejected because the queue was full
+    uint32_t maxUs = 0;      // longest single transaction
+    uint64_t busyUs = 0;     // total bus time
+};
+
+// Shared I2C bus: devices enqueue short transactions from loop(), and
+// service() runs them in FIFO order within a time budget, so a long OLED
+// redraw is spread over several loop passes instead of blocking one.
+// All calls must come from the loop task; the queue is not locked.
+class I2CBus
+{
+public:
+    // Called after a queued transfer. rx holds rxLen bytes for reads (nullptr for writes).
+    using Completion = void (*)(void *ctx, bool ok, const uint8_t *rx, size_t rxLen);
+
+    explicit I2CBus(TwoWire &wire) : wire(wire) {}
+
+    void begin(int sdaPin, int sclPin, uint32_t frequencyHz);
+
+    // Returns the device id or -1 when I2C_BUS_MAX_DEVICES is reached.
+    int addDevice(const char *name, uint8_t address);
+
+    // Queues a write of len bytes (<= I2C_BUS_MAX_PAYLOAD). Returns false if the queue is full.
+    bool write(int device, const uint8_t *data, size_t len, Completion done = nullptr, void *ctx = nullptr);
+
+    // Queues a register read: writes tx, then reads rxLen bytes (both <= I2C_BUS_MAX_PAYLOAD).
+    bool writeRead(int device, const uint8_t *tx, size_t txLen, size_t rxLen, Completion done, void *ctx);
+
+    // Blocking transfer for setup code (probe, init sequences). Counted in the device stats.
+    bool transferNow(int device, const uint8_t *tx, size_t txLen, uint8_t *rx = nullptr, size_t rxLen = 0);
+
+    // Runs queued transactions until the queue is empty or budgetUs is used up.
+    // Returns the number of transactions executed.
+    size_t service(uint32_t budgetUs = I2C_BUS_SLICE_US);
+
+    size_t pending() const { return count; }
+    size_t freeSlots() const { return I2C_BUS_QUEUE_DEPTH - count; }
+    int deviceCount() const { return devices; }
+    I2CDeviceStats stats(int device) const;
+    uint32_t maxServiceUs() const { return longestServiceUs; }
+
+private:
+    enum class Kind : uint8_t
+    {
+        Write,
+        WriteRead,
+    };
+
+    struct Transaction
+    {
+        uint8_t device = 0;
+        Kind kind = Kind::Write;
+        uint8_t txLen = 0;
+        uint8_t rxLen = 0;
+        uint8_t data[I2C_BUS_MAX_PAYLOAD];
+        Completion done = nullptr;
+        void *ctx = nullptr;
+    };
+
+    TwoWire &wire;
+    Transaction queue[I2C_BUS_QUEUE_DEPTH];
+    size_t head = 0;
+    size_t count = 0;
+    I2CDeviceStats deviceStats[I2C_BUS_MAX_DEVICES];
+    int devices = 0;
+    uint32_t longestServiceUs = 0;
+
+    Transaction *reserve(int device);
+    bool execute(const Transaction &t, uint8_t *rx);
+    void account(int device, uint32_t elapsedUs, bool ok, uint8_t error);
+};
@@ -0,0 +1,28 @@
+#include "I2CBusHttp.h"
+
+#include <stdio.h>
+
+void registerI2CBusRoutes(AsyncWebServer &server, I2CBus &bus)
+{
+    server.on("/i2c/stats", HTTP_GET, [&bus](AsyncWebServerRequest *request)
+              {
+        char json[160 + I2C_BUS_MAX_DEVICES * 176];
+        size_t pos = static_cast<size_t>(snprintf(json, sizeof(json), "{\"pending\":%u,\"maxServiceUs\":%lu,\"devices\":[",
+                                                  static_cast<unsigned int>(bus.pending()),
+                                                  static_cast<unsigned long>(bus.maxServiceUs())));
+        for (int i = 0; i < bus.deviceCount() && pos < sizeof(json); ++i)
+        {
+            const I2CDeviceStats s = bus.stats(i);
+            pos += static_cast<size_t>(snprintf(json + pos, sizeof(json) - pos,
+                "%s{\"name\":\"%s\",\"addr\":%u,\"tx\":%lu,\"errors\":%lu,\"lastError\":%u,\"queueFull\":%lu,\"busyMs\":%lu,\"maxUs\":%lu}",
+                i == 0 ? "" : ",", s.name != nullptr ? s.name : "?", static_cast<unsigned int>(s.address),
+                static_cast<unsigned long>(s.transactions), static_cast<unsigned long>(s.errors),
+                static_cast<unsigned int>(s.lastError), static_cast<unsigned long>(s.queueFull),
+                static_cast<unsigned long>(s.busyUs / 1000ULL), static_cast<unsigned long>(s.maxUs)));
+        }
+        if (pos < sizeof(json))
+        {
+            snprintf(json + pos, sizeof(json) - pos, "]}");
+        }
+        request->send(200, "application/json", json); });
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <ESPAsyncWebServer.h>
+
+#include "I2CBus.h"
+
+// Registers GET /i2c/stats: per-device transaction count, errors, bus time and queue pressure (JSON).
+void registerI2CBusRoutes(AsyncWebServer &server, I2CBus &bus);
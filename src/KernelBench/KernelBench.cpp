@@ -0,0 +1,325 @@
+#include "KernelBench.h"
+
+#if defined(KERNEL_BENCHMARK)
+
+#include <stdio.h>
+#include <string.h>
+
+#include "FixedString/FixedString.h"
+#include "HeapTrace/HeapTrace.h"
+#include "LimiterCore/LimiterCore.h"
+#include "PowerEstimator/PowerEstimator.h"
+#include "RS485Module/RS485Frame.h"
+#include "Smoother/Smoother.h"
+
+#if __has_include(<ArduinoJson.h>)
+#include <ArduinoJson.h>
+#define KERNEL_BENCH_JSON 1
+#else
+#define KERNEL_BENCH_JSON 0
+#endif
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#include "logging/LoggingManager.h"
+
+namespace
+{
+using BenchTicks = uint32_t; // CPU cycles, wraps after ~17 s at 240 MHz
+
+BenchTicks benchTicks()
+{
+    return ESP.getCycleCount();
+}
+} // namespace
+
+const char *kernelBenchUnit()
+{
+    return "cycles";
+}
+#else
+#include <chrono>
+
+namespace
+{
+using BenchTicks = uint64_t; // ns
+
+BenchTicks benchTicks()
+{
+    using namespace std::chrono;
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+} // namespace
+
+const char *kernelBenchUnit()
+{
+    return "ns";
+}
+#endif
+
+namespace
+{
+constexpr int GRID_SERIES_LEN = 256;
+
+volatile int benchSink = 0; // keeps results alive so the compiler cannot drop the kernel
+
+int gridSeries[GRID_SERIES_LEN];
+int solarSeries[GRID_SERIES_LEN];
+uint8_t rxBytes[64];
+
+// Grid power as a bounded random walk (-1500..2500 W with load steps), solar as a slow ramp.
+void fillInputs()
+{
+    uint32_t seed = 0x1234567u;
+    int grid = 150;
+    for (int i = 0; i < GRID_SERIES_LEN; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        grid += static_cast<int>((seed >> 16) % 201) - 100;
+        if ((seed & 0x1F) == 0)
+        {
+            grid += (seed & 0x20) ? 900 : -900; // kettle on/off
+        }
+        grid = grid < -1500 ? -1500 : (grid > 2500 ? 2500 : grid);
+        gridSeries[i] = grid;
+        solarSeries[i] = 200 + (i * 3) % 500;
+    }
+    for (size_t i = 0; i < sizeof(rxBytes); ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        rxBytes[i] = static_cast<uint8_t>(seed >> 24);
+    }
+}
+
+LimiterParams benchParams(bool usePid, int smoothingSize)
+{
+    LimiterSettingsValues values;
+    values.minOutputW = 0;
+    values.maxOutputW = 800;
+    values.correctionOffsetW = 30;
+    values.smoothingSize = smoothingSize;
+    values.usePid = usePid;
+    values.pidKp = 0.5f;
+    values.pidKi = 0.1f;
+    values.pidKd = 0.05f;
+    values.publishPeriodSec = 2.0f;
+    return buildLimiterParams(values, 1);
+}
+
+struct Measurement
+{
+    float perOp;
+    float allocsPerOp;
+};
+
+template <typename Fn>
+Measurement measure(uint32_t iterations, Fn &&fn)
+{
+    float best = 0.0f;
+    HeapTraceScope heap(HeapTag::Bench);
+    for (int run = 0; run < KERNEL_BENCH_REPEATS; ++run)
+    {
+        const BenchTicks start = benchTicks();
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            fn(i);
+        }
+        const BenchTicks elapsed = benchTicks() - start;
+        const float perOp = static_cast<float>(elapsed) / static_cast<float>(iterations);
+        if (run == 0 || perOp < best)
+        {
+            best = perOp;
+        }
+    }
+    const float allocsPerOp = static_cast<float>(heap.allocs()) / static_cast<float>(iterations * KERNEL_BENCH_REPEATS);
+    return Measurement{best, allocsPerOp};
+}
+
+#if KERNEL_BENCH_JSON
+// Recorded payloads of the two SENSOR topics the limiter subscribes to.
+const char POWER_METER_PAYLOAD[] =
+    R"({"Time":"2025-06-01T12:00:02","E320":{"Meter_Number":"0901454d4800007c3ee0","Total_in":12345.6789,)"
+    R"("Total_out":6789.0123,"Power_in":-312,"Power_cur":-312}})";
+const char SOLAR_PLUG_PAYLOAD[] =
+    R"({"Time":"2025-06-01T12:00:02","ENERGY":{"TotalStartTime":"2024-04-20T09:31:07","Total":812.345,)"
+    R"("Yesterday":4.120,"Today":2.871,"Period":11,"Power":583,"ApparentPower":596,"ReactivePower":121,)"
+    R"("Factor":0.98,"Voltage":233,"Current":2.556}})";
+
+template <size_t N>
+int extractInt(const char (&payload)[N], const char *object, const char *field)
+{
+    JsonDocument doc;
+    if (deserializeJson(doc, payload, N - 1))
+    {
+        return 0;
+    }
+    return doc[object][field] | 0;
+}
+#endif
+} // namespace
+
+int runKernelBenchmarks(KernelBenchSink sink)
+{
+    fillInputs();
+    heapTraceBegin();
+    int results = 0;
+    auto report = [&](const char *kernel, const char *input, uint32_t iterations, Measurement measured, bool allocFree = true)
+    {
+        sink(KernelBenchResult{kernel, input, iterations, measured.perOp, measured.allocsPerOp, allocFree});
+        ++results;
+    };
+
+    // Smoother::smooth at the smallest, default-ish and largest window.
+    static const int SMOOTH_SIZES[] = {1, 10, 60, Smoother::MAX_BUFFER_SIZE};
+    static const char *const SMOOTH_LABELS[] = {"size=1", "size=10", "size=60", "size=120"};
+    for (size_t s = 0; s < sizeof(SMOOTH_SIZES) / sizeof(SMOOTH_SIZES[0]); ++s)
+    {
+        Smoother smoother(SMOOTH_SIZES[s]);
+        smoother.fillBufferOnStart(gridSeries[0]);
+        report("smooth", SMOOTH_LABELS[s], 2000, measure(2000, [&](uint32_t i)
+                                                         { benchSink = smoother.smooth(gridSeries[i % GRID_SERIES_LEN]); }));
+    }
+
+    {
+        const LimiterParams params = benchParams(true, 1);
+        PidControllerState pid;
+        report("pid_step", "kp=0.5 ki=0.1 kd=0.05", 2000, measure(2000, [&](uint32_t i)
+                                                                   {
+            const int base = solarSeries[i % GRID_SERIES_LEN] + gridSeries[i % GRID_SERIES_LEN] + params.correctionOffsetW;
+            benchSink = computePidStep(pid, base, params, i * 2000u); }));
+    }
+
+    {
+        LimiterCore core;
+        const LimiterParams params = benchParams(false, 10);
+        core.ensureSmoother(params.smoothingSize, gridSeries[0]);
+        report("limiter_step", "smoother size=10", 2000, measure(2000, [&](uint32_t i)
+                                                                   {
+            LimiterInputs inputs;
+            inputs.gridW = gridSeries[i % GRID_SERIES_LEN];
+            inputs.solarW = solarSeries[i % GRID_SERIES_LEN];
+            benchSink = core.step(inputs, params, i * 2000u).setW; }));
+    }
+
+    {
+        LimiterCore core;
+        const LimiterParams params = benchParams(true, 1);
+        report("limiter_step", "pid", 2000, measure(2000, [&](uint32_t i)
+                                                     {
+            LimiterInputs inputs;
+            inputs.gridW = gridSeries[i % GRID_SERIES_LEN];
+            inputs.solarW = solarSeries[i % GRID_SERIES_LEN];
+            benchSink = core.step(inputs, params, i * 2000u).setW; }));
+    }
+
+    {
+        PowerEstimator estimator;
+        estimator.updateSolar(solarSeries[0], 0);
+        estimator.updateGrid(gridSeries[0], 0);
+        report("estimator", "grid update", 2000, measure(2000, [&](uint32_t i)
+                                                         {
+            estimator.updateGrid(gridSeries[i % GRID_SERIES_LEN], (i + 1) * 2000u);
+            benchSink = estimator.estimate((i + 1) * 2000u + 500u).gridW; }));
+        report("estimator", "command + solar", 2000, measure(2000, [&](uint32_t i)
+                                                             {
+            const uint32_t nowMs = 4000000u + i * 2000u;
+            estimator.setCommand(solarSeries[(i + 7) % GRID_SERIES_LEN], nowMs);
+            estimator.updateSolar(solarSeries[i % GRID_SERIES_LEN], nowMs + 1000u);
+            benchSink = estimator.estimate(nowMs + 1500u).outputW; }));
+    }
+
+    {
+        uint8_t frame[RS485_FRAME_BYTES];
+        report("frame_encode", "setpoint", 2000, measure(2000, [&](uint32_t i)
+                                                         {
+            encodeSetpointFrame(static_cast<uint16_t>(gridSeries[i % GRID_SERIES_LEN] & 0x3FF), frame);
+            benchSink = frame[7]; }));
+    }
+
+    {
+        char hex[sizeof(rxBytes) * 3 + 1];
+        report("hex_dump", "8 bytes", 1000, measure(1000, [&](uint32_t i)
+                                                    { benchSink = static_cast<int>(formatHexBytes(rxBytes + (i % 8), 8, hex, sizeof(hex))); }));
+        report("hex_dump", "64 bytes", 500, measure(500, [&](uint32_t)
+                                                    { benchSink = static_cast<int>(formatHexBytes(rxBytes, sizeof(rxBytes), hex, sizeof(hex))); }));
+    }
+
+    {
+        FixedString<128> topic;
+        report("fixed_string", "topic format", 2000, measure(2000, [&](uint32_t i)
+                                                             {
+            topic.format("%s/%s", (i & 1) ? "SolarInverterLimiter" : "solar-limiter-garage", "CalculatedValue");
+            benchSink = static_cast<int>(topic.length()); }));
+        FixedString<24> value;
+        report("fixed_string", "int payload", 2000, measure(2000, [&](uint32_t i)
+                                                            {
+            value.format("%d", gridSeries[i % GRID_SERIES_LEN]);
+            benchSink = static_cast<int>(value.length()); }));
+    }
+
+#if KERNEL_BENCH_JSON
+    report("json_extract", "E320.Power_in", 200, measure(200, [&](uint32_t)
+                                                         { benchSink = extractInt(POWER_METER_PAYLOAD, "E320", "Power_in"); }),
+           false);
+    report("json_extract", "ENERGY.Power", 200, measure(200, [&](uint32_t)
+                                                        { benchSink = extractInt(SOLAR_PLUG_PAYLOAD, "ENERGY", "Power"); }),
+           false);
+#endif
+
+    return results;
+}
+
+int formatKernelBenchLine(const KernelBenchResult &result, char *out, int outSize)
+{
+    if (!heapTraceCompiledIn())
+    {
+        return snprintf(out, static_cast<size_t>(outSize),
+                        "KBENCH {\"kernel\":\"%s\",\"input\":\"%s\",\"iters\":%lu,\"unit\":\"%s\",\"per_op\":%.1f}",
+                        result.kernel, result.input, static_cast<unsigned long>(result.iterations), kernelBenchUnit(),
+                        static_cast<double>(result.perOp));
+    }
+    return snprintf(out, static_cast<size_t>(outSize),
+                    "KBENCH {\"kernel\":\"%s\",\"input\":\"%s\",\"iters\":%lu,\"unit\":\"%s\",\"per_op\":%.1f,"
+                    "\"allocs\":%.2f,\"alloc_free\":%s}",
+                    result.kernel, result.input, static_cast<unsigned long>(result.iterations), kernelBenchUnit(),
+                    static_cast<double>(result.perOp), static_cast<double>(result.allocsPerOp),
+                    result.allocFree ? "true" : "false");
+}
+
+#if defined(ARDUINO)
+void runKernelBenchmark()
+{
+    const int count = runKernelBenchmarks([](const KernelBenchResult &result)
+                                          {
+        char line[200];
+        formatKernelBenchLine(result, line, sizeof(line));
+        cm::LoggingManager::instance().logTag(cm::LoggingManager::Level::Info, "BENCH", "%s", line); });
+    cm::LoggingManager::instance().logTag(cm::LoggingManager::Level::Info, "BENCH", "%d kernel results at %lu MHz",
+                                          count, static_cast<unsigned long>(getCpuFrequencyMhz()));
+}
+#else
+void runKernelBenchmark()
+{
+    runKernelBenchmarks([](const KernelBenchResult &result)
+                        {
+        char line[200];
+        formatKernelBenchLine(result, line, sizeof(line));
+        puts(line); });
+}
+
+#if defined(KERNEL_BENCH_HOST_MAIN)
+int main()
+{
+    runKernelBenchmark();
+    return 0;
+}
+#endif
+#endif
+
+#else
+
+void runKernelBenchmark()
+{
+}
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+// Microbenchmarks of the per-tick kernels (smoother, PID step, limiter step, frame encoding,
+// hex dump, FixedString topic/payload formatting, Tasmota JSON extraction). Only built with -DKERNEL_BENCHMARK.
+//
+// Each result is one machine-readable line:
+//   KBENCH {"kernel":"smooth","input":"size=120","iters":2000,"unit":"cycles","per_op":812.4}
+// Unit is CPU cycles on the ESP32 (usb_kernelbench, logged after startup) and ns on the host
+// (tools/kernelbench.py host). tools/kernelbench.py compare checks the lines against a baseline.
+// Builds with -DHEAP_TRACE_ENABLED (the host run) add "allocs" per op and "alloc_free" for
+// kernels on the control path that must not touch the heap; compare fails if one does.
+
+struct KernelBenchResult
+{
+    const char *kernel;
+    const char *input;
+    uint32_t iterations;
+    float perOp;       // best of KERNEL_BENCH_REPEATS runs
+    float allocsPerOp; // heap allocations per op over all runs (0 without HEAP_TRACE_ENABLED)
+    bool allocFree;    // kernel runs inside processRS485Tick() and must not allocate
+};
+
+using KernelBenchSink = void (*)(const KernelBenchResult &result);
+
+#ifndef KERNEL_BENCH_REPEATS
+#define KERNEL_BENCH_REPEATS 5
+#endif
+
+const char *kernelBenchUnit();
+
+// Runs every kernel and hands each result to sink; returns the number of results.
+int runKernelBenchmarks(KernelBenchSink sink);
+
+// Formats a result as a KBENCH line (without newline).
+int formatKernelBenchLine(const KernelBenchResult &result, char *out, int outSize);
+
+// Device entry point: runs the suite and logs one KBENCH line per result.
+void runKernelBenchmark();
@@ -0,0 +1,214 @@
+#include "LimiterCore.h"
+
+#include <math.h>
+#include <new>
+
+namespace
+{
+template <typename T>
+T clampTo(T value, T low, T high)
+{
+    return value < low ? low : (value > high ? high : value);
+}
+} // namespace
+
+NegativePriceSettingPreference resolveNegativePricePreference(NegativePriceSettingPreference preferred,
+                                                              NegativePriceSettingPreference last)
+{
+    NegativePriceSettingPreference winner = preferred;
+    if (winner == NegativePriceSettingPreference::None)
+    {
+        winner = last;
+    }
+    return winner == NegativePriceSettingPreference::SetZero ? NegativePriceSettingPreference::SetZero
+                                                             : NegativePriceSettingPreference::ForceMin;
+}
+
+int computePidStep(PidControllerState &pid, int baseTarget, const LimiterParams &params, uint32_t nowMs)
+{
+    const float configuredMin = static_cast<float>(params.minOutputW);
+    const float configuredMax = static_cast<float>(params.maxOutputW);
+    float dtSeconds = params.publishPeriodSec;
+
+    if (pid.initialized)
+    {
+        const uint32_t elapsedMs = nowMs - pid.lastUpdateMs;
+        if (elapsedMs > 0)
+        {
+            dtSeconds = static_cast<float>(elapsedMs) / 1000.0f;
+        }
+    }
+
+    dtSeconds = clampTo(dtSeconds, 0.05f, 10.0f);
+
+    if (!pid.initialized)
+    {
+        pid.initialized = true;
+        pid.output = clampTo(static_cast<float>(baseTarget), configuredMin, configuredMax);
+        pid.integral = 0.0f;
+        pid.previousError = 0.0f;
+    }
+
+    // PID setpoint is the desired inverter target. PID input is the last commanded target.
+    const float error = static_cast<float>(baseTarget) - pid.output;
+    const float candidateIntegral = clampTo(pid.integral + error * dtSeconds, -LIMITER_PID_INTEGRAL_LIMIT, LIMITER_PID_INTEGRAL_LIMIT);
+    const float derivative = (error - pid.previousError) / dtSeconds;
+    const float delta = params.pidKp * error +
+                        params.pidKi * candidateIntegral +
+                        params.pidKd * derivative;
+
+    const float candidateOutput = pid.output + delta;
+    const float clampedOutput = clampTo(candidateOutput, configuredMin, configuredMax);
+
+    if (candidateOutput == clampedOutput ||
+        (candidateOutput > configuredMax && error < 0.0f) ||
+        (candidateOutput < configuredMin && error > 0.0f))
+    {
+        pid.integral = candidateIntegral;
+    }
+
+    pid.output = clampedOutput;
+
+    pid.previousError = error;
+    pid.lastUpdateMs = nowMs;
+
+    return static_cast<int>(roundf(pid.output));
+}
+
+int negativePriceTargetW(bool negativePriceActive, const LimiterParams &params)
+{
+    if (!negativePriceActive)
+    {
+        return -1;
+    }
+    switch (params.negativePriceMode)
+    {
+    case NegativePriceMode::SetZero:
+        return 0;
+    case NegativePriceMode::ForceMin:
+        return params.minOutputW;
+    default:
+        return -1;
+    }
+}
+
+LimiterCore::~LimiterCore()
+{
+    delete powerSmoother;
+}
+
+void LimiterCore::resetPid()
+{
+    pidState = PidControllerState{};
+}
+
+bool LimiterCore::ensureSmoother(int size, int initialValue)
+{
+    if (powerSmoother != nullptr)
+    {
+        if (powerSmoother->isReady())
+        {
+            return true;
+        }
+        delete powerSmoother;
+        powerSmoother = nullptr;
+    }
+
+    powerSmoother = new (std::nothrow) Smoother(size);
+    if (powerSmoother == nullptr || !powerSmoother->isReady())
+    {
+        delete powerSmoother;
+        powerSmoother = nullptr;
+        lastSmootherRequestedSize = -1;
+        return false;
+    }
+
+    lastSmootherRequestedSize = size;
+    powerSmoother->fillBufferOnStart(initialValue);
+    return true;
+}
+
+bool LimiterCore::resizeSmoother(int size, int initialValue)
+{
+    if (!ensureSmoother(size, initialValue))
+    {
+        return false;
+    }
+    if (size == lastSmootherRequestedSize)
+    {
+        return powerSmoother->isReady();
+    }
+
+    const int previousSize = powerSmoother->size();
+    powerSmoother->setBufferSize(size);
+    lastSmootherRequestedSize = size;
+    if (powerSmoother->size() != previousSize)
+    {
+        powerSmoother->fillBufferOnStart(initialValue);
+    }
+    return powerSmoother->isReady();
+}
+
+LimiterStep LimiterCore::step(const LimiterInputs &inputs, const LimiterParams &params, uint32_t nowMs)
+{
+    LimiterStep out;
+    const bool usePid = params.usePid;
+    if (usePid != lastModeWasPid)
+    {
+        resetPid();
+        if (!usePid && ensureSmoother(params.smoothingSize, inputs.gridW))
+        {
+            powerSmoother->fillBufferOnStart(inputs.gridW);
+        }
+        lastModeWasPid = usePid;
+    }
+
+    if (!usePid)
+    {
+        resizeSmoother(params.smoothingSize, inputs.gridW);
+    }
+
+    out.negativePriceTargetW = negativePriceTargetW(inputs.negativePriceActive, params);
+    if (out.negativePriceTargetW >= 0)
+    {
+        resetPid();
+        out.calculatedW = out.negativePriceTargetW;
+    }
+    else if (usePid)
+    {
+        out.pidBaseW = inputs.solarW + inputs.gridW + params.correctionOffsetW;
+        out.pidClampedBaseW = clampTo(out.pidBaseW, params.minOutputW, params.maxOutputW);
+        out.pidInputW = pidState.initialized ? static_cast<int>(roundf(pidState.output)) : out.pidClampedBaseW;
+        out.calculatedW = computePidStep(pidState, out.pidBaseW, params, nowMs);
+    }
+    else if (powerSmoother != nullptr && powerSmoother->isReady())
+    {
+        out.calculatedW = powerSmoother->smooth(inputs.gridW);
+    }
+    else
+    {
+        out.calculatedW = params.maxOutputW;
+        out.smootherMissing = true;
+    }
+
+    if (out.negativePriceTargetW >= 0)
+    {
+        out.path = LimiterPath::NegativePrice;
+        out.correctedW = out.negativePriceTargetW;
+        out.setW = out.negativePriceTargetW;
+    }
+    else if (params.controllerEnabled)
+    {
+        out.path = LimiterPath::Controller;
+        out.correctedW = usePid ? out.calculatedW : out.calculatedW + params.correctionOffsetW;
+        out.setW = clampTo(out.correctedW, params.minOutputW, params.maxOutputW);
+    }
+    else
+    {
+        out.path = LimiterPath::Disabled;
+        out.correctedW = params.maxOutputW;
+        out.setW = params.maxOutputW;
+        resetPid();
+    }
+    return out;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "LimiterParams/LimiterParams.h"
+#include "Smoother/Smoother.h"
+
+// Control core of processRS485Tick(): PID step, smoother handling and the negative-price
+// override. No Arduino or ConfigManager dependency: readings come in as LimiterInputs, the
+// clock as nowMs, and the result goes out as a LimiterStep that the caller sends and logs.
+
+enum class NegativePriceSettingPreference : uint8_t
+{
+    None,
+    ForceMin,
+    SetZero
+};
+
+// Which of the two conflicting negative-price settings survives: the one just enabled,
+// otherwise the one that won last time, otherwise ForceMin.
+NegativePriceSettingPreference resolveNegativePricePreference(NegativePriceSettingPreference preferred,
+                                                              NegativePriceSettingPreference last);
+
+struct PidControllerState
+{
+    bool initialized = false;
+    float output = 0.0f;
+    float integral = 0.0f;
+    float previousError = 0.0f;
+    uint32_t lastUpdateMs = 0;
+};
+
+static constexpr float LIMITER_PID_INTEGRAL_LIMIT = 5000.0f;
+
+// One PID step towards baseTarget; returns the new output in W (clamped to min..max).
+int computePidStep(PidControllerState &pid, int baseTarget, const LimiterParams &params, uint32_t nowMs);
+
+// Forced output while a negative price is active, or -1 when the normal path applies.
+int negativePriceTargetW(bool negativePriceActive, const LimiterParams &params);
+
+struct LimiterInputs
+{
+    int gridW = 0;  // signed: positive import, negative export
+    int solarW = 0; // current inverter output
+    bool negativePriceActive = false;
+};
+
+enum class LimiterPath : uint8_t
+{
+    NegativePrice,
+    Controller,
+    Disabled, // controller off -> max output
+};
+
+struct LimiterStep
+{
+    LimiterPath path = LimiterPath::Disabled;
+    int calculatedW = 0;
+    int correctedW = 0;
+    int setW = 0;
+    int negativePriceTargetW = -1;
+    bool smootherMissing = false; // smoother mode without a buffer -> calculatedW is max
+    // PID trace values (0 outside PID mode)
+    int pidBaseW = 0;
+    int pidClampedBaseW = 0;
+    int pidInputW = 0;
+};
+
+class LimiterCore
+{
+public:
+    LimiterCore() = default;
+    ~LimiterCore();
+    LimiterCore(const LimiterCore &) = delete;
+    LimiterCore &operator=(const LimiterCore &) = delete;
+
+    LimiterStep step(const LimiterInputs &inputs, const LimiterParams &params, uint32_t nowMs);
+
+    // Allocates the smoother (filled with initialValue) if there is none; false when the allocation failed.
+    bool ensureSmoother(int size, int initialValue);
+    void resetPid();
+
+    PidControllerState &pid() { return pidState; }
+    const PidControllerState &pid() const { return pidState; }
+    Smoother *smoother() { return powerSmoother; }
+    const Smoother *smoother() const { return powerSmoother; }
+    bool modeIsPid() const { return lastModeWasPid; }
+    void setModeIsPid(bool usePid) { lastModeWasPid = usePid; }
+
+private:
+    PidControllerState pidState;
+    Smoother *powerSmoother = nullptr;
+    bool lastModeWasPid = false;
+    int lastSmootherRequestedSize = -1;
+
+    bool resizeSmoother(int size, int initialValue);
+};
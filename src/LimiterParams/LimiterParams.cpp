@@ -0,0 +1,50 @@
+#include "LimiterParams.h"
+
+#include <math.h>
+
+namespace
+{
+float finiteOrZero(float value)
+{
+    return isfinite(value) ? value : 0.0f;
+}
+} // namespace
+
+LimiterParams buildLimiterParams(const LimiterSettingsValues &values, uint32_t generation)
+{
+    LimiterParams params;
+    params.controllerEnabled = values.controllerEnabled;
+    params.minOutputW = values.minOutputW <= values.maxOutputW ? values.minOutputW : values.maxOutputW;
+    params.maxOutputW = values.minOutputW <= values.maxOutputW ? values.maxOutputW : values.minOutputW;
+    params.correctionOffsetW = values.correctionOffsetW;
+    params.smoothingSize = values.smoothingSize < 1 ? 1 : values.smoothingSize;
+    params.usePid = values.usePid;
+    params.pidKp = finiteOrZero(values.pidKp);
+    params.pidKi = finiteOrZero(values.pidKi);
+    params.pidKd = finiteOrZero(values.pidKd);
+
+    // Same precedence as the control step always had: force-min wins over set-zero.
+    if (values.forceMinOnNegativePrice)
+    {
+        params.negativePriceMode = NegativePriceMode::ForceMin;
+    }
+    else if (values.setZeroOnNegativePrice)
+    {
+        params.negativePriceMode = NegativePriceMode::SetZero;
+    }
+
+    const float period = isfinite(values.publishPeriodSec) ? values.publishPeriodSec : LIMITER_MIN_PERIOD_S;
+    params.publishPeriodSec = period < LIMITER_MIN_PERIOD_S ? LIMITER_MIN_PERIOD_S : (period > LIMITER_MAX_PERIOD_S ? LIMITER_MAX_PERIOD_S : period);
+    params.bootSafeOutputW = values.bootSafeOutputW < 0 ? 0 : (values.bootSafeOutputW > params.maxOutputW ? params.maxOutputW : values.bootSafeOutputW);
+    params.useEstimator = values.useEstimator;
+    params.generation = generation;
+    return params;
+}
+
+void LimiterParamsStore::publish(const LimiterParams &params)
+{
+    const LimiterParams *current = active.load(std::memory_order_relaxed);
+    LimiterParams *next = current == &slots[0] ? &slots[1] : &slots[0];
+    *next = params;
+    active.store(next, std::memory_order_release);
+}
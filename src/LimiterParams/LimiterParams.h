@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+enum class NegativePriceMode : uint8_t
+{
+    Off,      // negative price does not change the output path
+    ForceMin, // drive the configured minimum
+    SetZero,  // drive 0 W
+};
+
+// Raw limiter settings as stored; may be inconsistent (min > max, both negative-price modes on, ...).
+struct LimiterSettingsValues
+{
+    bool controllerEnabled = true;
+    int minOutputW = 0;
+    int maxOutputW = 0;
+    int correctionOffsetW = 0;
+    int smoothingSize = 1;
+    bool usePid = false;
+    float pidKp = 0.0f;
+    float pidKi = 0.0f;
+    float pidKd = 0.0f;
+    bool forceMinOnNegativePrice = false;
+    bool setZeroOnNegativePrice = false;
+    float publishPeriodSec = 2.0f;
+    int bootSafeOutputW = 0;
+    bool useEstimator = false;
+};
+
+// Validated, immutable limiter parameters. The control step reads nothing else.
+struct LimiterParams
+{
+    bool controllerEnabled = true;
+    int minOutputW = 0; // always <= maxOutputW
+    int maxOutputW = 0;
+    int correctionOffsetW = 0;
+    int smoothingSize = 1; // >= 1
+    bool usePid = false;
+    float pidKp = 0.0f; // finite
+    float pidKi = 0.0f;
+    float pidKd = 0.0f;
+    NegativePriceMode negativePriceMode = NegativePriceMode::Off;
+    float publishPeriodSec = 2.0f; // clamped to [LIMITER_MIN_PERIOD_S, LIMITER_MAX_PERIOD_S]
+    int bootSafeOutputW = 0;       // sent right after reset until startup completes, within [0, maxOutputW]
+    bool useEstimator = false;     // regulate on the PowerEstimator state instead of the raw readings
+    uint32_t generation = 0;       // bumped on every rebuild
+};
+
+static constexpr float LIMITER_MIN_PERIOD_S = 0.1f;
+static constexpr float LIMITER_MAX_PERIOD_S = 60.0f;
+
+LimiterParams buildLimiterParams(const LimiterSettingsValues &values, uint32_t generation);
+
+// Double-buffered parameter snapshot.
+// publish() is called from the loop task only (settings callbacks just mark the snapshot
+// stale); it fills the inactive slot and swaps the pointer, so readers on any task always
+// see a complete struct.
+class LimiterParamsStore
+{
+public:
+    const LimiterParams &current() const { return *active.load(std::memory_order_acquire); }
+    void publish(const LimiterParams &params);
+
+    void markStale() { stale.store(true, std::memory_order_release); }
+    bool takeStale() { return stale.exchange(false, std::memory_order_acq_rel); }
+
+private:
+    LimiterParams slots[2];
+    std::atomic<const LimiterParams *> active{&slots[0]};
+    std::atomic<bool> stale{true};
+};
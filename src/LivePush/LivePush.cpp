@@ -0,0 +1,252 @@
+#include "LivePush.h"
+
+#include <math.h>
+#include <stdio.h>
+
+namespace
+{
+constexpr int32_t POW10[] = {1, 10, 100, 1000};
+constexpr uint8_t MAX_PRECISION = 3;
+} // namespace
+
+LivePush::LivePush(const char *path)
+    : ws(path)
+{
+}
+
+bool LivePush::addField(const char *key, Getter getter, uint8_t precision)
+{
+    if (fieldCount >= LIVE_PUSH_MAX_FIELDS || key == nullptr || getter == nullptr)
+    {
+        return false;
+    }
+
+    Field &field = fields[fieldCount++];
+    field.key = key;
+    field.getter = getter;
+    field.precision = precision > MAX_PRECISION ? MAX_PRECISION : precision;
+    field.lastScaled = scale(getter(), field.precision);
+    field.version = 0;
+    return true;
+}
+
+void LivePush::begin(AsyncWebServer &server)
+{
+    ws.onEvent([this](AsyncWebSocket *, AsyncWebSocketClient *client, AwsEventType type, void *, uint8_t *, size_t)
+               { onEvent(client, type); });
+    server.addHandler(&ws);
+}
+
+void LivePush::onEvent(AsyncWebSocketClient *client, AwsEventType type)
+{
+    if (type != WS_EVT_CONNECT || client == nullptr)
+    {
+        return;
+    }
+
+    // Runs in the async_tcp task: only queue the client id, the snapshot is built in update().
+    if (!queueSnapshot(client->id()))
+    {
+        client->close(); // would never get a snapshot
+    }
+}
+
+bool LivePush::queueSnapshot(uint32_t id)
+{
+    bool queued = false;
+    portENTER_CRITICAL(&pendingMux);
+    if (pendingCount < MAX_PENDING_SNAPSHOTS)
+    {
+        pendingSnapshots[pendingCount++] = id;
+        queued = true;
+    }
+    portEXIT_CRITICAL(&pendingMux);
+    return queued;
+}
+
+void LivePush::update()
+{
+    const unsigned long now = millis();
+    if (static_cast<long>(now - nextPollMs) < 0)
+    {
+        return;
+    }
+    nextPollMs = now + LIVE_PUSH_INTERVAL_MS;
+
+    ws.cleanupClients();
+    if (ws.count() == 0)
+    {
+        trackedClients = 0;
+        return;
+    }
+
+    pollFields();
+    sendPendingSnapshots();
+    sendDeltas();
+}
+
+void LivePush::sendDeltas()
+{
+    bool built = false;
+    uint32_t builtSince = 0;
+    size_t len = 0;
+    size_t i = 0;
+    while (i < trackedClients)
+    {
+        ClientState &state = clients[i];
+        AsyncWebSocketClient *client = ws.client(state.id);
+        if (client == nullptr || client->status() != WS_CONNECTED)
+        {
+            clients[i] = clients[--trackedClients];
+            continue;
+        }
+        ++i;
+        if (state.lastSent == seq || !client->canSend())
+        {
+            continue; // up to date, or queue full: the next delta covers the gap
+        }
+        if (!built || builtSince != state.lastSent)
+        {
+            len = buildFrame(false, state.lastSent);
+            builtSince = state.lastSent;
+            built = true;
+        }
+        if (len == 0)
+        {
+            continue;
+        }
+        client->text(frame, len);
+        state.lastSent = seq;
+    }
+}
+
+bool LivePush::pollFields()
+{
+    const uint32_t nextSeq = seq + 1;
+    bool changed = false;
+    for (size_t i = 0; i < fieldCount; ++i)
+    {
+        Field &field = fields[i];
+        const int32_t scaled = scale(field.getter(), field.precision);
+        if (scaled != field.lastScaled)
+        {
+            field.lastScaled = scaled;
+            field.version = nextSeq;
+            changed = true;
+        }
+    }
+    if (changed)
+    {
+        seq = nextSeq;
+    }
+    return changed;
+}
+
+size_t LivePush::buildFrame(bool full, uint32_t since)
+{
+    int written = snprintf(frame, sizeof(frame), full ? "{\"v\":%lu,\"full\":1,\"d\":{" : "{\"v\":%lu,\"d\":{",
+                           static_cast<unsigned long>(seq));
+    if (written < 0 || static_cast<size_t>(written) >= sizeof(frame))
+    {
+        return 0;
+    }
+    size_t pos = static_cast<size_t>(written);
+
+    bool first = true;
+    for (size_t i = 0; i < fieldCount; ++i)
+    {
+        const Field &field = fields[i];
+        if (!full && field.version <= since)
+        {
+            continue;
+        }
+
+        const int32_t divisor = POW10[field.precision];
+        const int32_t whole = field.lastScaled / divisor;
+        const int32_t frac = abs(field.lastScaled % divisor);
+        const char *sign = (field.lastScaled < 0 && whole == 0) ? "-" : "";
+        if (field.precision == 0)
+        {
+            written = snprintf(frame + pos, sizeof(frame) - pos, "%s\"%s\":%ld", first ? "" : ",", field.key,
+                               static_cast<long>(whole));
+        }
+        else
+        {
+            written = snprintf(frame + pos, sizeof(frame) - pos, "%s\"%s\":%s%ld.%0*ld", first ? "" : ",", field.key, sign,
+                               static_cast<long>(whole), static_cast<int>(field.precision), static_cast<long>(frac));
+        }
+        if (written < 0 || static_cast<size_t>(written) >= sizeof(frame) - pos)
+        {
+            return 0;
+        }
+        pos += static_cast<size_t>(written);
+        first = false;
+    }
+
+    if (pos + 3 > sizeof(frame))
+    {
+        return 0;
+    }
+    frame[pos++] = '}';
+    frame[pos++] = '}';
+    frame[pos] = '\0';
+    return pos;
+}
+
+void LivePush::sendPendingSnapshots()
+{
+    uint32_t ids[MAX_PENDING_SNAPSHOTS];
+    size_t count = 0;
+
+    portENTER_CRITICAL(&pendingMux);
+    count = pendingCount;
+    memcpy(ids, pendingSnapshots, count * sizeof(ids[0]));
+    pendingCount = 0;
+    portEXIT_CRITICAL(&pendingMux);
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    const size_t len = buildFrame(true, 0);
+    if (len == 0)
+    {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        AsyncWebSocketClient *client = ws.client(ids[i]);
+        if (client == nullptr || client->status() != WS_CONNECTED)
+        {
+            continue;
+        }
+        if (trackedClients >= LIVE_PUSH_MAX_CLIENTS)
+        {
+            client->close(); // could not be kept up to date
+            continue;
+        }
+        if (!client->canSend())
+        {
+            // Retried on the next update.
+            if (!queueSnapshot(ids[i]))
+            {
+                client->close();
+            }
+            continue;
+        }
+        client->text(frame, len);
+        clients[trackedClients].id = ids[i];
+        clients[trackedClients].lastSent = seq;
+        ++trackedClients;
+    }
+}
+
+int32_t LivePush::scale(float value, uint8_t precision)
+{
+    if (!isfinite(value))
+    {
+        return 0;
+    }
+    return static_cast<int32_t>(lroundf(value * static_cast<float>(POW10[precision])));
+}
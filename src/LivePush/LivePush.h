@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Arduino.h>
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+
+#ifndef LIVE_PUSH_MAX_FIELDS
+#define LIVE_PUSH_MAX_FIELDS 16
+#endif
+
+#ifndef LIVE_PUSH_MAX_CLIENTS
+#define LIVE_PUSH_MAX_CLIENTS 8
+#endif
+
+#ifndef LIVE_PUSH_INTERVAL_MS
+#define LIVE_PUSH_INTERVAL_MS 500UL
+#endif
+
+// Delta-only live value transport over a WebSocket.
+// Each registered field keeps its last published value (scaled to its precision)
+// and the sequence number of its last change. Every interval, each client gets the fields
+// that changed since the last frame queued for it:
+//   {"v":42,"d":{"gridIn":-120,"temp":21.5}}
+// A client whose send queue is full is skipped and stays at its last sequence, so its next
+// delta also carries the changes it missed. Clients at the same sequence share one
+// serialization. A client receives a full snapshot ({"v":42,"full":1,"d":{...}}) only when
+// it connects. Nothing is polled or serialized while no client is connected.
+class LivePush
+{
+public:
+    using Getter = float (*)();
+
+    explicit LivePush(const char *path);
+
+    // Registers a field. key must point to static storage. Returns false when the table is full.
+    bool addField(const char *key, Getter getter, uint8_t precision = 0);
+
+    void begin(AsyncWebServer &server);
+    void update();
+
+    uint32_t sequence() const { return seq; }
+    size_t clientCount() { return ws.count(); }
+
+private:
+    struct Field
+    {
+        const char *key = nullptr;
+        Getter getter = nullptr;
+        uint8_t precision = 0;
+        int32_t lastScaled = 0;
+        uint32_t version = 0; // sequence number of the last change
+    };
+
+    struct ClientState
+    {
+        uint32_t id = 0;
+        uint32_t lastSent = 0; // sequence of the last frame queued for this client
+    };
+
+    // One slot per client: a connect that still finds the queue full is closed, so the browser reconnects.
+    static constexpr size_t MAX_PENDING_SNAPSHOTS = LIVE_PUSH_MAX_CLIENTS;
+    static constexpr size_t FRAME_BUFFER_SIZE = 48 + LIVE_PUSH_MAX_FIELDS * 28;
+
+    AsyncWebSocket ws;
+    Field fields[LIVE_PUSH_MAX_FIELDS];
+    size_t fieldCount = 0;
+    ClientState clients[LIVE_PUSH_MAX_CLIENTS];
+    size_t trackedClients = 0;
+    uint32_t seq = 0;
+    unsigned long nextPollMs = 0;
+
+    portMUX_TYPE pendingMux = portMUX_INITIALIZER_UNLOCKED;
+    uint32_t pendingSnapshots[MAX_PENDING_SNAPSHOTS] = {};
+    size_t pendingCount = 0;
+
+    char frame[FRAME_BUFFER_SIZE];
+
+    void onEvent(AsyncWebSocketClient *client, AwsEventType type);
+    bool queueSnapshot(uint32_t id);
+    bool pollFields();
+    size_t buildFrame(bool full, uint32_t since);
+    void sendPendingSnapshots();
+    void sendDeltas();
+    static int32_t scale(float value, uint8_t precision);
+};
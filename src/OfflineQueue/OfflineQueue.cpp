@@ -0,0 +1,175 @@
+#include "OfflineQueue.h"
+
+#include <stdio.h>
+
+namespace
+{
+constexpr size_t JSON_OVERHEAD = 40;         // keys, brackets and terminator
+constexpr size_t JSON_BYTES_PER_SAMPLE = 40; // 4 columns, worst case "-32768," / "4294967295,"
+
+int16_t clampToInt16(int value)
+{
+    if (value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return static_cast<int16_t>(value);
+}
+
+bool appendf(char *out, size_t outSize, size_t &pos, const char *fmt, long value)
+{
+    const int written = snprintf(out + pos, outSize - pos, fmt, value);
+    if (written < 0 || static_cast<size_t>(written) >= outSize - pos)
+    {
+        return false;
+    }
+    pos += static_cast<size_t>(written);
+    return true;
+}
+} // namespace
+
+void OfflineQueue::record(uint32_t uptimeSec, int setW, int calcW, int gridW)
+{
+    if (count > 0 && (uptimeSec - lastRecordSec) < recordPeriodSec)
+    {
+        return;
+    }
+
+    if (count == CAPACITY)
+    {
+        downsample();
+    }
+
+    OfflineSample &slot = samples[(head + count) % CAPACITY];
+    slot.uptimeSec = uptimeSec;
+    slot.setW = clampToInt16(setW);
+    slot.calcW = clampToInt16(calcW);
+    slot.gridW = clampToInt16(gridW);
+    ++count;
+    lastRecordSec = uptimeSec;
+}
+
+size_t OfflineQueue::buildBatch(char *out, size_t outSize, size_t maxSamples, uint32_t uptimeNowSec, uint32_t epochNow) const
+{
+    if (out == nullptr || outSize <= JSON_OVERHEAD + JSON_BYTES_PER_SAMPLE || count == 0)
+    {
+        return 0;
+    }
+
+    size_t n = count < maxSamples ? count : maxSamples;
+    const size_t fits = (outSize - JSON_OVERHEAD) / JSON_BYTES_PER_SAMPLE;
+    if (n > fits)
+    {
+        n = fits;
+    }
+
+    const bool absolute = epochNow > 0;
+    size_t pos = 0;
+    for (int column = 0; column < 4; ++column)
+    {
+        static const char *const keys[] = {"t", "set", "calc", "grid"};
+        const char *key = (column == 0 && !absolute) ? "age" : keys[column];
+        const int written = snprintf(out + pos, outSize - pos, "%s\"%s\":[", column == 0 ? "{" : "],", key);
+        if (written < 0 || static_cast<size_t>(written) >= outSize - pos)
+        {
+            return 0;
+        }
+        pos += static_cast<size_t>(written);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const OfflineSample &s = at(i);
+            long value = 0;
+            switch (column)
+            {
+            case 0:
+            {
+                const uint32_t age = uptimeNowSec - s.uptimeSec;
+                value = absolute ? static_cast<long>(epochNow - age) : static_cast<long>(age);
+                break;
+            }
+            case 1:
+                value = s.setW;
+                break;
+            case 2:
+                value = s.calcW;
+                break;
+            default:
+                value = s.gridW;
+                break;
+            }
+            if (!appendf(out, outSize, pos, i == 0 ? "%ld" : ",%ld", value))
+            {
+                return 0;
+            }
+        }
+    }
+
+    if (pos + 3 > outSize)
+    {
+        return 0;
+    }
+    out[pos++] = ']';
+    out[pos++] = '}';
+    out[pos] = '\0';
+    return n;
+}
+
+void OfflineQueue::drop(size_t dropCount)
+{
+    if (dropCount >= count)
+    {
+        clear();
+        return;
+    }
+    head = (head + dropCount) % CAPACITY;
+    count -= dropCount;
+}
+
+void OfflineQueue::clear()
+{
+    head = 0;
+    count = 0;
+    recordPeriodSec = OFFLINE_QUEUE_BASE_PERIOD_S;
+}
+
+const OfflineSample &OfflineQueue::at(size_t logicalIndex) const
+{
+    return samples[(head + logicalIndex) % CAPACITY];
+}
+
+void OfflineQueue::downsample()
+{
+    // Merge neighbouring pairs in place: sample i becomes the average of 2i and 2i+1.
+    // The merged sample keeps the timestamp of the older sample of the pair.
+    const size_t merged = count / 2;
+    for (size_t i = 0; i < merged; ++i)
+    {
+        const OfflineSample a = at(2 * i);
+        const OfflineSample b = at(2 * i + 1);
+        OfflineSample &dst = samples[(head + i) % CAPACITY];
+        dst.uptimeSec = a.uptimeSec;
+        dst.setW = static_cast<int16_t>((static_cast<int32_t>(a.setW) + b.setW) / 2);
+        dst.calcW = static_cast<int16_t>((static_cast<int32_t>(a.calcW) + b.calcW) / 2);
+        dst.gridW = static_cast<int16_t>((static_cast<int32_t>(a.gridW) + b.gridW) / 2);
+    }
+    if (count % 2 != 0)
+    {
+        samples[(head + merged) % CAPACITY] = at(count - 1);
+    }
+    count = merged + (count % 2);
+    ++mergeCount;
+
+    if (recordPeriodSec < OFFLINE_QUEUE_MAX_PERIOD_S)
+    {
+        recordPeriodSec *= 2;
+        if (recordPeriodSec > OFFLINE_QUEUE_MAX_PERIOD_S)
+        {
+            recordPeriodSec = OFFLINE_QUEUE_MAX_PERIOD_S;
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Compile-time capacity of the offline publish queue (samples).
+// Each sample is 10 bytes, so the default costs 2.4 KB of static RAM.
+#ifndef OFFLINE_QUEUE_CAPACITY
+#define OFFLINE_QUEUE_CAPACITY 240
+#endif
+
+// Initial spacing between recorded samples while offline (seconds).
+#ifndef OFFLINE_QUEUE_BASE_PERIOD_S
+#define OFFLINE_QUEUE_BASE_PERIOD_S 10
+#endif
+
+// Upper bound for the sample spacing after repeated downsampling (seconds).
+#ifndef OFFLINE_QUEUE_MAX_PERIOD_S
+#define OFFLINE_QUEUE_MAX_PERIOD_S 3600
+#endif
+
+#pragma pack(push, 1)
+struct OfflineSample
+{
+    uint32_t uptimeSec = 0; // seconds since boot when the sample was taken
+    int16_t setW = 0;       // inverter setpoint
+    int16_t calcW = 0;      // calculated controller output
+    int16_t gridW = 0;      // signed grid power (positive import)
+};
+#pragma pack(pop)
+
+static_assert(sizeof(OfflineSample) == 10, "OfflineSample must stay compact");
+
+// Fixed-size queue of state samples taken while MQTT is offline.
+// When the queue is full, neighbouring samples are merged pairwise and the
+// record period doubles, so a long outage keeps its full time span at a
+// coarser resolution instead of dropping the oldest data.
+class OfflineQueue
+{
+public:
+    static constexpr size_t CAPACITY = OFFLINE_QUEUE_CAPACITY;
+
+    // Records a sample if the current record period has elapsed since the last one.
+    void record(uint32_t uptimeSec, int setW, int calcW, int gridW);
+
+    // Serializes up to maxSamples of the oldest samples as a columnar JSON object into out.
+    // When epochNow is valid (> 0) absolute timestamps are emitted ("t"), otherwise
+    // sample ages in seconds ("age"). Returns the number of samples written (0 if none fit).
+    size_t buildBatch(char *out, size_t outSize, size_t maxSamples, uint32_t uptimeNowSec, uint32_t epochNow) const;
+
+    // Removes the count oldest samples (after a successful publish).
+    void drop(size_t count);
+
+    void clear();
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    uint32_t periodSec() const { return recordPeriodSec; }
+    uint32_t downsampleCount() const { return mergeCount; }
+
+private:
+    OfflineSample samples[CAPACITY];
+    size_t head = 0;
+    size_t count = 0;
+    uint32_t recordPeriodSec = OFFLINE_QUEUE_BASE_PERIOD_S;
+    uint32_t lastRecordSec = 0;
+    uint32_t mergeCount = 0;
+
+    const OfflineSample &at(size_t logicalIndex) const;
+    void downsample();
+};
@@ -0,0 +1,297 @@
+#include "OledText.h"
+
+#include <string.h>
+
+#include "OledFont5x7.h"
+
+namespace
+{
+// Dirty cells closer than this are sent as one run; each run costs a
+// 6-byte addressing command on the bus, so short gaps are cheaper to resend.
+constexpr uint8_t RUN_MERGE_GAP_CELLS = 1;
+constexpr uint8_t TEXT_X_OFFSET = (OLED_COLUMNS - OLED_TEXT_COLS * OLED_CELL_WIDTH) / 2;
+constexpr uint32_t ALL_CELLS = (1UL << OLED_TEXT_COLS) - 1UL;
+
+const uint8_t *glyphFor(char c)
+{
+    uint8_t code = static_cast<uint8_t>(c);
+    if (code < OLED_FONT_FIRST || code > OLED_FONT_LAST)
+    {
+        code = '?';
+    }
+    return &OLED_FONT_5X7[(code - OLED_FONT_FIRST) * OLED_FONT_WIDTH];
+}
+} // namespace
+
+OledTextCanvas::OledTextCanvas()
+{
+    memset(cells, ' ', sizeof(cells));
+    memset(dirtyCells, 0, sizeof(dirtyCells));
+}
+
+void OledTextCanvas::setCell(uint8_t row, uint8_t col, char c)
+{
+    if (cells[row][col] == c)
+    {
+        return;
+    }
+    cells[row][col] = c;
+    dirtyCells[row] |= (1UL << col);
+}
+
+void OledTextCanvas::setLine(uint8_t row, const char *text)
+{
+    if (row >= OLED_TEXT_ROWS)
+    {
+        return;
+    }
+    uint8_t col = 0;
+    while (text != nullptr && text[col] != '\0' && col < OLED_TEXT_COLS)
+    {
+        setCell(row, col, text[col]);
+        ++col;
+    }
+    for (; col < OLED_TEXT_COLS; ++col)
+    {
+        setCell(row, col, ' ');
+    }
+}
+
+void OledTextCanvas::print(uint8_t row, uint8_t col, const char *text)
+{
+    if (row >= OLED_TEXT_ROWS || text == nullptr)
+    {
+        return;
+    }
+    for (; *text != '\0' && col < OLED_TEXT_COLS; ++text, ++col)
+    {
+        setCell(row, col, *text);
+    }
+}
+
+void OledTextCanvas::clear()
+{
+    for (uint8_t row = 0; row < OLED_TEXT_ROWS; ++row)
+    {
+        setLine(row, nullptr);
+    }
+}
+
+void OledTextCanvas::setFrame(uint8_t rows)
+{
+    if (rows > OLED_TEXT_ROWS)
+    {
+        rows = OLED_TEXT_ROWS;
+    }
+    if (rows != frameRows)
+    {
+        frameRows = rows;
+        fullRedraw = true;
+    }
+}
+
+void OledTextCanvas::invalidate()
+{
+    fullRedraw = true;
+}
+
+bool OledTextCanvas::dirty() const
+{
+    if (fullRedraw)
+    {
+        return true;
+    }
+    for (uint8_t row = 0; row < OLED_TEXT_ROWS; ++row)
+    {
+        if (dirtyCells[row] != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint8_t OledTextCanvas::frameMask(uint8_t page) const
+{
+    if (page >= frameRows)
+    {
+        return 0;
+    }
+    uint8_t mask = 0;
+    if (page == 0)
+    {
+        mask |= 0x01;
+    }
+    if (page == frameRows - 1)
+    {
+        mask |= 0x80;
+    }
+    return mask;
+}
+
+uint8_t OledTextCanvas::edgeColumn(uint8_t page) const
+{
+    return page < frameRows ? 0xFF : 0x00;
+}
+
+void OledTextCanvas::renderCell(uint8_t page, uint8_t col, uint8_t *out) const
+{
+    const uint8_t *glyph = glyphFor(cells[page][col]);
+    const bool framed = page < frameRows;
+    const uint8_t mask = frameMask(page);
+    for (uint8_t i = 0; i < OLED_FONT_WIDTH; ++i)
+    {
+        const uint8_t bits = framed ? static_cast<uint8_t>(glyph[i] << 1) : glyph[i];
+        out[i] = bits | mask;
+    }
+    out[OLED_FONT_WIDTH] = mask; // 1 px gap between glyphs
+}
+
+bool OledTextCanvas::flushPage(OledSink &sink, uint8_t page)
+{
+    uint8_t line[OLED_COLUMNS];
+    const uint8_t edge = edgeColumn(page);
+    const uint8_t mask = frameMask(page);
+    for (uint8_t x = 0; x < TEXT_X_OFFSET; ++x)
+    {
+        line[x] = x == 0 ? edge : mask;
+    }
+    for (uint8_t col = 0; col < OLED_TEXT_COLS; ++col)
+    {
+        renderCell(page, col, &line[TEXT_X_OFFSET + col * OLED_CELL_WIDTH]);
+    }
+    for (uint8_t x = TEXT_X_OFFSET + OLED_TEXT_COLS * OLED_CELL_WIDTH; x < OLED_COLUMNS; ++x)
+    {
+        line[x] = x == OLED_COLUMNS - 1 ? edge : mask;
+    }
+    if (!sink.writeColumns(page, 0, line, OLED_COLUMNS))
+    {
+        return false;
+    }
+    totalBytes += OLED_COLUMNS;
+    return true;
+}
+
+bool OledTextCanvas::flushRun(OledSink &sink, uint8_t page, uint8_t firstCol, uint8_t lastCol)
+{
+    uint8_t run[OLED_TEXT_COLS * OLED_CELL_WIDTH];
+    size_t len = 0;
+    for (uint8_t col = firstCol; col <= lastCol; ++col)
+    {
+        renderCell(page, col, &run[len]);
+        len += OLED_CELL_WIDTH;
+    }
+    const uint8_t x = static_cast<uint8_t>(TEXT_X_OFFSET + firstCol * OLED_CELL_WIDTH);
+    if (!sink.writeColumns(page, x, run, len))
+    {
+        return false;
+    }
+    totalBytes += len;
+    return true;
+}
+
+int OledTextCanvas::flush(OledSink &sink)
+{
+    const uint32_t before = totalBytes;
+
+    if (fullRedraw)
+    {
+        for (uint8_t page = 0; page < OLED_PAGES; ++page)
+        {
+            if (!flushPage(sink, page))
+            {
+                return -1;
+            }
+        }
+        fullRedraw = false;
+        memset(dirtyCells, 0, sizeof(dirtyCells));
+        return static_cast<int>(totalBytes - before);
+    }
+
+    for (uint8_t page = 0; page < OLED_PAGES; ++page)
+    {
+        uint32_t bits = dirtyCells[page] & ALL_CELLS;
+        while (bits != 0)
+        {
+            uint8_t first = 0;
+            while (!(bits & (1UL << first)))
+            {
+                ++first;
+            }
+            uint8_t last = first;
+            uint8_t gap = 0;
+            for (uint8_t col = first + 1; col < OLED_TEXT_COLS; ++col)
+            {
+                if (bits & (1UL << col))
+                {
+                    last = col;
+                    gap = 0;
+                }
+                else if (++gap > RUN_MERGE_GAP_CELLS)
+                {
+                    break;
+                }
+            }
+            if (!flushRun(sink, page, first, last))
+            {
+                return -1;
+            }
+            const uint32_t sent = ((1UL << (last + 1)) - 1UL) & ~((1UL << first) - 1UL);
+            bits &= ~sent;
+            dirtyCells[page] &= ~sent;
+        }
+    }
+    return static_cast<int>(totalBytes - before);
+}
+
+OledFramebufferSink::OledFramebufferSink()
+{
+    memset(ram, 0, sizeof(ram));
+}
+
+bool OledFramebufferSink::writeColumns(uint8_t page, uint8_t x, const uint8_t *columns, size_t count)
+{
+    if (page >= OLED_PAGES || x >= OLED_COLUMNS || count > static_cast<size_t>(OLED_COLUMNS - x))
+    {
+        return false;
+    }
+    memcpy(&ram[page][x], columns, count);
+    ++writeCalls;
+    bytesWritten += count;
+    return true;
+}
+
+bool OledFramebufferSink::setPower(bool on)
+{
+    poweredOn = on;
+    return true;
+}
+
+bool OledFramebufferSink::pixel(uint8_t x, uint8_t y) const
+{
+    if (x >= OLED_COLUMNS || y >= OLED_PAGES * 8)
+    {
+        return false;
+    }
+    return (ram[y / 8][x] >> (y % 8)) & 0x01;
+}
+
+size_t OledFramebufferSink::dumpAscii(char *out, size_t outSize) const
+{
+    const size_t needed = static_cast<size_t>(OLED_PAGES * 8) * (OLED_COLUMNS + 1) + 1;
+    if (out == nullptr || outSize < needed)
+    {
+        return 0;
+    }
+    size_t pos = 0;
+    for (uint8_t y = 0; y < OLED_PAGES * 8; ++y)
+    {
+        for (uint8_t x = 0; x < OLED_COLUMNS; ++x)
+        {
+            out[pos++] = pixel(x, y) ? '#' : '.';
+        }
+        out[pos++] = '\n';
+    }
+    out[pos] = '\0';
+    return pos;
+}
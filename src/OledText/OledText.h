@@ -0,0 +1,97 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Text-mode renderer for 128x32 SSD1306 panels.
+// The screen is a grid of 6 px wide character cells on the four 8 px pages.
+// Only cells whose character changed since the last flush are sent to the sink,
+// so a one-digit change costs a 6-byte column run instead of a 512-byte frame.
+// Rendering is portable; the panel itself is hidden behind OledSink so the
+// same canvas can draw into a host framebuffer (OledFramebufferSink).
+
+static constexpr uint8_t OLED_COLUMNS = 128;
+static constexpr uint8_t OLED_PAGES = 4;
+static constexpr uint8_t OLED_CELL_WIDTH = 6;
+static constexpr uint8_t OLED_TEXT_COLS = 21; // 21 * 6 = 126 px, 1 px margin each side
+static constexpr uint8_t OLED_TEXT_ROWS = OLED_PAGES;
+
+// Destination for rendered column bytes (bit 0 = top pixel of the page).
+class OledSink
+{
+public:
+    virtual ~OledSink() = default;
+
+    // Writes count column bytes into page starting at column x.
+    virtual bool writeColumns(uint8_t page, uint8_t x, const uint8_t *columns, size_t count) = 0;
+
+    // Switches the panel on or off; GDDRAM content is kept.
+    virtual bool setPower(bool on) = 0;
+};
+
+class OledTextCanvas
+{
+public:
+    OledTextCanvas();
+
+    // Replaces the whole row; text is truncated or padded with spaces to the row width.
+    void setLine(uint8_t row, const char *text);
+
+    // Writes text starting at col without touching the rest of the row.
+    void print(uint8_t row, uint8_t col, const char *text);
+
+    void clear();
+
+    // Draws a rectangle around the first frameRows text rows (0 disables the frame).
+    // Text inside the frame is moved down by one pixel; descenders lose their last row.
+    void setFrame(uint8_t frameRows);
+
+    // Forces the next flush to resend all pages (after panel init or reset).
+    void invalidate();
+
+    // Sends the dirty cells to the sink. Returns the number of column bytes written,
+    // or -1 if the sink reported an error (dirty state is kept for the next attempt).
+    int flush(OledSink &sink);
+
+    bool dirty() const;
+    uint32_t bytesSent() const { return totalBytes; }
+
+private:
+    char cells[OLED_TEXT_ROWS][OLED_TEXT_COLS];
+    uint32_t dirtyCells[OLED_TEXT_ROWS]; // bit n = column n changed
+    bool fullRedraw = true;
+    uint8_t frameRows = 0;
+    uint32_t totalBytes = 0;
+
+    void setCell(uint8_t row, uint8_t col, char c);
+    uint8_t frameMask(uint8_t page) const;
+    uint8_t edgeColumn(uint8_t page) const;
+    void renderCell(uint8_t page, uint8_t col, uint8_t *out) const;
+    bool flushPage(OledSink &sink, uint8_t page);
+    bool flushRun(OledSink &sink, uint8_t page, uint8_t firstCol, uint8_t lastCol);
+};
+
+// In-memory panel for host rendering checks: keeps the same page layout as the
+// SSD1306 GDDRAM and can dump it as ASCII art ('#' = lit pixel).
+class OledFramebufferSink : public OledSink
+{
+public:
+    OledFramebufferSink();
+
+    bool writeColumns(uint8_t page, uint8_t x, const uint8_t *columns, size_t count) override;
+    bool setPower(bool on) override;
+
+    bool pixel(uint8_t x, uint8_t y) const;
+    bool powered() const { return poweredOn; }
+    const uint8_t *pageData(uint8_t page) const { return ram[page]; }
+
+    // Writes 32 lines of 128 characters plus newlines; out needs 32 * 129 + 1 bytes.
+    size_t dumpAscii(char *out, size_t outSize) const;
+
+    size_t writeCalls = 0;
+    size_t bytesWritten = 0;
+
+private:
+    uint8_t ram[OLED_PAGES][OLED_COLUMNS];
+    bool poweredOn = false;
+};
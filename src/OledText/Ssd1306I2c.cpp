@@ -0,0 +1,147 @@
+#include "Ssd1306I2c.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace
+{
+constexpr uint8_t CONTROL_COMMAND = 0x00;
+constexpr uint8_t CONTROL_DATA = 0x40;
+
+constexpr uint8_t CMD_DISPLAY_OFF = 0xAE;
+constexpr uint8_t CMD_DISPLAY_ON = 0xAF;
+constexpr uint8_t CMD_COLUMN_ADDR = 0x21;
+constexpr uint8_t CMD_PAGE_ADDR = 0x22;
+
+const uint8_t INIT_SEQUENCE[] = {
+    CONTROL_COMMAND,
+    CMD_DISPLAY_OFF,
+    0xD5, 0x80, // clock divide ratio / oscillator
+    0xA8, 0x1F, // multiplex ratio: 32 rows
+    0xD3, 0x00, // display offset
+    0x40,       // start line 0
+    0x8D, 0x14, // charge pump on
+    0x20, 0x00, // horizontal addressing mode
+    0xA1,       // segment remap (column 127 -> SEG0)
+    0xC8,       // COM scan direction remapped
+    0xDA, 0x02, // COM pins: sequential, no remap (128x32)
+    0x81, 0x8F, // contrast
+    0xD9, 0xF1, // pre-charge period
+    0xDB, 0x40, // VCOMH deselect level
+    0xA4,       // resume to RAM content
+    0xA6,       // normal (not inverted)
+    0x2E,       // deactivate scroll
+};
+
+static_assert(sizeof(INIT_SEQUENCE) <= I2C_BUS_MAX_PAYLOAD, "init sequence must fit one transaction");
+
+size_t chunksFor(size_t count)
+{
+    return (count + SSD1306_I2C_CHUNK_BYTES - 1) / SSD1306_I2C_CHUNK_BYTES;
+}
+} // namespace
+
+bool Ssd1306I2cSink::begin(uint8_t address)
+{
+    device = bus.addDevice("oled", address);
+    if (device < 0)
+    {
+        return false;
+    }
+
+    if (!bus.transferNow(device, nullptr, 0) ||
+        !bus.transferNow(device, INIT_SEQUENCE, sizeof(INIT_SEQUENCE)))
+    {
+        return false;
+    }
+
+    // GDDRAM content is undefined after power-up; blank it before switching on.
+    const uint8_t window[] = {CONTROL_COMMAND, CMD_COLUMN_ADDR, 0, OLED_COLUMNS - 1, CMD_PAGE_ADDR, 0, OLED_PAGES - 1};
+    if (!bus.transferNow(device, window, sizeof(window)))
+    {
+        return false;
+    }
+    uint8_t blank[I2C_BUS_MAX_PAYLOAD] = {CONTROL_DATA};
+    for (size_t remaining = OLED_COLUMNS * OLED_PAGES; remaining > 0;)
+    {
+        const size_t len = std::min(remaining, SSD1306_I2C_CHUNK_BYTES);
+        if (!bus.transferNow(device, blank, len + 1))
+        {
+            return false;
+        }
+        remaining -= len;
+    }
+
+    const uint8_t on[] = {CONTROL_COMMAND, CMD_DISPLAY_ON};
+    return bus.transferNow(device, on, sizeof(on));
+}
+
+bool Ssd1306I2cSink::writeColumns(uint8_t page, uint8_t x, const uint8_t *columns, size_t count)
+{
+    if (device < 0 || count == 0 || page >= OLED_PAGES || x >= OLED_COLUMNS || count > static_cast<size_t>(OLED_COLUMNS - x))
+    {
+        return false;
+    }
+    if (bus.freeSlots() < 1 + chunksFor(count))
+    {
+        return false;
+    }
+
+    const uint8_t window[] = {
+        CMD_COLUMN_ADDR, x, static_cast<uint8_t>(x + count - 1),
+        CMD_PAGE_ADDR, page, page,
+    };
+    if (!queueCommands(window, sizeof(window)))
+    {
+        return false;
+    }
+
+    uint8_t chunk[I2C_BUS_MAX_PAYLOAD];
+    chunk[0] = CONTROL_DATA;
+    while (count > 0)
+    {
+        const size_t len = std::min(count, SSD1306_I2C_CHUNK_BYTES);
+        memcpy(&chunk[1], columns, len);
+        if (!bus.write(device, chunk, len + 1, onTransferDone, this))
+        {
+            redrawRequested = true;
+            return false;
+        }
+        columns += len;
+        count -= len;
+    }
+    return true;
+}
+
+bool Ssd1306I2cSink::setPower(bool on)
+{
+    const uint8_t cmd = on ? CMD_DISPLAY_ON : CMD_DISPLAY_OFF;
+    return queueCommands(&cmd, 1);
+}
+
+bool Ssd1306I2cSink::takeRedrawRequest()
+{
+    const bool requested = redrawRequested;
+    redrawRequested = false;
+    return requested;
+}
+
+void Ssd1306I2cSink::onTransferDone(void *ctx, bool ok, const uint8_t *, size_t)
+{
+    if (!ok)
+    {
+        static_cast<Ssd1306I2cSink *>(ctx)->redrawRequested = true;
+    }
+}
+
+bool Ssd1306I2cSink::queueCommands(const uint8_t *cmds, size_t count)
+{
+    if (device < 0 || count > SSD1306_I2C_CHUNK_BYTES)
+    {
+        return false;
+    }
+    uint8_t buffer[I2C_BUS_MAX_PAYLOAD];
+    buffer[0] = CONTROL_COMMAND;
+    memcpy(&buffer[1], cmds, count);
+    return bus.write(device, buffer, count + 1, onTransferDone, this);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "I2CBus/I2CBus.h"
+#include "OledText.h"
+
+// Data bytes per I2C transaction; one more byte is used for the control byte.
+static constexpr size_t SSD1306_I2C_CHUNK_BYTES = I2C_BUS_MAX_PAYLOAD - 1;
+
+// SSD1306 128x32 panel on the shared I2C bus, charge pump enabled, horizontal addressing.
+// Column runs are written by setting the column/page window first, so a
+// partial update only transfers the changed bytes. Writes are queued on the
+// bus; a failed transfer sets a redraw request so the caller can resend everything.
+class Ssd1306I2cSink : public OledSink
+{
+public:
+    explicit Ssd1306I2cSink(I2CBus &bus) : bus(bus) {}
+
+    // Probes the address and sends the init sequence (blocking, setup only).
+    // Returns false if the panel does not ACK.
+    bool begin(uint8_t address);
+
+    // Returns false without queueing anything if the bus queue cannot take the whole run.
+    bool writeColumns(uint8_t page, uint8_t x, const uint8_t *columns, size_t count) override;
+    bool setPower(bool on) override;
+
+    // True once after a queued transfer failed; GDDRAM content is unknown then.
+    bool takeRedrawRequest();
+
+    int deviceId() const { return device; }
+
+private:
+    I2CBus &bus;
+    int device = -1;
+    bool redrawRequested = false;
+
+    static void onTransferDone(void *ctx, bool ok, const uint8_t *rx, size_t rxLen);
+    bool queueCommands(const uint8_t *cmds, size_t count);
+};
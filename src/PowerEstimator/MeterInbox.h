@@ -0,0 +1,31 @@
+#pragma once
+
+#include <limits.h>
+
+// Receive slot for one MQTT meter value (mqtt.addTopicReceiveInt writes into slot()).
+// The library only writes the slot when a message arrives; take() hands the value out once
+// and empties the slot again. So every message is one reading, also when it repeats the
+// previous value, and nothing is taken before the first message (no power-on zeros).
+// Not locked: the library and take() both run on the loop task (inside and after mqtt.loop()).
+class MeterInbox
+{
+public:
+    static constexpr int EMPTY = INT_MIN;
+
+    int *slot() { return &raw; }
+
+    // Returns true and the value when a message arrived since the last take().
+    bool take(int &value)
+    {
+        if (raw == EMPTY)
+        {
+            return false;
+        }
+        value = raw;
+        raw = EMPTY;
+        return true;
+    }
+
+private:
+    int raw = EMPTY;
+};
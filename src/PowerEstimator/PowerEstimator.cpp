@@ -0,0 +1,146 @@
+#include "PowerEstimator.h"
+
+#include <math.h>
+
+namespace
+{
+constexpr float LOAD_Q = POWER_ESTIMATOR_LOAD_DRIFT_W * POWER_ESTIMATOR_LOAD_DRIFT_W;       // W^2 per s
+constexpr float OUTPUT_Q = POWER_ESTIMATOR_OUTPUT_DRIFT_W * POWER_ESTIMATOR_OUTPUT_DRIFT_W; // W^2 per s
+constexpr float GRID_R = POWER_ESTIMATOR_GRID_NOISE_W * POWER_ESTIMATOR_GRID_NOISE_W;
+constexpr float SOLAR_R = POWER_ESTIMATOR_SOLAR_NOISE_W * POWER_ESTIMATOR_SOLAR_NOISE_W;
+constexpr float MAX_VAR = POWER_ESTIMATOR_MAX_STD_W * POWER_ESTIMATOR_MAX_STD_W;
+
+int roundW(float value)
+{
+    return static_cast<int>(lroundf(value));
+}
+} // namespace
+
+void PowerEstimator::reset()
+{
+    *this = PowerEstimator();
+}
+
+void PowerEstimator::updateGrid(int gridW, uint32_t nowMs)
+{
+    ++gridCount;
+    if (!initialized)
+    {
+        firstGridW = gridW;
+        haveGrid = true;
+        tryInitialize(nowMs);
+        return;
+    }
+    advance(nowMs);
+    correct(static_cast<float>(gridW) - (state.load - state.output), 1.0f, -1.0f, GRID_R);
+}
+
+void PowerEstimator::updateSolar(int solarW, uint32_t nowMs)
+{
+    ++solarCount;
+    if (!initialized)
+    {
+        firstSolarW = solarW;
+        haveSolar = true;
+        tryInitialize(nowMs);
+        return;
+    }
+    advance(nowMs);
+    correct(static_cast<float>(solarW) - state.output, 0.0f, 1.0f, SOLAR_R);
+}
+
+void PowerEstimator::setCommand(int setW, uint32_t nowMs)
+{
+    if (initialized)
+    {
+        advance(nowMs); // the old setpoint applied up to now
+    }
+    commandW = setW;
+}
+
+PowerEstimate PowerEstimator::estimate(uint32_t nowMs) const
+{
+    PowerEstimate result;
+    if (!initialized)
+    {
+        return result;
+    }
+    State s = state;
+    const uint32_t dtMs = nowMs - stateMs;
+    if (dtMs < 0x80000000UL)
+    {
+        predict(s, dtMs);
+    }
+    result.loadW = roundW(s.load);
+    result.outputW = roundW(s.output);
+    result.gridW = result.loadW - result.outputW;
+    result.loadStdW = sqrtf(s.pLL);
+    result.outputStdW = sqrtf(s.pOO);
+    return result;
+}
+
+void PowerEstimator::tryInitialize(uint32_t nowMs)
+{
+    if (!haveGrid || !haveSolar)
+    {
+        return;
+    }
+    // load = grid + solar, so it carries both reading errors and shares the solar one with the output.
+    state.output = static_cast<float>(firstSolarW < 0 ? 0 : firstSolarW);
+    state.load = static_cast<float>(firstGridW) + state.output;
+    state.pOO = SOLAR_R;
+    state.pLO = SOLAR_R;
+    state.pLL = GRID_R + SOLAR_R;
+    stateMs = nowMs;
+    initialized = true;
+}
+
+void PowerEstimator::advance(uint32_t nowMs)
+{
+    const uint32_t dtMs = nowMs - stateMs;
+    if (dtMs == 0 || dtMs >= 0x80000000UL)
+    {
+        return; // same instant, or a time from before the last update
+    }
+    predict(state, dtMs);
+    stateMs = nowMs;
+}
+
+void PowerEstimator::predict(State &s, uint32_t dtMs) const
+{
+    if (commandW >= 0 && static_cast<float>(commandW) < s.output)
+    {
+        // Output decays towards the lower setpoint: F = diag(1, f).
+        const float f = expf(-static_cast<float>(dtMs) / static_cast<float>(POWER_ESTIMATOR_INVERTER_TAU_MS));
+        s.output = static_cast<float>(commandW) + (s.output - static_cast<float>(commandW)) * f;
+        s.pLO *= f;
+        s.pOO *= f * f;
+    }
+
+    const float dtSec = static_cast<float>(dtMs) / 1000.0f;
+    s.pLL = fminf(s.pLL + LOAD_Q * dtSec, MAX_VAR);
+    s.pOO = fminf(s.pOO + OUTPUT_Q * dtSec, MAX_VAR);
+    const float maxCov = sqrtf(s.pLL * s.pOO);
+    s.pLO = fmaxf(-maxCov, fminf(s.pLO, maxCov));
+}
+
+void PowerEstimator::correct(float innovation, float hLoad, float hOutput, float noiseVar)
+{
+    // Scalar update with z = hLoad * load + hOutput * output + noise.
+    const float phLoad = state.pLL * hLoad + state.pLO * hOutput;
+    const float phOutput = state.pLO * hLoad + state.pOO * hOutput;
+    const float s = hLoad * phLoad + hOutput * phOutput + noiseVar;
+    const float kLoad = phLoad / s;
+    const float kOutput = phOutput / s;
+
+    state.load += kLoad * innovation;
+    state.output += kOutput * innovation;
+    if (state.output < 0.0f)
+    {
+        state.output = 0.0f;
+    }
+
+    state.pLL -= kLoad * phLoad;
+    state.pLO -= kLoad * phOutput;
+    state.pOO -= kOutput * phOutput;
+}
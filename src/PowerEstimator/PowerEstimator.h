@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdint.h>
+
+// Two-state Kalman filter over household consumption and inverter output, fed by the grid
+// meter and the solar plug on their own schedules plus the setpoint sent over RS485.
+// No Arduino dependency; the same code runs in the firmware and in tools/replay.
+//
+// State x = [load W, output W]. Both random-walk between readings (POWER_ESTIMATOR_*_DRIFT_W
+// per sqrt(s)); the output additionally falls towards a setpoint below it with the inverter
+// time constant. A setpoint above the output predicts nothing: whether the inverter can
+// follow depends on the PV, which only the solar readings tell. Each reading is a scalar
+// update at its own arrival time: grid = load - output, solar = output.
+
+#ifndef POWER_ESTIMATOR_LOAD_DRIFT_W
+#define POWER_ESTIMATOR_LOAD_DRIFT_W 60.0f
+#endif
+
+#ifndef POWER_ESTIMATOR_OUTPUT_DRIFT_W
+#define POWER_ESTIMATOR_OUTPUT_DRIFT_W 25.0f
+#endif
+
+#ifndef POWER_ESTIMATOR_GRID_NOISE_W
+#define POWER_ESTIMATOR_GRID_NOISE_W 20.0f
+#endif
+
+#ifndef POWER_ESTIMATOR_SOLAR_NOISE_W
+#define POWER_ESTIMATOR_SOLAR_NOISE_W 10.0f
+#endif
+
+#ifndef POWER_ESTIMATOR_INVERTER_TAU_MS
+#define POWER_ESTIMATOR_INVERTER_TAU_MS 3000U
+#endif
+
+// Variances are capped here, so a stream that went quiet does not swallow the other's innovations forever.
+#ifndef POWER_ESTIMATOR_MAX_STD_W
+#define POWER_ESTIMATOR_MAX_STD_W 2000.0f
+#endif
+
+struct PowerEstimate
+{
+    int loadW = 0;   // household consumption
+    int outputW = 0; // inverter output
+    int gridW = 0;   // loadW - outputW: positive import, negative export
+    float loadStdW = 0.0f;
+    float outputStdW = 0.0f;
+};
+
+class PowerEstimator
+{
+public:
+    // Drops the state; the filter starts again once both streams have reported.
+    void reset();
+
+    // Readings at their arrival time. Times must not go backwards.
+    void updateGrid(int gridW, uint32_t nowMs);
+    void updateSolar(int solarW, uint32_t nowMs);
+
+    // Setpoint sent to the inverter at nowMs; drives the prediction from here on.
+    void setCommand(int setW, uint32_t nowMs);
+
+    // Estimate predicted to nowMs (does not change the filter).
+    PowerEstimate estimate(uint32_t nowMs) const;
+
+    // False until one reading of each stream has been seen.
+    bool ready() const { return initialized; }
+    uint32_t gridUpdates() const { return gridCount; }
+    uint32_t solarUpdates() const { return solarCount; }
+
+private:
+    struct State
+    {
+        float load = 0.0f;
+        float output = 0.0f;
+        float pLL = 0.0f; // covariance [[pLL, pLO], [pLO, pOO]]
+        float pLO = 0.0f;
+        float pOO = 0.0f;
+    };
+
+    void advance(uint32_t nowMs);
+    void predict(State &s, uint32_t dtMs) const;
+    void correct(float innovation, float hLoad, float hOutput, float noiseVar);
+    void tryInitialize(uint32_t nowMs);
+
+    State state;
+    bool initialized = false;
+    bool haveGrid = false;
+    bool haveSolar = false;
+    int firstGridW = 0;
+    int firstSolarW = 0;
+    int commandW = -1; // none sent yet
+    uint32_t stateMs = 0;
+    uint32_t gridCount = 0;
+    uint32_t solarCount = 0;
+};
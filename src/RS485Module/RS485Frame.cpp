@@ -0,0 +1,33 @@
+#include "RS485Frame.h"
+
+void encodeSetpointFrame(uint16_t demandW, uint8_t frame[RS485_FRAME_BYTES])
+{
+    const uint8_t high = static_cast<uint8_t>(demandW >> 8);
+    const uint8_t low = static_cast<uint8_t>(demandW & 0xFF);
+    frame[0] = 36;
+    frame[1] = 86;
+    frame[2] = 0;
+    frame[3] = 33;
+    frame[4] = high;
+    frame[5] = low;
+    frame[6] = 128;
+    frame[7] = static_cast<uint8_t>(264 - high - low);
+}
+
+size_t formatHexBytes(const uint8_t *bytes, size_t count, char *out, size_t outSize)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    if (outSize == 0)
+    {
+        return 0;
+    }
+    size_t written = 0;
+    for (size_t i = 0; i < count && written + 3 < outSize; ++i)
+    {
+        out[written++] = digits[bytes[i] >> 4];
+        out[written++] = digits[bytes[i] & 0x0F];
+        out[written++] = ' ';
+    }
+    out[written] = '\0';
+    return written;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Setpoint frame for the inverter limiter port, without any serial or GPIO access:
+//   24 56 00 21 <power hi> <power lo> 80 <checksum = (264 - hi - lo) & 0xFF>
+static constexpr size_t RS485_FRAME_BYTES = 8;
+
+void encodeSetpointFrame(uint16_t demandW, uint8_t frame[RS485_FRAME_BYTES]);
+
+// "24 56 00 ..." (two hex digits and a space per byte, NUL terminated); returns the characters written.
+size_t formatHexBytes(const uint8_t *bytes, size_t count, char *out, size_t outSize);
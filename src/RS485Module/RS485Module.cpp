@@ -1,5 +1,6 @@
 #include "RS485Module/RS485Module.h"
 #include "ConfigManager.h"
+#include "RS485Module/RS485Frame.h"
 
 byte byte0 = 36;
 byte byte1 = 86;
@@ -90,25 +91,10 @@ void sendToRS485(uint16_t demand)
     }
 
     // -- Compute serial packet to inverter (just the 3 bytes that change) --
-    byte4 = int(demand / 256); // (2 byte watts as short integer xaxb)
-    if (byte4 < 0 or byte4 > 256)
-    {
-        byte4 = 0;
-    }
-    byte5 = int(demand) - (byte4 * 256); // (2 byte watts as short integer xaxb)
-    if (byte5 < 0 or byte5 > 256)
-    {
-        byte5 = 0;
-    }
-    byte7 = (264 - byte4 - byte5); // checksum calculation
-    if (byte7 > 256)
-    {
-        byte7 = 8;
-    }
-
-    serialpacket[4] = byte4;
-    serialpacket[5] = byte5;
-    serialpacket[7] = byte7;
+    encodeSetpointFrame(demand, serialpacket);
+    byte4 = serialpacket[4];
+    byte5 = serialpacket[5];
+    byte7 = serialpacket[7];
 
     digitalWrite(rs485settings.dePin.get(), HIGH); // Activate send mode
     delayMicroseconds(100);
@@ -134,15 +120,21 @@ void sendToRS485(uint16_t demand)
     //     .Info();
 }
 
-String reciveFromRS485()
+RS485HexString reciveFromRS485()
 {
-    String recivedData;
-    while (RS485serial->available())
+    RS485HexString recivedData;
+    uint8_t chunk[16];
+    char hex[sizeof(chunk) * 3 + 1];
+    size_t remaining = RS485_RX_MAX_BYTES;
+    while (remaining > 0 && RS485serial->available())
     {
-        uint8_t byte = RS485serial->read();
-        char hexByte[4];
-        snprintf(hexByte, sizeof(hexByte), "%02X ", byte);
-        recivedData += hexByte;
+        size_t count = 0;
+        while (count < sizeof(chunk) && count < remaining && RS485serial->available())
+        {
+            chunk[count++] = static_cast<uint8_t>(RS485serial->read());
+        }
+        remaining -= count;
+        recivedData.append(hex, formatHexBytes(chunk, count, hex, sizeof(hex)));
     }
     // sl->Printf("RS485Module: Recived HEX: %s", recivedData.c_str()).Debug();
     return recivedData;
@@ -5,6 +5,13 @@
 
 #include <Arduino.h>
 #include "ConfigManager.h"
+#include "FixedString/FixedString.h"
+
+#ifndef RS485_RX_MAX_BYTES
+#define RS485_RX_MAX_BYTES 64 // per reciveFromRS485() call; the rest stays in the UART buffer
+#endif
+
+using RS485HexString = FixedString<RS485_RX_MAX_BYTES * 3>;
 
 struct RS485_Settings
 {
@@ -55,7 +62,7 @@ extern RS485_Settings rs485settings;
 void RS485begin();
 void sendToRS485(uint16_t demand);
 void sendToRS485Packet(uint16_t demand);
-String reciveFromRS485();
+RS485HexString reciveFromRS485();
 RS485Packet reciveFromRS485Packet();
 
 #endif // RS485_MODULE_H
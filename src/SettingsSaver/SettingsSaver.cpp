@@ -0,0 +1,109 @@
+#include "SettingsSaver.h"
+
+#include <freertos/FreeRTOS.h>
+
+namespace
+{
+portMUX_TYPE settingsSaverMux = portMUX_INITIALIZER_UNLOCKED;
+} // namespace
+
+void SettingsSaver::enqueue(void *setting, Writer write)
+{
+    portENTER_CRITICAL(&settingsSaverMux);
+    ++counters.marks;
+    lastMarkMs = millis();
+    bool found = false;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (entries[i].setting == setting)
+        {
+            found = true;
+            break;
+        }
+    }
+    if (found)
+    {
+        ++counters.coalesced;
+    }
+    else if (count < SETTINGS_SAVER_MAX_DIRTY)
+    {
+        entries[count++] = Entry{setting, write};
+    }
+    else
+    {
+        overflowed = true;
+    }
+    portEXIT_CRITICAL(&settingsSaverMux);
+}
+
+void SettingsSaver::service(unsigned long nowMs)
+{
+    portENTER_CRITICAL(&settingsSaverMux);
+    const bool due = (count > 0 || overflowed) && nowMs - lastMarkMs >= SETTINGS_SAVER_DEBOUNCE_MS;
+    portEXIT_CRITICAL(&settingsSaverMux);
+    if (due)
+    {
+        flush();
+    }
+}
+
+void SettingsSaver::flush()
+{
+    Entry batch[SETTINGS_SAVER_MAX_DIRTY];
+    portENTER_CRITICAL(&settingsSaverMux);
+    const size_t batchCount = count;
+    const bool fullSave = overflowed;
+    for (size_t i = 0; i < batchCount; ++i)
+    {
+        batch[i] = entries[i];
+    }
+    count = 0;
+    overflowed = false;
+    portEXIT_CRITICAL(&settingsSaverMux);
+
+    if (batchCount == 0 && !fullSave)
+    {
+        return;
+    }
+
+    const uint32_t startUs = micros();
+    if (fullSave)
+    {
+        ConfigManager.saveAll();
+    }
+    else
+    {
+        for (size_t i = 0; i < batchCount; ++i)
+        {
+            batch[i].write(batch[i].setting);
+        }
+    }
+    const uint32_t elapsedUs = micros() - startUs;
+
+    portENTER_CRITICAL(&settingsSaverMux);
+    ++counters.flushes;
+    counters.keysWritten += fullSave ? 0 : static_cast<uint32_t>(batchCount);
+    counters.fullSaves += fullSave ? 1 : 0;
+    counters.lastFlushUs = elapsedUs;
+    if (elapsedUs > counters.maxFlushUs)
+    {
+        counters.maxFlushUs = elapsedUs;
+    }
+    portEXIT_CRITICAL(&settingsSaverMux);
+}
+
+size_t SettingsSaver::pending() const
+{
+    portENTER_CRITICAL(&settingsSaverMux);
+    const size_t pendingCount = count;
+    portEXIT_CRITICAL(&settingsSaverMux);
+    return pendingCount;
+}
+
+SettingsSaverStats SettingsSaver::stats() const
+{
+    portENTER_CRITICAL(&settingsSaverMux);
+    const SettingsSaverStats copy = counters;
+    portEXIT_CRITICAL(&settingsSaverMux);
+    return copy;
+}
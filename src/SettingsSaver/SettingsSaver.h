@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "ConfigManager.h"
+
+// Changed settings waiting for a write. A full table falls back to ConfigManager.saveAll().
+#ifndef SETTINGS_SAVER_MAX_DIRTY
+#define SETTINGS_SAVER_MAX_DIRTY 16
+#endif
+
+// Pending keys are written once no further change arrived for this long.
+#ifndef SETTINGS_SAVER_DEBOUNCE_MS
+#define SETTINGS_SAVER_DEBOUNCE_MS 500UL
+#endif
+
+struct SettingsSaverStats
+{
+    uint32_t marks = 0;       // markDirty() calls
+    uint32_t coalesced = 0;   // marks of a key that was already pending
+    uint32_t flushes = 0;     // batches written
+    uint32_t keysWritten = 0; // keys written
+    uint32_t fullSaves = 0;   // saveAll() fallbacks after a table overflow
+    uint32_t lastFlushUs = 0;
+    uint32_t maxFlushUs = 0;
+};
+
+// Incremental settings persistence.
+// Code that changes a project setting calls markDirty(setting) instead of ConfigManager.saveAll().
+// Marks are coalesced per key; service() writes just the changed keys (Config<T>::save())
+// after a short debounce, so settings callbacks never block on NVS.
+// markDirty() may be called from any task, service() from the loop task only. flush() may also run
+// from the esp_restart() shutdown handler: both take the pending batch under the lock, so no key is written twice.
+class SettingsSaver
+{
+public:
+    template <typename T>
+    void markDirty(Config<T> &setting)
+    {
+        enqueue(&setting, &writeSetting<T>);
+    }
+
+    void service(unsigned long nowMs);
+
+    // Writes all pending keys immediately.
+    void flush();
+
+    size_t pending() const;
+    SettingsSaverStats stats() const;
+
+private:
+    using Writer = void (*)(void *setting);
+    struct Entry
+    {
+        void *setting;
+        Writer write;
+    };
+
+    Entry entries[SETTINGS_SAVER_MAX_DIRTY] = {};
+    size_t count = 0;
+    bool overflowed = false;
+    unsigned long lastMarkMs = 0;
+    SettingsSaverStats counters;
+
+    void enqueue(void *setting, Writer write);
+
+    template <typename T>
+    static void writeSetting(void *setting)
+    {
+        Config<T> *config = static_cast<Config<T> *>(setting);
+        config->save(config->get());
+    }
+};
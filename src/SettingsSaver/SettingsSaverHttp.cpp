@@ -0,0 +1,19 @@
+#include "SettingsSaverHttp.h"
+
+#include <stdio.h>
+
+void registerSettingsSaverRoutes(AsyncWebServer &server, SettingsSaver &saver)
+{
+    server.on("/settings/nvs", HTTP_GET, [&saver](AsyncWebServerRequest *request)
+              {
+        const SettingsSaverStats s = saver.stats();
+        char json[224];
+        snprintf(json, sizeof(json),
+                 "{\"pending\":%u,\"marks\":%lu,\"coalesced\":%lu,\"flushes\":%lu,\"keysWritten\":%lu,\"fullSaves\":%lu,\"lastFlushUs\":%lu,\"maxFlushUs\":%lu}",
+                 static_cast<unsigned int>(saver.pending()), static_cast<unsigned long>(s.marks),
+                 static_cast<unsigned long>(s.coalesced), static_cast<unsigned long>(s.flushes),
+                 static_cast<unsigned long>(s.keysWritten),
+                 static_cast<unsigned long>(s.fullSaves), static_cast<unsigned long>(s.lastFlushUs),
+                 static_cast<unsigned long>(s.maxFlushUs));
+        request->send(200, "application/json", json); });
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <ESPAsyncWebServer.h>
+
+#include "SettingsSaver.h"
+
+// Registers GET /settings/nvs: pending keys and NVS write statistics (JSON).
+void registerSettingsSaverRoutes(AsyncWebServer &server, SettingsSaver &saver);
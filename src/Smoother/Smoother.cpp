@@ -71,6 +71,30 @@ int Smoother::size() const {
   return bufferSize;
 }
 
+int Smoother::exportState(int* values, int maxValues, int* index) const {
+  if (buffer == nullptr || bufferSize <= 0 || bufferSize > maxValues) {
+    return 0;
+  }
+
+  for (int i = 0; i < bufferSize; ++i) {
+    values[i] = buffer[i];
+  }
+  *index = bufferIndex;
+  return bufferSize;
+}
+
+bool Smoother::restoreState(const int* values, int count, int index) {
+  if (buffer == nullptr || count != bufferSize || index < 0 || index >= bufferSize) {
+    return false;
+  }
+
+  for (int i = 0; i < bufferSize; ++i) {
+    buffer[i] = values[i];
+  }
+  bufferIndex = index;
+  return true;
+}
+
 int Smoother::clampBufferSize(int size) {
   if (size < 1) {
     return 1;
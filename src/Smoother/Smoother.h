@@ -15,6 +15,11 @@ public:
   bool isReady() const;
   int size() const;
 
+  // Copies the ring (size() values) and the write index out, or back in after a warm restart.
+  // restoreState() only accepts a state of the current size.
+  int exportState(int* values, int maxValues, int* index) const;
+  bool restoreState(const int* values, int count, int index);
+
 private:
   int* buffer;
   int bufferSize;
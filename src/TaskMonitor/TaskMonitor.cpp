@@ -0,0 +1,278 @@
+#include "TaskMonitor.h"
+
+#include <Arduino.h>
+#include <esp_freertos_hooks.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+#if configUSE_TRACE_FACILITY
+TaskStatus_t taskStatus[TASK_MONITOR_MAX_TASKS];
+#endif
+
+#if !configGENERATE_RUN_TIME_STATS
+// Tick sampling: which task each core was running when its tick fired.
+TaskHandle_t tickHandles[TASK_MONITOR_MAX_TASKS];
+uint32_t tickCounts[TASK_MONITOR_MAX_TASKS];
+uint32_t tickTaskCount = 0;
+uint32_t coreTicks[portNUM_PROCESSORS];
+portMUX_TYPE tickMux = portMUX_INITIALIZER_UNLOCKED;
+bool tickHooksRegistered = false;
+
+void IRAM_ATTR countTick()
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    portENTER_CRITICAL_ISR(&tickMux);
+    ++coreTicks[xPortGetCoreID()];
+    uint32_t i = 0;
+    while (i < tickTaskCount && tickHandles[i] != task)
+    {
+        ++i;
+    }
+    if (i == tickTaskCount && tickTaskCount < TASK_MONITOR_MAX_TASKS)
+    {
+        tickHandles[i] = task;
+        tickCounts[i] = 0;
+        ++tickTaskCount;
+    }
+    if (i < tickTaskCount)
+    {
+        ++tickCounts[i];
+    }
+    portEXIT_CRITICAL_ISR(&tickMux);
+}
+#endif
+
+uint16_t permille(uint32_t part, uint32_t whole)
+{
+    if (whole == 0)
+    {
+        return 0;
+    }
+    const uint64_t value = (static_cast<uint64_t>(part) * 1000ULL + whole / 2) / whole;
+    return static_cast<uint16_t>(value > 1000 ? 1000 : value);
+}
+} // namespace
+
+bool TaskMonitor::begin()
+{
+#if !configUSE_TRACE_FACILITY
+    return false;
+#else
+#if !configGENERATE_RUN_TIME_STATS
+    if (!tickHooksRegistered)
+    {
+        for (int core = 0; core < portNUM_PROCESSORS; ++core)
+        {
+            if (esp_register_freertos_tick_hook_for_cpu(countTick, core) != ESP_OK)
+            {
+                return false;
+            }
+        }
+        tickHooksRegistered = true;
+    }
+#endif
+    started = true;
+    lastCollectMs = millis();
+    collect(); // baseline for the first period
+    return true;
+#endif
+}
+
+bool TaskMonitor::usesRunTimeStats() const
+{
+#if configGENERATE_RUN_TIME_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool TaskMonitor::service(uint32_t nowMs)
+{
+    if (!started || nowMs - lastCollectMs < TASK_MONITOR_PERIOD_MS)
+    {
+        return false;
+    }
+    lastCollectMs = nowMs;
+    return collect();
+}
+
+bool TaskMonitor::collect()
+{
+#if !configUSE_TRACE_FACILITY
+    return false;
+#else
+    const uint32_t startUs = micros();
+    uint32_t totalRunTime = 0;
+    const UBaseType_t listed = uxTaskGetSystemState(taskStatus, TASK_MONITOR_MAX_TASKS, &totalRunTime);
+    overflow = listed == 0 && uxTaskGetNumberOfTasks() > TASK_MONITOR_MAX_TASKS;
+    if (listed == 0)
+    {
+        return false;
+    }
+
+#if configGENERATE_RUN_TIME_STATS
+    const uint32_t totalDelta = totalRunTime - prevTotalRunTime;
+    prevTotalRunTime = totalRunTime;
+#else
+    uint32_t ticks[TASK_MONITOR_MAX_TASKS];
+    TaskHandle_t tickTasks[TASK_MONITOR_MAX_TASKS];
+    uint32_t sampledTasks = 0;
+    uint32_t ticksPerCore = 0;
+    portENTER_CRITICAL(&tickMux);
+    sampledTasks = tickTaskCount;
+    for (uint32_t i = 0; i < sampledTasks; ++i)
+    {
+        tickTasks[i] = tickHandles[i];
+        ticks[i] = tickCounts[i];
+    }
+    for (int core = 0; core < portNUM_PROCESSORS; ++core)
+    {
+        ticksPerCore += coreTicks[core];
+        coreTicks[core] = 0;
+    }
+    tickTaskCount = 0; // tasks deleted since the last period drop out here
+    portEXIT_CRITICAL(&tickMux);
+    ticksPerCore /= portNUM_PROCESSORS;
+#endif
+
+    size_t count = 0;
+    void *handles[TASK_MONITOR_MAX_TASKS];
+    uint32_t runTimes[TASK_MONITOR_MAX_TASKS];
+    for (UBaseType_t i = 0; i < listed && count < TASK_MONITOR_MAX_TASKS; ++i)
+    {
+        const TaskStatus_t &status = taskStatus[i];
+        TaskMonitorEntry &entry = entries[count];
+        strncpy(entry.name, status.pcTaskName, sizeof(entry.name) - 1);
+        entry.name[sizeof(entry.name) - 1] = '\0';
+        entry.stackFreeMinBytes = static_cast<uint32_t>(status.usStackHighWaterMark) * sizeof(StackType_t);
+        entry.priority = static_cast<uint8_t>(status.uxCurrentPriority);
+#if configTASKLIST_INCLUDE_COREID
+        entry.core = status.xCoreID < portNUM_PROCESSORS ? static_cast<int8_t>(status.xCoreID) : -1;
+#else
+        entry.core = -1;
+#endif
+
+#if configGENERATE_RUN_TIME_STATS
+        uint32_t previous = 0;
+        for (size_t p = 0; p < prevCount; ++p)
+        {
+            if (prevHandles[p] == status.xHandle)
+            {
+                previous = prevRunTime[p];
+                break;
+            }
+        }
+        entry.cpuPermille = permille(status.ulRunTimeCounter - previous, totalDelta);
+        runTimes[count] = status.ulRunTimeCounter;
+#else
+        uint32_t taskTicks = 0;
+        for (uint32_t t = 0; t < sampledTasks; ++t)
+        {
+            if (tickTasks[t] == status.xHandle)
+            {
+                taskTicks = ticks[t];
+                break;
+            }
+        }
+        entry.cpuPermille = permille(taskTicks, ticksPerCore);
+        runTimes[count] = 0;
+#endif
+        handles[count] = status.xHandle;
+        ++count;
+    }
+
+    for (int core = 0; core < 2; ++core)
+    {
+        coreLoad[core] = 0;
+        if (core >= portNUM_PROCESSORS)
+        {
+            continue;
+        }
+        void *idle = xTaskGetIdleTaskHandleForCPU(core);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (handles[i] == idle)
+            {
+                coreLoad[core] = static_cast<uint16_t>(1000 - entries[i].cpuPermille);
+            }
+        }
+    }
+
+    memcpy(prevHandles, handles, count * sizeof(handles[0]));
+    memcpy(prevRunTime, runTimes, count * sizeof(runTimes[0]));
+    prevCount = count;
+
+    // Busiest first; insertion sort on at most TASK_MONITOR_MAX_TASKS entries.
+    for (size_t i = 1; i < count; ++i)
+    {
+        const TaskMonitorEntry moving = entries[i];
+        size_t j = i;
+        while (j > 0 && entries[j - 1].cpuPermille < moving.cpuPermille)
+        {
+            entries[j] = entries[j - 1];
+            --j;
+        }
+        entries[j] = moving;
+    }
+    taskCount = count;
+    ++snapshotCount;
+    lastCollectUs = micros() - startUs;
+    return true;
+#endif
+}
+
+size_t TaskMonitor::formatJson(char *out, size_t size) const
+{
+    int len = snprintf(out, size,
+                       "{\"source\":\"%s\",\"periodMs\":%lu,\"collectUs\":%lu,\"overflow\":%s,\"cores\":[%.1f,%.1f],\"tasks\":[",
+                       usesRunTimeStats() ? "runtime" : "ticks", static_cast<unsigned long>(TASK_MONITOR_PERIOD_MS),
+                       static_cast<unsigned long>(lastCollectUs), overflow ? "true" : "false", coreLoad[0] / 10.0,
+                       coreLoad[1] / 10.0);
+    for (size_t i = 0; i < taskCount && len > 0 && static_cast<size_t>(len) < size; ++i)
+    {
+        const TaskMonitorEntry &e = entries[i];
+        len += snprintf(out + len, size - len, "%s{\"name\":\"%s\",\"core\":%d,\"prio\":%u,\"cpu\":%.1f,\"stackFree\":%lu}",
+                        i == 0 ? "" : ",", e.name, static_cast<int>(e.core), static_cast<unsigned int>(e.priority),
+                        e.cpuPermille / 10.0, static_cast<unsigned long>(e.stackFreeMinBytes));
+    }
+    if (len < 0 || static_cast<size_t>(len) + 3 > size)
+    {
+        return 0; // does not fit
+    }
+    out[len++] = ']';
+    out[len++] = '}';
+    out[len] = '\0';
+    return static_cast<size_t>(len);
+}
+
+size_t TaskMonitor::formatCompactJson(char *out, size_t size) const
+{
+    int len = snprintf(out, size, "{\"cores\":[%.1f,%.1f],\"tasks\":[", coreLoad[0] / 10.0, coreLoad[1] / 10.0);
+    for (size_t i = 0; i < taskCount && len > 0; ++i)
+    {
+        const TaskMonitorEntry &e = entries[i];
+        char item[48];
+        const int itemLen = snprintf(item, sizeof(item), "%s[\"%s\",%d,%.1f,%lu]", i == 0 ? "" : ",", e.name,
+                                     static_cast<int>(e.core), e.cpuPermille / 10.0,
+                                     static_cast<unsigned long>(e.stackFreeMinBytes));
+        if (itemLen <= 0 || static_cast<size_t>(len + itemLen) + 3 > size)
+        {
+            break; // the quietest tasks are dropped to stay within the MQTT buffer
+        }
+        memcpy(out + len, item, static_cast<size_t>(itemLen));
+        len += itemLen;
+    }
+    if (len < 0 || static_cast<size_t>(len) + 3 > size)
+    {
+        return 0;
+    }
+    out[len++] = ']';
+    out[len++] = '}';
+    out[len] = '\0';
+    return static_cast<size_t>(len);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Per-task CPU share and stack high-water marks of all FreeRTOS tasks, collected every
+// TASK_MONITOR_PERIOD_MS into a fixed table (served on /tasks.json, published to <base>/Tasks).
+//
+// CPU shares come from the FreeRTOS run-time counters when the framework was built with
+// configGENERATE_RUN_TIME_STATS; otherwise a tick hook on each core counts which task was
+// running (1 ms resolution). Shares are per mille of one core over the last period, so
+// a task busy on one core reads 1000 and the idle tasks show what is left per core.
+
+#ifndef TASK_MONITOR_MAX_TASKS
+#define TASK_MONITOR_MAX_TASKS 24
+#endif
+
+#ifndef TASK_MONITOR_PERIOD_MS
+#define TASK_MONITOR_PERIOD_MS 5000UL
+#endif
+
+struct TaskMonitorEntry
+{
+    char name[16];
+    uint32_t stackFreeMinBytes; // least free stack since the task started
+    uint16_t cpuPermille;       // of one core, last period
+    uint8_t priority;
+    int8_t core; // -1: not pinned
+};
+
+class TaskMonitor
+{
+public:
+    // Registers the tick hooks when run-time stats are not available; false if task listing is not compiled in.
+    bool begin();
+
+    // Collects when TASK_MONITOR_PERIOD_MS has passed; true when a new snapshot is ready.
+    bool service(uint32_t nowMs);
+
+    size_t count() const { return taskCount; }
+    const TaskMonitorEntry &task(size_t index) const { return entries[index]; } // sorted by CPU share
+    uint16_t coreLoadPermille(int core) const { return core >= 0 && core < 2 ? coreLoad[core] : 0; }
+    bool usesRunTimeStats() const;
+    bool overflowed() const { return overflow; } // more tasks than TASK_MONITOR_MAX_TASKS
+    uint32_t collectUs() const { return lastCollectUs; }
+    uint32_t snapshots() const { return snapshotCount; }
+
+    // {"source":"runtime","periodMs":5000,"collectUs":210,"cores":[31.2,4.5],
+    //  "tasks":[{"name":"loopTask","core":1,"prio":1,"cpu":27.9,"stackFree":3120},...]}
+    size_t formatJson(char *out, size_t size) const;
+
+    // MQTT form: {"cores":[31.2,4.5],"tasks":[["loopTask",1,27.9,3120],...]} (name, core, cpu %, free stack)
+    size_t formatCompactJson(char *out, size_t size) const;
+
+private:
+    bool collect();
+
+    TaskMonitorEntry entries[TASK_MONITOR_MAX_TASKS];
+    size_t taskCount = 0;
+    uint16_t coreLoad[2] = {0, 0};
+    bool overflow = false;
+    bool started = false;
+    uint32_t lastCollectMs = 0;
+    uint32_t lastCollectUs = 0;
+    uint32_t snapshotCount = 0;
+
+    // Previous run-time counters by task handle.
+    void *prevHandles[TASK_MONITOR_MAX_TASKS] = {};
+    uint32_t prevRunTime[TASK_MONITOR_MAX_TASKS] = {};
+    size_t prevCount = 0;
+    uint32_t prevTotalRunTime = 0;
+};
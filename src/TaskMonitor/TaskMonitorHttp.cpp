@@ -0,0 +1,15 @@
+#include "TaskMonitorHttp.h"
+
+void registerTaskMonitorRoutes(AsyncWebServer &server, const TaskMonitor &monitor)
+{
+    server.on("/tasks.json", HTTP_GET, [&monitor](AsyncWebServerRequest *request)
+              {
+        // Handlers run one at a time on the async_tcp task, so one static buffer is enough.
+        static char json[160 + TASK_MONITOR_MAX_TASKS * 80];
+        if (monitor.formatJson(json, sizeof(json)) == 0)
+        {
+            request->send(500, "application/json", "{\"error\":\"task table does not fit\"}");
+            return;
+        }
+        request->send(200, "application/json", json); });
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <ESPAsyncWebServer.h>
+
+#include "TaskMonitor.h"
+
+// Registers GET /tasks.json: the last task snapshot (JSON, polled by the /tasks page).
+void registerTaskMonitorRoutes(AsyncWebServer &server, const TaskMonitor &monitor);
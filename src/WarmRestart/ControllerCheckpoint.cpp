@@ -0,0 +1,80 @@
+#include "ControllerCheckpoint.h"
+
+#include <string.h>
+
+#if defined(ARDUINO)
+#include <esp_attr.h>
+RTC_NOINIT_ATTR ControllerCheckpoint controllerCheckpointRtc;
+#else
+ControllerCheckpoint controllerCheckpointRtc;
+#endif
+
+namespace
+{
+constexpr uint32_t CHECKPOINT_MAGIC = 0x31504357UL; // "WCP1"
+
+uint32_t crc32(const uint8_t *data, size_t length)
+{
+    uint32_t crc = 0xFFFFFFFFUL;
+    for (size_t i = 0; i < length; ++i)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+uint32_t checkpointCrc(const ControllerCheckpoint &checkpoint)
+{
+    return crc32(reinterpret_cast<const uint8_t *>(&checkpoint), offsetof(ControllerCheckpoint, crc));
+}
+} // namespace
+
+const char *checkpointStatusText(CheckpointStatus status)
+{
+    switch (status)
+    {
+    case CheckpointStatus::Restored:
+        return "restored";
+    case CheckpointStatus::Missing:
+        return "none";
+    case CheckpointStatus::Corrupt:
+        return "corrupt";
+    case CheckpointStatus::Stale:
+        return "stale";
+    }
+    return "?";
+}
+
+void sealControllerCheckpoint(ControllerCheckpoint &checkpoint, int64_t nowMs)
+{
+    checkpoint.magic = CHECKPOINT_MAGIC;
+    checkpoint.length = sizeof(ControllerCheckpoint);
+    checkpoint.savedAtMs = nowMs;
+    checkpoint.crc = checkpointCrc(checkpoint);
+}
+
+CheckpointStatus takeControllerCheckpoint(ControllerCheckpoint &checkpoint, int64_t nowMs, ControllerCheckpoint &out)
+{
+    if (checkpoint.magic != CHECKPOINT_MAGIC)
+    {
+        return CheckpointStatus::Missing;
+    }
+    memcpy(&out, &checkpoint, sizeof(out));
+    checkpoint.magic = 0; // use once
+
+    if (out.length != sizeof(ControllerCheckpoint) || out.crc != checkpointCrc(out) ||
+        out.smootherSize < 0 || out.smootherSize > CONTROLLER_CHECKPOINT_SMOOTHER_MAX)
+    {
+        return CheckpointStatus::Corrupt;
+    }
+    const int64_t ageMs = nowMs - out.savedAtMs;
+    if (ageMs < 0 || ageMs > WARM_RESTART_MAX_AGE_MS)
+    {
+        return CheckpointStatus::Stale;
+    }
+    return CheckpointStatus::Restored;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+// A checkpoint older than this (wall clock) is ignored and the controller starts cold.
+#ifndef WARM_RESTART_MAX_AGE_MS
+#define WARM_RESTART_MAX_AGE_MS 60000
+#endif
+
+static constexpr int CONTROLLER_CHECKPOINT_SMOOTHER_MAX = 120; // Smoother::MAX_BUFFER_SIZE
+
+// Controller state written on a planned restart (esp_restart(): OTA, reboot button, settings).
+// Lives in RTC_NOINIT memory, so it must stay a plain struct without initializers.
+struct ControllerCheckpoint
+{
+    uint32_t magic;
+    uint32_t length;   // sizeof(ControllerCheckpoint) of the firmware that wrote it
+    int64_t savedAtMs; // wall clock (gettimeofday), kept across software resets
+    int32_t setpointW;
+    int32_t calculatedW;
+    uint8_t usePid;
+    uint8_t pidInitialized;
+    int16_t smootherSize; // 0 = no smoother state
+    float pidOutput;
+    float pidIntegral;
+    float pidPreviousError;
+    int32_t smootherIndex;
+    int32_t smoother[CONTROLLER_CHECKPOINT_SMOOTHER_MAX];
+    uint32_t crc;
+};
+static_assert(std::is_trivially_default_constructible<ControllerCheckpoint>::value, "RTC_NOINIT storage must not be initialized");
+
+// The RTC_NOINIT instance (a plain global on host builds).
+extern ControllerCheckpoint controllerCheckpointRtc;
+
+enum class CheckpointStatus : uint8_t
+{
+    Restored,
+    Missing, // no checkpoint (power-on, crash or first boot)
+    Corrupt, // CRC or layout mismatch
+    Stale,   // older than WARM_RESTART_MAX_AGE_MS or clock went backwards
+};
+
+const char *checkpointStatusText(CheckpointStatus status);
+
+// Stamps and checksums a filled checkpoint.
+void sealControllerCheckpoint(ControllerCheckpoint &checkpoint, int64_t nowMs);
+
+// Validates the checkpoint and consumes it (a second call reports Missing).
+CheckpointStatus takeControllerCheckpoint(ControllerCheckpoint &checkpoint, int64_t nowMs, ControllerCheckpoint &out);
@@ -0,0 +1,34 @@
+#include "WebAssets.h"
+
+#include "generated/web_assets.h"
+
+namespace
+{
+void sendAsset(AsyncWebServerRequest *request, const WebAsset &asset)
+{
+    if (request->hasHeader("If-None-Match") && request->getHeader("If-None-Match")->value().indexOf(asset.etag) >= 0)
+    {
+        AsyncWebServerResponse *notModified = request->beginResponse(304);
+        notModified->addHeader("ETag", asset.etag);
+        request->send(notModified);
+        return;
+    }
+
+    AsyncWebServerResponse *response = request->beginResponse_P(200, asset.contentType, asset.data, asset.length);
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("ETag", asset.etag);
+    // Always revalidate; the ETag makes that a header-only round trip.
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+}
+} // namespace
+
+void registerWebAssets(AsyncWebServer &server)
+{
+    for (size_t i = 0; i < WEB_ASSET_COUNT; ++i)
+    {
+        const WebAsset *asset = &WEB_ASSETS[i];
+        server.on(asset->path, HTTP_GET, [asset](AsyncWebServerRequest *request)
+                  { sendAsset(request, *asset); });
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <ESPAsyncWebServer.h>
+
+// One precompressed asset from web/, generated into src/generated/web_assets.h
+// by tools/precompile_wrapper.py at build time.
+struct WebAsset
+{
+    const char *path;        // URL path, e.g. "/history"
+    const char *contentType; // MIME type of the uncompressed content
+    const uint8_t *data;     // gzip stream in flash
+    size_t length;           // gzip stream length
+    const char *etag;        // strong ETag (quoted content hash)
+};
+
+// Serves every generated asset with Content-Encoding: gzip and its ETag.
+// Only web/ and the BINLOG string table: the ConfigManager settings UI is embedded and routed by the library.
+// Repeat requests with a matching If-None-Match get an empty 304.
+void registerWebAssets(AsyncWebServer &server);
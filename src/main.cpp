@@ -1,10 +1,12 @@
 #include <Arduino.h>
 #include <esp_system.h>
+#include <esp_heap_caps.h>
 #include <nvs_flash.h>
 #include <Preferences.h>
 #include <Ticker.h>
 #include <WiFi.h>
 #include <time.h>
+#include <sys/time.h>
 #include <new>
 
 #include <AsyncTCP.h>
@@ -25,6 +27,22 @@
 #include "RS485Module/RS485Module.h"
 #include "helpers/HelperModule.h"
 #include "Smoother/Smoother.h"
+#include "OfflineQueue/OfflineQueue.h"
+#include "ControlLog/ControlLogFormat.h"
+#include "WebAssets/WebAssets.h"
+#include "AppLog/AppLog.h"
+#include "LimiterParams/LimiterParams.h"
+#include "LimiterCore/LimiterCore.h"
+#include "PowerEstimator/MeterInbox.h"
+#include "PowerEstimator/PowerEstimator.h"
+#include "SettingsSaver/SettingsSaverHttp.h"
+#include "BootSequence/BootSequenceHttp.h"
+#include "WarmRestart/ControllerCheckpoint.h"
+#include "BinLog/BinLogHttp.h"
+#include "KernelBench/KernelBench.h"
+#include "FixedString/FixedString.h"
+#include "HeapTrace/HeapTrace.h"
+#include "CpuProfiler/CpuProfilerHttp.h"
 
 // Feature flags
 #ifndef FEATURE_BME280_ENABLED
@@ -47,26 +65,80 @@
 #define FEATURE_MQTT_LOGGER_ENABLED 0
 #endif
 
+// Diagnostics. Each flag drops the module's buffers, routes, MQTT topic and web page
+// (tools/precompile_wrapper.py reads the same flags). FEATURE_BINLOG_ENABLED is in BinLog.h.
+#ifndef FEATURE_LIVE_PUSH_ENABLED
+#define FEATURE_LIVE_PUSH_ENABLED 1
+#endif
+
+#ifndef FEATURE_HISTORY_ENABLED
+#define FEATURE_HISTORY_ENABLED 1
+#endif
+
+#ifndef FEATURE_CONTROL_LOG_ENABLED
+#define FEATURE_CONTROL_LOG_ENABLED 1
+#endif
+
+#ifndef FEATURE_FLIGHT_RECORDER_ENABLED
+#define FEATURE_FLIGHT_RECORDER_ENABLED 1
+#endif
+
+#ifndef FEATURE_TASK_MONITOR_ENABLED
+#define FEATURE_TASK_MONITOR_ENABLED 1
+#endif
+
+#ifndef FEATURE_HEAP_STATS_ENABLED
+#define FEATURE_HEAP_STATS_ENABLED 1
+#endif
+
 #define FEATURE_ANY_I2C (FEATURE_OLED_DISPLAY_ENABLED || FEATURE_BME280_ENABLED)
 #define FEATURE_ANY_RELAY_OUTPUTS (FEATURE_FAN_ENABLED || FEATURE_HEATER_ENABLED)
 
 #if FEATURE_ANY_I2C
 #include <Wire.h>
+#include "I2CBus/I2CBus.h"
+#include "I2CBus/I2CBusHttp.h"
 #endif
 
 #if FEATURE_BME280_ENABLED
-#include <BME280_I2C.h>
+#include "Bme280/Bme280Forced.h"
 #endif
 
 #if FEATURE_OLED_DISPLAY_ENABLED
-#include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
+#include "OledText/OledText.h"
+#include "OledText/Ssd1306I2c.h"
 #endif
 
 #if FEATURE_MQTT_LOGGER_ENABLED
 #include "mqtt/MQTTLogOutput.h"
 #endif
 
+#if FEATURE_LIVE_PUSH_ENABLED
+#include "LivePush/LivePush.h"
+#endif
+
+#if FEATURE_HISTORY_ENABLED
+#include "History/HistoryStore.h"
+#include "History/HistoryHttp.h"
+#endif
+
+#if FEATURE_CONTROL_LOG_ENABLED
+#include "ControlLog/ControlLog.h"
+#include "ControlLog/ControlLogHttp.h"
+#endif
+
+#if FEATURE_FLIGHT_RECORDER_ENABLED
+#include "FlightRecorder/FlightRecorderHttp.h"
+#endif
+
+#if FEATURE_TASK_MONITOR_ENABLED
+#include "TaskMonitor/TaskMonitorHttp.h"
+#endif
+
+#if FEATURE_HEAP_STATS_ENABLED
+#include "HeapTrace/HeapTraceHttp.h"
+#endif
+
 #if __has_include("secret/secrets.h")
 #include "secret/secrets.h"
 #define CM_HAS_WIFI_SECRETS 1
@@ -98,22 +170,18 @@
 #define VERSION "4.3.1"
 #endif
 
-enum class NegativePriceSettingPreference : uint8_t
-{
-    None,
-    ForceMin,
-    SetZero
-};
-
 // Forward declarations
 
 // Startup and lifecycle
 void cb_RS485Listener();
 #if FEATURE_BME280_ENABLED
-bool readBme280();
+bool applyBme280Reading(const Bme280Reading &reading);
 void SetupStartTemperatureMeasuring();
 #endif
 void setupGUI();
+#if FEATURE_LIVE_PUSH_ENABLED
+static void setupLivePush();
+#endif
 void onWiFiConnected();
 void onWiFiDisconnected();
 void onWiFiAPMode();
@@ -127,28 +195,59 @@ static void attachSystemSettings();
 static void syncStoredCodeVersion();
 static void registerProjectSettings();
 static void configureLimiterSettingsBehavior();
+static void refreshLimiterParams();
+static void armRS485Ticker(float periodSec);
+static void sendBootSafeSetpoint();
+static void queueBootStages();
+static void finishBoot();
+static void restoreControllerCheckpoint();
+static void flushSettingsOnShutdown();
+#if FEATURE_CONTROL_LOG_ENABLED
+static void flushControlLogOnShutdown();
+#endif
+static void saveControllerCheckpoint();
 static void normalizeNegativePriceSettings(NegativePriceSettingPreference preferred, bool persist, bool logCorrection);
 static void registerIOBindings();
 static bool ensureNvsReady();
-static bool isValidMacAddress(const String &value);
+static bool isValidMacAddress(const char *value);
 static void applyAccessPointMacPriority();
 
 // MQTT and scheduler helpers
 static const char *resetReasonToText(esp_reset_reason_t reason);
 static void updateMqttTopics();
 static void publishMqttNow();
+static void recordOfflineSample();
+static void flushOfflineQueue();
+#if FEATURE_FLIGHT_RECORDER_ENABLED
+static void setupFlightRecorder();
+static void publishFlightRecorder();
+#endif
+#if FEATURE_TASK_MONITOR_ENABLED
+static void serviceTaskMonitor();
+static void publishTaskMonitor();
+#endif
 static void handleRS485Scheduler();
+static void observeMeterReadings();
+static bool timeReached(unsigned long now, unsigned long target);
 #if FEATURE_BME280_ENABLED
-static bool handleTemperatureScheduler();
+static void handleTemperatureScheduler();
 #endif
 static void updateStatusLED();
+static void serviceHeapTrace();
 
 // RS485 and limiter helpers
 void testRS232();
-static void resetPidController();
-static int computePidStabilizedTarget(int baseTarget, int configuredMin, int configuredMax);
 static void processRS485Tick();
 static bool ensurePowerSmoother(int initialValue);
+#if FEATURE_HISTORY_ENABLED
+static void recordHistorySample();
+#endif
+#if FEATURE_CONTROL_LOG_ENABLED
+static void recordControlLogTick();
+#endif
+#if FEATURE_FLIGHT_RECORDER_ENABLED
+static void recordFlightTick();
+#endif
 
 // Display helpers
 #if FEATURE_OLED_DISPLAY_ENABLED
@@ -197,6 +296,8 @@ struct LimiterSettings
     Config<bool> forceMinOnNegativePrice{ConfigOptions<bool>{.key = "LimiterNegPrice", .name = "Force Min On Negative Price", .category = "Limiter", .defaultValue = false, .sortOrder = 10}};
     Config<bool> setZeroOnNegativePrice{ConfigOptions<bool>{.key = "LimNegZero", .name = "Set 0 On Negative Price", .category = "Limiter", .defaultValue = false, .sortOrder = 11}};
     Config<float> RS232PublishPeriod{ConfigOptions<float>{.key = "LimiterRS485P", .name = "RS485 Publish Period (s)", .category = "Limiter", .defaultValue = 2.0f, .sortOrder = 12}};
+    Config<int> bootSafeOutput{ConfigOptions<int>{.key = "LimiterBootW", .name = "Boot Safe Output (W)", .category = "Limiter", .defaultValue = 0, .sortOrder = 13}};
+    Config<bool> useEstimator{ConfigOptions<bool>{.key = "LimiterKalman", .name = "Use State Estimator", .category = "Limiter", .defaultValue = true, .sortOrder = 14}};
 
     void attachTo(ConfigManagerClass &cfg)
     {
@@ -212,6 +313,8 @@ struct LimiterSettings
         cfg.addSetting(&forceMinOnNegativePrice);
         cfg.addSetting(&setZeroOnNegativePrice);
         cfg.addSetting(&RS232PublishPeriod);
+        cfg.addSetting(&bootSafeOutput);
+        cfg.addSetting(&useEstimator);
     }
 };
 
@@ -340,20 +443,22 @@ static cm::CoreNtpSettings &ntpSettings = coreSettings.ntp;
 static cm::CoreWiFiServices wifiServices;
 
 // Hardware objects
+Ticker RS485Ticker;
+
+#if FEATURE_ANY_I2C
+// Shared bus for OLED and BME280; transactions run in bounded slices from loop().
+static I2CBus i2cBus(Wire);
+#endif
+
 #if FEATURE_BME280_ENABLED
-BME280_I2C bme280;
+static Bme280Forced bme280(i2cBus);
 #endif
-Ticker RS485Ticker;
 
 #if FEATURE_OLED_DISPLAY_ENABLED
-static constexpr int OLED_WIDTH = 128;
-static constexpr int OLED_HEIGHT = 32;
-static constexpr int OLED_RESET_PIN = 4; // keep legacy wiring default
-Adafruit_SSD1306 display(OLED_WIDTH, OLED_HEIGHT, &Wire, OLED_RESET_PIN);
+static Ssd1306I2cSink oledPanel(i2cBus);
+static OledTextCanvas display; // text rows 0..1 sit inside the frame, only changed cells are sent
 #endif
 
-Smoother *powerSmoother = nullptr; // there is a memory allocation in setup, better use a pointer here
-
 // MQTT and runtime state
 int currentGridImportW = 0;        // signed grid power: positive import, negative export
 int inverterCalculatedValue = 0;   // calculated controller output before final send decision
@@ -368,19 +473,35 @@ float Humidity = 0.0;              // current humidity in percent
 float Pressure = 0.0;              // current pressure in hPa
 #endif
 
-static String mqttBaseTopic;
-static String topicPublishSetValueW;
-static String topicPublishCalculatedValueW;
-static String topicPublishGridImportW;
+#ifndef MQTT_TOPIC_MAX_LEN
+#define MQTT_TOPIC_MAX_LEN 128
+#endif
+
+// Publish topics live in static storage; updateMqttTopics() rebuilds them when MQTT connects.
+using MqttTopic = FixedString<MQTT_TOPIC_MAX_LEN>;
+static MqttTopic mqttBaseTopic;
+static MqttTopic topicPublishSetValueW;
+static MqttTopic topicPublishCalculatedValueW;
+static MqttTopic topicPublishGridImportW;
+static MqttTopic topicPublishHistory;
+#if FEATURE_FLIGHT_RECORDER_ENABLED
+static MqttTopic topicPublishFlightRecorder;
+#endif
+#if FEATURE_TASK_MONITOR_ENABLED
+static MqttTopic topicPublishTasks;
+#endif
 #if FEATURE_BME280_ENABLED
-static String topicPublishTempC;
-static String topicPublishHumidityPct;
-static String topicPublishDewpointC;
+static MqttTopic topicPublishTempC;
+static MqttTopic topicPublishHumidityPct;
+static MqttTopic topicPublishDewpointC;
 #endif
+static volatile bool mqttTopicsConnected = false; // topics resolved for the current MQTT connection and base topic
 
 // Scheduler/timing state
 #if FEATURE_BME280_ENABLED
 static bool bme280Initialized = false;
+static bool temperatureUpdatePending = false; // set when a forced-mode reading arrives, consumed by loop()
+static uint32_t lastBme280Failures = 0;
 static volatile bool rs485TickDue = false;
 static unsigned long nextTemperatureReadMs = 0;
 static constexpr unsigned long MIN_TEMPERATURE_READ_INTERVAL_MS = 1000UL;
@@ -435,22 +556,80 @@ static constexpr char IO_HEATER_ID[] = "heater_relay";
 static constexpr char IO_RESET_ID[] = "reset_btn";
 static constexpr char IO_AP_ID[] = "ap_btn";
 
-struct PidControllerState
-{
-    bool initialized = false;
-    float output = 0.0f;
-    float integral = 0.0f;
-    float previousError = 0.0f;
-    unsigned long lastUpdateMs = 0;
-};
+// PID state, smoother and mode tracking of the control loop (portable, see LimiterCore.h).
+static LimiterCore limiterCore;
+
+// Load/output estimate from both meter streams and the sent setpoint (see PowerEstimator.h).
+// The meter topics are received into inboxes, so each MQTT message is one reading with its
+// arrival time; currentGridImportW/solarPowerW keep the last value for everything else.
+static PowerEstimator powerEstimator;
+static MeterInbox gridInbox;
+static MeterInbox solarInbox;
+
+// Validated limiter settings; rebuilt in loop() after a setting callback marked them stale.
+static LimiterParamsStore limiterParams;
 
-static PidControllerState pidController;
-static bool lastLimiterModeWasPid = false;
-static int lastSmootherRequestedSize = -1;
+// Debounced per-key NVS writes for settings changed by code (see SettingsSaver.h).
+static SettingsSaver settingsSaver;
+static uint32_t limiterParamsGeneration = 0;
+static float rs485TickerPeriodSec = 0.0f; // 0 = ticker not armed yet
+
+// Staged startup: RS485 and the boot-safe setpoint first, everything else one stage per loop() pass.
+static BootSequence bootSequence;
+
+// Setpoint restored from a warm-restart checkpoint; replaces the boot-safe setpoint while starting (-1 = none).
+static int warmRestartSetpointW = -1;
 static int lastNegativePriceOverrideTarget = -1;
 static NegativePriceSettingPreference lastNegativePriceSettingPreference = NegativePriceSettingPreference::None;
 static bool normalizingNegativePriceSettings = false;
 
+// Offline publish queue: samples recorded while MQTT is down, flushed in paced batches on reconnect.
+static OfflineQueue offlineQueue;
+static unsigned long nextOfflineFlushMs = 0;
+static constexpr size_t OFFLINE_FLUSH_BATCH_SAMPLES = 16;
+static constexpr unsigned long OFFLINE_FLUSH_PACING_MS = 250UL;
+
+#if FEATURE_LIVE_PUSH_ENABLED
+// Delta-only live values for WebSocket clients (see setupLivePush()).
+static LivePush livePush("/ws/live");
+#endif
+
+#if FEATURE_HISTORY_ENABLED
+// On-device history (1 h @ 10 s, 24 h @ 1 min), fed from the control step and served on /history.
+static HistoryStore historyStore;
+#endif
+
+#if FEATURE_CONTROL_LOG_ENABLED
+// Persistent control log in the "ctrllog" flash partition (one record every 10 s).
+static ControlLog controlLog;
+static unsigned long nextControlLogRecordMs = 0;
+static constexpr unsigned long CONTROL_LOG_RECORD_PERIOD_MS = 10000UL;
+#endif
+
+#if FEATURE_FLIGHT_RECORDER_ENABLED
+// Last control ticks in RTC memory; survives soft resets, panics, watchdog and brownout resets.
+static FlightRecorder flightRecorder(flightRecorderRtcStore);
+static uint32_t loopMaxUsSinceTick = 0;
+static bool flightRecorderPublishPending = false;
+static constexpr size_t FLIGHT_RECORDER_LOG_TICKS = 16;
+static constexpr size_t FLIGHT_RECORDER_MQTT_TICKS = 12; // keeps the payload below the 1024 byte MQTT buffer
+#endif
+
+// Heap allocation counters (usb_heaptrace); control tick and publish must not allocate once settled.
+static unsigned long heapSteadyStateAtMs = 0;
+static unsigned long lastHeapWarnMs = 0;
+static uint32_t reportedHeapViolations = 0;
+
+#if FEATURE_TASK_MONITOR_ENABLED
+// FreeRTOS task CPU shares and stack high-water marks, served on /tasks.json and published to <base>/Tasks.
+static TaskMonitor taskMonitor;
+static bool taskMonitorPublishPending = false;
+static unsigned long nextTaskMonitorPublishMs = 0;
+static bool taskStackWarned = false;
+static constexpr unsigned long TASK_MONITOR_PUBLISH_PERIOD_MS = 60000UL;
+static constexpr uint32_t TASK_STACK_WARN_BYTES = 512;
+#endif
+
 #pragma endregion configurationn variables
 
 //----------------------------------------
@@ -459,12 +638,17 @@ static bool normalizingNegativePriceSettings = false;
 
 void setup()
 {
+    const uint32_t bootStartUs = micros();
     Serial.begin(115200);
+    heapTraceBegin();
     ensureNvsReady();
 
     setupLogging();
     lmg.scopedTag("SETUP");
     lmg.logTag(LL::Info, "SETUP", "Reset reason: %s (%d)", resetReasonToText(esp_reset_reason()), static_cast<int>(esp_reset_reason()));
+#if FEATURE_FLIGHT_RECORDER_ENABLED
+    setupFlightRecorder();
+#endif
     lmg.log("System setup start...");
 
     ConfigManager.setAppName(APP_NAME);
@@ -483,51 +667,148 @@ void setup()
     registerIOBindings();
     setupMqtt();
 
+    // RS485 pins and the safe setpoint are settings, so loading them is the only step before the inverter.
     ConfigManager.checkSettingsForErrors();
     ConfigManager.loadAll();
     normalizeNegativePriceSettings(NegativePriceSettingPreference::None, true, true);
-    syncStoredCodeVersion();
-    delay(100);
-    setupNetworkDefaults();
-    ioManager.begin();
-
-    ConfigManager.startWebServer();
-
-    ConfigManager.enableSmartRoaming(true);
-    ConfigManager.setRoamingThreshold(-75);
-    ConfigManager.setRoamingCooldown(30);
-    ConfigManager.setRoamingImprovement(10);
-    applyAccessPointMacPriority();
-
-    updateMqttTopics();
-    setupGUI();
-#if FEATURE_OLED_DISPLAY_ENABLED
-    SetupStartDisplay();
-    ShowDisplayOn();
+    refreshLimiterParams();
+    restoreControllerCheckpoint();
+    esp_register_shutdown_handler(flushSettingsOnShutdown);
+#if FEATURE_CONTROL_LOG_ENABLED
+    esp_register_shutdown_handler(flushControlLogOnShutdown);
 #endif
+    esp_register_shutdown_handler(saveControllerCheckpoint);
+    const uint32_t rs485StartUs = micros();
+    bootSequence.record("settings", bootStartUs, rs485StartUs);
 
-    cm::helpers::pulseWait(LED_BUILTIN, cm::helpers::PulseOutput::ActiveLevel::ActiveHigh, 3, 100);
-
-    if (!limiterSettings.usePidSmoothing.get())
+    RS485begin();
+    sendBootSafeSetpoint();
+    if (!limiterParams.current().usePid)
     {
         ensurePowerSmoother(currentGridImportW);
     }
+    armRS485Ticker(limiterParams.current().publishPeriodSec);
+    bootSequence.record("rs485", rs485StartUs, micros());
 
-    RS485begin();
-#if FEATURE_BME280_ENABLED
-    SetupStartTemperatureMeasuring();
-#endif
-
-    RS485Ticker.attach(limiterSettings.RS232PublishPeriod.get(), cb_RS485Listener);
+    queueBootStages();
+    lmg.logTag(LL::Info, "SETUP", "Inverter commanded to %d W after %lu ms, continuing startup in the background",
+               inverterSetValue, static_cast<unsigned long>(bootSequence.safeSetpointUs() / 1000UL));
+}
 
+static void queueBootStages()
+{
+    bootSequence.add("version", syncStoredCodeVersion);
+    bootSequence.add("defaults", []()
+                     {
+        setupNetworkDefaults();
+        ioManager.begin();
 #if FEATURE_FAN_ENABLED
-    setFanRelay(false);
+        setFanRelay(false);
 #endif
 #if FEATURE_HEATER_ENABLED
-    setHeaterRelay(false);
+        setHeaterRelay(false);
+#endif
+    });
+    bootSequence.add("webserver", []()
+                     {
+        ConfigManager.startWebServer();
+        ConfigManager.enableSmartRoaming(true);
+        ConfigManager.setRoamingThreshold(-75);
+        ConfigManager.setRoamingCooldown(30);
+        ConfigManager.setRoamingImprovement(10);
+        applyAccessPointMacPriority(); });
+    bootSequence.add("gui", []()
+                     {
+        updateMqttTopics();
+        setupGUI();
+#if FEATURE_LIVE_PUSH_ENABLED
+        setupLivePush();
+#endif
+    });
+    bootSequence.add("routes", []()
+                     {
+#if FEATURE_HISTORY_ENABLED
+        registerHistoryRoutes(server, historyStore);
+#endif
+        registerWebAssets(server);
+#if FEATURE_CONTROL_LOG_ENABLED
+        controlLog.begin();
+        registerControlLogRoutes(server, controlLog);
 #endif
+#if FEATURE_BINLOG_ENABLED
+        registerBinLogRoutes(server, binLog);
+#endif
+#if FEATURE_FLIGHT_RECORDER_ENABLED
+        registerFlightRecorderRoutes(server, flightRecorder);
+#endif
+        registerSettingsSaverRoutes(server, settingsSaver);
+        registerBootSequenceRoutes(server, bootSequence);
+#if FEATURE_HEAP_STATS_ENABLED
+        registerHeapTraceRoutes(server);
+#endif
+#if FEATURE_TASK_MONITOR_ENABLED
+        registerTaskMonitorRoutes(server, taskMonitor);
+#endif
+#if defined(CPU_PROFILER_ENABLED)
+        registerCpuProfilerRoutes(server);
+#endif
+    });
+#if FEATURE_ANY_I2C
+    bootSequence.add("i2c", []()
+                     {
+        i2cBus.begin(i2cSettings.sdaPin.get(), i2cSettings.sclPin.get(), static_cast<uint32_t>(i2cSettings.busFreq.get()));
+        registerI2CBusRoutes(server, i2cBus); });
+#endif
+#if FEATURE_OLED_DISPLAY_ENABLED
+    bootSequence.add("display", []()
+                     {
+        SetupStartDisplay();
+        ShowDisplayOn(); });
+#endif
+#if FEATURE_BME280_ENABLED
+    bootSequence.add("bme280", SetupStartTemperatureMeasuring);
+#endif
+}
 
-    lmg.logTag(LL::Info, "SETUP", "Completed successfully. Starting main loop...");
+static void finishBoot()
+{
+    if (limiterCore.pid().initialized)
+    {
+        limiterCore.pid().lastUpdateMs = millis(); // restored PID: no integration over the startup time
+    }
+    heapSteadyStateAtMs = millis() + HEAP_TRACE_SETTLE_MS;
+#if FEATURE_TASK_MONITOR_ENABLED
+    if (!taskMonitor.begin())
+    {
+        lmg.logTag(LL::Warn, "TASKS", "Task monitor unavailable (FreeRTOS trace facility not enabled)");
+    }
+#endif
+    for (size_t i = 0; i < bootSequence.timingCount(); ++i)
+    {
+        const BootStageTiming &t = bootSequence.timing(i);
+        lmg.logTag(LL::Debug, "BOOT", "%-10s at %6lu ms took %5lu ms", t.name,
+                   static_cast<unsigned long>(t.startUs / 1000UL), static_cast<unsigned long>(t.durationUs / 1000UL));
+    }
+    lmg.logTag(LL::Info, "SETUP", "Completed after %lu ms (safe setpoint at %lu ms). Starting main loop...",
+               static_cast<unsigned long>(bootSequence.completedUs() / 1000UL),
+               static_cast<unsigned long>(bootSequence.safeSetpointUs() / 1000UL));
+#if defined(APP_LOG_BENCHMARK)
+    runLogBenchmark();
+#endif
+#if defined(KERNEL_BENCHMARK)
+    runKernelBenchmark();
+#endif
+#if defined(CPU_PROFILER_ENABLED)
+    if (cpuProfilerBegin())
+    {
+        lmg.logTag(LL::Info, "PROF", "CPU profiler ready at %lu Hz per core (POST /profiler/start, GET /profile.bin)",
+                   static_cast<unsigned long>(cpuProfilerStatus().tickHz));
+    }
+    else
+    {
+        lmg.logTag(LL::Error, "PROF", "CPU profiler: tick hook registration failed");
+    }
+#endif
 }
 
 static bool ensureNvsReady()
@@ -560,20 +841,49 @@ static bool ensureNvsReady()
 
 void loop()
 {
+    if (!bootSequence.done())
+    {
+        // Keep commanding the safe setpoint until the network, MQTT inputs and services are up.
+        refreshLimiterParams();
+        if (rs485TickDue)
+        {
+            rs485TickDue = false;
+            sendBootSafeSetpoint();
+        }
+        if (!bootSequence.runNext())
+        {
+            finishBoot();
+        }
+        lmg.loop();
+        return;
+    }
+
+#if FEATURE_FLIGHT_RECORDER_ENABLED
+    const uint32_t loopStartUs = micros();
+#endif
+    HeapTraceScope heapLoopScope(HeapTag::Loop);
     ConfigManager.getWiFiManager().update();
     mqtt.loop();
+    observeMeterReadings();
     publishMqttNow();
+    refreshLimiterParams();
     handleRS485Scheduler();
 #if FEATURE_BME280_ENABLED
-    const bool temperatureUpdated = handleTemperatureScheduler();
-#else
-    const bool temperatureUpdated = false;
+    handleTemperatureScheduler();
 #endif
     lmg.loop();
     ioManager.update();
+    settingsSaver.service(millis());
+    serviceHeapTrace();
+#if FEATURE_TASK_MONITOR_ENABLED
+    serviceTaskMonitor();
+#endif
 
     // Services managed by ConfigManager.
     ConfigManager.handleClient();
+#if FEATURE_LIVE_PUSH_ENABLED
+    livePush.update();
+#endif
     alarmManager.update();
 
     updateStatusLED();
@@ -584,6 +894,22 @@ void loop()
     handleDisplayPowerScheduler();
 #endif
 
+#if FEATURE_ANY_I2C
+    // A control tick that became due during this pass runs first on the next pass;
+    // queued display/sensor transfers wait for the following slice.
+    if (!rs485TickDue)
+    {
+        i2cBus.service(I2C_BUS_SLICE_US);
+    }
+#endif
+
+#if FEATURE_BME280_ENABLED
+    const bool temperatureUpdated = temperatureUpdatePending;
+    temperatureUpdatePending = false;
+#else
+    const bool temperatureUpdated = false;
+#endif
+
 #if FEATURE_ANY_RELAY_OUTPUTS
     if (temperatureUpdated && !manualOverrideActive)
     {
@@ -595,6 +921,14 @@ void loop()
 #endif
     }
 #endif
+
+#if FEATURE_FLIGHT_RECORDER_ENABLED
+    const uint32_t loopUs = micros() - loopStartUs;
+    if (loopUs > loopMaxUsSinceTick)
+    {
+        loopMaxUsSinceTick = loopUs;
+    }
+#endif
     delay(10);
 }
 
@@ -803,6 +1137,38 @@ void setupGUI()
     // endregion relay outputs
 }
 
+#if FEATURE_LIVE_PUSH_ENABLED
+static void setupLivePush()
+{
+    // Same values as the runtime cards above, pushed as deltas over /ws/live.
+    livePush.addField("gridIn", []() -> float
+                      { return currentGridImportW; });
+    livePush.addField("invSet", []() -> float
+                      { return inverterSetValue; });
+    livePush.addField("invCalc", []() -> float
+                      { return inverterCalculatedValue; });
+    livePush.addField("solar", []() -> float
+                      { return solarPowerW; });
+    livePush.addField("enabled", []() -> float
+                      { return limiterSettings.enableController.get() ? 1.0f : 0.0f; });
+    livePush.addField("negPrice", []() -> float
+                      { return negativePriceActive ? 1.0f : 0.0f; });
+    livePush.addField("price", []() -> float
+                      { return electricityPriceEurKwh; }, 3);
+#if FEATURE_BME280_ENABLED
+    livePush.addField("temp", []() -> float
+                      { return temperature; }, 1);
+    livePush.addField("hum", []() -> float
+                      { return Humidity; }, 1);
+    livePush.addField("dew", []() -> float
+                      { return Dewpoint; }, 1);
+    livePush.addField("pressure", []() -> float
+                      { return Pressure; }, 1);
+#endif
+    livePush.begin(server);
+}
+#endif
+
 //----------------------------------------
 // LOGGING / IO / MQTT SETUP
 //----------------------------------------
@@ -831,23 +1197,27 @@ static void setupLogging()
 {
     Serial.begin(115200);
 
+    constexpr LL serialLevel = LL::Off;   // LL::Info, LL::Debug
+    constexpr LL globalLevel = LL::Debug; // LL::Info
+    constexpr LL guiLevel = LL::Debug;    // LL::Info
+
     auto serialOut = std::make_unique<cm::LoggingManager::SerialOutput>(Serial);
-    serialOut->setLevel(LL::Off);
-    // serialOut->setLevel(LL::Info);
-    // serialOut->setLevel(LL::Debug);
+    serialOut->setLevel(serialLevel);
     serialOut->addTimestamp(cm::LoggingManager::Output::TimestampMode::DateTime);
     serialOut->setRateLimitMs(2);
     lmg.addOutput(std::move(serialOut));
 
-    // lmg.setGlobalLevel(LL::Info);
-    lmg.setGlobalLevel(LL::Debug);
+    lmg.setGlobalLevel(globalLevel);
     lmg.attachToConfigManager(LL::Info, LL::Debug, "");
 
     auto guiOut = std::make_unique<cm::LoggingManager::GuiOutput>(ConfigManager, 20);
     guiOut->addTimestamp(cm::LoggingManager::Output::TimestampMode::DateTime);
-    // guiOut->setLevel(LL::Info);
-    guiOut->setLevel(LL::Debug);
+    guiOut->setLevel(guiLevel);
     lmg.addOutput(std::move(guiOut));
+
+    // Runtime gate for APP_LOG_* call sites: the most verbose output, capped by the global level.
+    const uint8_t outputLevel = max(appLogFromCm(serialLevel), appLogFromCm(guiLevel));
+    appLogRuntimeLevel = min(outputLevel, appLogFromCm(globalLevel));
 }
 
 static void registerIOBindings()
@@ -953,13 +1323,15 @@ static void setupMqtt()
     mqtt.attach(ConfigManager);
     mqtt.addMQTTRuntimeProviderToGUI(ConfigManager, "mqtt");
     mqtt.addMqttSettingsToSettingsGroup(ConfigManager, "MQTT", "MQTT Settings", 40);
+    // A new base topic is picked up by the next publishMqttNow(), without waiting for a reconnect.
+    mqttSettings.publishTopicBase.setCallback([](String) { mqttTopicsConnected = false; });
 
     // Receive: signed grid power W (positive import, negative export)
     mqtt.addTopicReceiveInt(
         "grid_import_w",
         "Grid Power",
         "tele/powerMeter/powerMeter/SENSOR",
-        &currentGridImportW,
+        gridInbox.slot(),
         "W",
         "E320.Power_in");
 
@@ -967,7 +1339,7 @@ static void setupMqtt()
         "solar_power_w",
         "Solar power",
         "tele/tasmota_1DEE45/SENSOR",
-        &solarPowerW,
+        solarInbox.slot(),
         "W",
         "ENERGY.Power");
 
@@ -992,7 +1364,7 @@ static void setupMqtt()
     mqtt.addMqttTopicToSettingsGroup(ConfigManager, "negative_price", "MQTT-Topics", "MQTT-Topics", "MQTT-Received", 52);
     mqtt.addMqttTopicToSettingsGroup(ConfigManager, "electricity_price", "MQTT-Topics", "MQTT-Topics", "MQTT-Received", 53);
 
-    // Optional: show receive topics in runtime UI
+    // Optional: show receive topics in runtime UI (grid/solar would show the emptied inbox, use currentGridImportW/solarPowerW)
     // mqtt.addMqttTopicToLiveGroup(ConfigManager, "grid_import_w", "mqtt", "MQTT-Received", "MQTT-Received", 1);
 
 #if FEATURE_MQTT_LOGGER_ENABLED
@@ -1030,8 +1402,22 @@ static void configureLimiterSettingsBehavior()
     limiterSettings.smoothingSize.showIfFunc = []()
     { return !limiterSettings.usePidSmoothing.get(); };
 
+    limiterSettings.enableController.setCallback([](bool) { limiterParams.markStale(); });
+    limiterSettings.maxOutput.setCallback([](int) { limiterParams.markStale(); });
+    limiterSettings.minOutput.setCallback([](int) { limiterParams.markStale(); });
+    limiterSettings.inputCorrectionOffset.setCallback([](int) { limiterParams.markStale(); });
+    limiterSettings.smoothingSize.setCallback([](int) { limiterParams.markStale(); });
+    limiterSettings.usePidSmoothing.setCallback([](bool) { limiterParams.markStale(); });
+    limiterSettings.pidKp.setCallback([](float) { limiterParams.markStale(); });
+    limiterSettings.pidKi.setCallback([](float) { limiterParams.markStale(); });
+    limiterSettings.pidKd.setCallback([](float) { limiterParams.markStale(); });
+    limiterSettings.RS232PublishPeriod.setCallback([](float) { limiterParams.markStale(); });
+    limiterSettings.bootSafeOutput.setCallback([](int) { limiterParams.markStale(); });
+    limiterSettings.useEstimator.setCallback([](bool) { limiterParams.markStale(); });
+
     limiterSettings.forceMinOnNegativePrice.setCallback([](bool enabled)
                                                         {
+        limiterParams.markStale();
         if (normalizingNegativePriceSettings || !enabled)
         {
             return;
@@ -1041,6 +1427,7 @@ static void configureLimiterSettingsBehavior()
 
     limiterSettings.setZeroOnNegativePrice.setCallback([](bool enabled)
                                                        {
+        limiterParams.markStale();
         if (normalizingNegativePriceSettings || !enabled)
         {
             return;
@@ -1049,22 +1436,75 @@ static void configureLimiterSettingsBehavior()
         normalizeNegativePriceSettings(NegativePriceSettingPreference::SetZero, true, true); });
 }
 
-static void normalizeNegativePriceSettings(NegativePriceSettingPreference preferred, bool persist, bool logCorrection)
+static void refreshLimiterParams()
 {
-    if (!limiterSettings.forceMinOnNegativePrice.get() || !limiterSettings.setZeroOnNegativePrice.get())
+    if (!limiterParams.takeStale())
     {
         return;
     }
 
-    NegativePriceSettingPreference winner = preferred;
-    if (winner == NegativePriceSettingPreference::None)
+    LimiterSettingsValues values;
+    values.controllerEnabled = limiterSettings.enableController.get();
+    values.minOutputW = limiterSettings.minOutput.get();
+    values.maxOutputW = limiterSettings.maxOutput.get();
+    values.correctionOffsetW = limiterSettings.inputCorrectionOffset.get();
+    values.smoothingSize = limiterSettings.smoothingSize.get();
+    values.usePid = limiterSettings.usePidSmoothing.get();
+    values.pidKp = limiterSettings.pidKp.get();
+    values.pidKi = limiterSettings.pidKi.get();
+    values.pidKd = limiterSettings.pidKd.get();
+    values.forceMinOnNegativePrice = limiterSettings.forceMinOnNegativePrice.get();
+    values.setZeroOnNegativePrice = limiterSettings.setZeroOnNegativePrice.get();
+    values.publishPeriodSec = limiterSettings.RS232PublishPeriod.get();
+    values.bootSafeOutputW = limiterSettings.bootSafeOutput.get();
+    values.useEstimator = limiterSettings.useEstimator.get();
+    limiterParams.publish(buildLimiterParams(values, ++limiterParamsGeneration));
+
+    const LimiterParams &params = limiterParams.current();
+    lmg.logTag(LL::Debug, "LIMIT", "Parameters #%lu: %d..%d W, offset %d W, %s, period %.2f s",
+               static_cast<unsigned long>(params.generation), params.minOutputW, params.maxOutputW, params.correctionOffsetW,
+               params.usePid ? "PID" : "smoother", params.publishPeriodSec);
+    if (rs485TickerPeriodSec > 0.0f && params.publishPeriodSec != rs485TickerPeriodSec)
+    {
+        armRS485Ticker(params.publishPeriodSec);
+        lmg.logTag(LL::Info, "LIMIT", "RS485 period changed -> %.2f s", params.publishPeriodSec);
+    }
+}
+
+static void sendBootSafeSetpoint()
+{
+    if (warmRestartSetpointW >= 0)
+    {
+        inverterSetValue = warmRestartSetpointW;
+    }
+    else
     {
-        winner = lastNegativePriceSettingPreference;
+        inverterSetValue = limiterParams.current().bootSafeOutputW;
+        inverterCalculatedValue = inverterSetValue;
     }
-    if (winner == NegativePriceSettingPreference::None)
+    sendToRS485(static_cast<uint16_t>(inverterSetValue));
+    powerEstimator.setCommand(inverterSetValue, millis());
+    if (bootSequence.safeSetpointUs() == 0)
     {
-        winner = NegativePriceSettingPreference::ForceMin;
+        bootSequence.markSafeSetpoint(micros());
     }
+}
+
+static void armRS485Ticker(float periodSec)
+{
+    RS485Ticker.detach();
+    RS485Ticker.attach(periodSec, cb_RS485Listener);
+    rs485TickerPeriodSec = periodSec;
+}
+
+static void normalizeNegativePriceSettings(NegativePriceSettingPreference preferred, bool persist, bool logCorrection)
+{
+    if (!limiterSettings.forceMinOnNegativePrice.get() || !limiterSettings.setZeroOnNegativePrice.get())
+    {
+        return;
+    }
+
+    const NegativePriceSettingPreference winner = resolveNegativePricePreference(preferred, lastNegativePriceSettingPreference);
 
     normalizingNegativePriceSettings = true;
     if (winner == NegativePriceSettingPreference::SetZero)
@@ -1073,7 +1513,6 @@ static void normalizeNegativePriceSettings(NegativePriceSettingPreference prefer
     }
     else
     {
-        winner = NegativePriceSettingPreference::ForceMin;
         limiterSettings.setZeroOnNegativePrice.set(false);
     }
     normalizingNegativePriceSettings = false;
@@ -1086,7 +1525,8 @@ static void normalizeNegativePriceSettings(NegativePriceSettingPreference prefer
     }
     if (persist)
     {
-        ConfigManager.saveAll();
+        settingsSaver.markDirty(limiterSettings.forceMinOnNegativePrice);
+        settingsSaver.markDirty(limiterSettings.setZeroOnNegativePrice);
     }
 }
 
@@ -1131,24 +1571,30 @@ static void setupNetworkDefaults()
         lmg.log(LL::Debug, "-------------------------------------------------------------");
         wifiSettings.wifiSsid.set(MY_WIFI_SSID);
         wifiSettings.wifiPassword.set(MY_WIFI_PASSWORD);
+        settingsSaver.markDirty(wifiSettings.wifiSsid);
+        settingsSaver.markDirty(wifiSettings.wifiPassword);
 
         // Optional secret fields (not present in every example).
 #ifdef MY_WIFI_IP
         wifiSettings.staticIp.set(MY_WIFI_IP);
+        settingsSaver.markDirty(wifiSettings.staticIp);
 #endif
 #ifdef MY_USE_DHCP
         wifiSettings.useDhcp.set(MY_USE_DHCP);
+        settingsSaver.markDirty(wifiSettings.useDhcp);
 #endif
 #ifdef MY_GATEWAY_IP
         wifiSettings.gateway.set(MY_GATEWAY_IP);
+        settingsSaver.markDirty(wifiSettings.gateway);
 #endif
 #ifdef MY_SUBNET_MASK
         wifiSettings.subnet.set(MY_SUBNET_MASK);
+        settingsSaver.markDirty(wifiSettings.subnet);
 #endif
 #ifdef MY_DNS_IP
         wifiSettings.dnsPrimary.set(MY_DNS_IP);
+        settingsSaver.markDirty(wifiSettings.dnsPrimary);
 #endif
-        ConfigManager.saveAll();
         lmg.log(LL::Debug, "-------------------------------------------------------------");
         lmg.log(LL::Info, "Applied WiFi defaults from secrets");
         lmg.log(LL::Info, "Skipping forced reboot to avoid reset loops");
@@ -1168,14 +1614,18 @@ static void setupNetworkDefaults()
         lmg.log(LL::Debug, "-------------------------------------------------------------");
         mqttSettings.server.set(MY_MQTT_BROKER_IP);
         mqttSettings.port.set(MY_MQTT_BROKER_PORT);
+        settingsSaver.markDirty(mqttSettings.server);
+        settingsSaver.markDirty(mqttSettings.port);
 #ifdef MY_MQTT_USERNAME
         mqttSettings.username.set(MY_MQTT_USERNAME);
+        settingsSaver.markDirty(mqttSettings.username);
 #endif
 #ifdef MY_MQTT_PASSWORD
         mqttSettings.password.set(MY_MQTT_PASSWORD);
+        settingsSaver.markDirty(mqttSettings.password);
 #endif
         mqttSettings.publishTopicBase.set(MY_MQTT_ROOT);
-        ConfigManager.saveAll();
+        settingsSaver.markDirty(mqttSettings.publishTopicBase);
         lmg.log(LL::Debug, "-------------------------------------------------------------");
 #else
         lmg.log(LL::Info, "SETUP: MQTT server is empty; secret/secrets.h does not provide MQTT defaults for this example");
@@ -1219,11 +1669,11 @@ static void syncStoredCodeVersion()
     }
 
     const char *versionKey = systemSettings.version.getKey();
-    const String codeVersion(VERSION);
-    const String storedVersion = prefs.getString(versionKey, "");
-    if (storedVersion != codeVersion)
+    char storedVersion[32] = "";
+    prefs.getString(versionKey, storedVersion, sizeof(storedVersion));
+    if (strcmp(storedVersion, VERSION) != 0)
     {
-        const size_t bytesWritten = prefs.putString(versionKey, codeVersion);
+        const size_t bytesWritten = prefs.putString(versionKey, VERSION);
         if (bytesWritten > 0)
         {
             lmg.logTag(LL::Info, "SETUP", "Stored version synced to %s", VERSION);
@@ -1236,16 +1686,16 @@ static void syncStoredCodeVersion()
     prefs.end();
 }
 
-static bool isValidMacAddress(const String &value)
+static bool isValidMacAddress(const char *value)
 {
-    if (value.length() != 17)
+    if (strlen(value) != 17)
     {
         return false;
     }
 
-    for (int i = 0; i < value.length(); ++i)
+    for (int i = 0; i < 17; ++i)
     {
-        const char c = value.charAt(i);
+        const char c = value[i];
         if ((i + 1) % 3 == 0)
         {
             if (c != ':')
@@ -1269,13 +1719,13 @@ static bool isValidMacAddress(const String &value)
 
 static void applyAccessPointMacPriority()
 {
-    String preferredMac = wifiRoamingSettings.preferredApMac.get();
+    FixedString<24> preferredMac(wifiRoamingSettings.preferredApMac.get().c_str());
     preferredMac.trim();
 
 #if defined(WIFI_FILTER_MAC_PRIORITY)
     if (preferredMac.isEmpty())
     {
-        preferredMac = WIFI_FILTER_MAC_PRIORITY;
+        preferredMac.assign(WIFI_FILTER_MAC_PRIORITY);
     }
 #endif
 
@@ -1285,7 +1735,7 @@ static void applyAccessPointMacPriority()
         return;
     }
 
-    if (!isValidMacAddress(preferredMac))
+    if (preferredMac.truncated() || !isValidMacAddress(preferredMac.c_str()))
     {
         lmg.logTag(LL::Warn, "WiFi", "AP MAC priority invalid: %s", preferredMac.c_str());
         return;
@@ -1323,30 +1773,57 @@ static void updateMqttTopics()
         base = APP_NAME;
     }
 
-    if (base == mqttBaseTopic)
+    if (mqttBaseTopic == base.c_str())
     {
         return;
     }
 
-    mqttBaseTopic = base;
-    topicPublishSetValueW = mqttBaseTopic + "/SetValue";
-    topicPublishCalculatedValueW = mqttBaseTopic + "/CalculatedValue";
-    topicPublishGridImportW = mqttBaseTopic + "/GetValue";
+    mqttBaseTopic.assign(base.c_str());
+    topicPublishSetValueW.format("%s/SetValue", mqttBaseTopic.c_str());
+    topicPublishCalculatedValueW.format("%s/CalculatedValue", mqttBaseTopic.c_str());
+    topicPublishGridImportW.format("%s/GetValue", mqttBaseTopic.c_str());
+    topicPublishHistory.format("%s/History", mqttBaseTopic.c_str());
+#if FEATURE_FLIGHT_RECORDER_ENABLED
+    topicPublishFlightRecorder.format("%s/FlightRecorder", mqttBaseTopic.c_str());
+#endif
+#if FEATURE_TASK_MONITOR_ENABLED
+    topicPublishTasks.format("%s/Tasks", mqttBaseTopic.c_str());
+#endif
 #if FEATURE_BME280_ENABLED
-    topicPublishTempC = mqttBaseTopic + "/Temperature";
-    topicPublishHumidityPct = mqttBaseTopic + "/Humidity";
-    topicPublishDewpointC = mqttBaseTopic + "/Dewpoint";
+    topicPublishTempC.format("%s/Temperature", mqttBaseTopic.c_str());
+    topicPublishHumidityPct.format("%s/Humidity", mqttBaseTopic.c_str());
+    topicPublishDewpointC.format("%s/Dewpoint", mqttBaseTopic.c_str());
 #endif
+    if (mqttBaseTopic.truncated() || topicPublishCalculatedValueW.truncated()) // CalculatedValue is the longest suffix
+    {
+        lmg.logTag(LL::Warn, "MQTT", "Base topic too long (max %u characters with suffix): %s",
+                   static_cast<unsigned>(MqttTopic::capacity()), base.c_str());
+    }
 }
 
 static void publishMqttNow()
 {
+    HeapTraceScope heapScope(HeapTag::Publish);
     if (!mqtt.isConnected())
     {
+        mqttTopicsConnected = false;
+        recordOfflineSample();
         return;
     }
 
-    updateMqttTopics();
+    // The base topic lookup copies Strings, so it runs once per connection instead of per publish.
+    if (!mqttTopicsConnected)
+    {
+        mqttTopicsConnected = true;
+        updateMqttTopics();
+    }
+    flushOfflineQueue();
+#if FEATURE_FLIGHT_RECORDER_ENABLED
+    publishFlightRecorder();
+#endif
+#if FEATURE_TASK_MONITOR_ENABLED
+    publishTaskMonitor();
+#endif
 
     mqtt.publishExtraTopicLazy("setvalue_w", topicPublishSetValueW.c_str(), []() { return String(inverterSetValue); }, false);
     mqtt.publishExtraTopicLazy("calculated_w", topicPublishCalculatedValueW.c_str(), []() { return String(inverterCalculatedValue); }, false);
@@ -1358,63 +1835,224 @@ static void publishMqttNow()
 #endif
 }
 
-static void resetPidController()
+static void recordOfflineSample()
 {
-    pidController.initialized = false;
-    pidController.output = 0.0f;
-    pidController.integral = 0.0f;
-    pidController.previousError = 0.0f;
-    pidController.lastUpdateMs = 0;
+    offlineQueue.record(millis() / 1000UL, inverterSetValue, inverterCalculatedValue, currentGridImportW);
 }
 
-static int computePidStabilizedTarget(int baseTarget, int configuredMin, int configuredMax)
+static void flushOfflineQueue()
 {
-    const unsigned long nowMs = millis();
-    float dtSeconds = limiterSettings.RS232PublishPeriod.get();
+    if (offlineQueue.empty())
+    {
+        return;
+    }
 
-    if (pidController.initialized)
+    const unsigned long now = millis();
+    if (!timeReached(now, nextOfflineFlushMs))
     {
-        const unsigned long elapsedMs = nowMs - pidController.lastUpdateMs;
-        if (elapsedMs > 0)
-        {
-            dtSeconds = static_cast<float>(elapsedMs) / 1000.0f;
-        }
+        return;
     }
+    nextOfflineFlushMs = now + OFFLINE_FLUSH_PACING_MS;
 
-    dtSeconds = constrain(dtSeconds, 0.05f, 10.0f);
+    // Absolute timestamps only once NTP has set the clock, otherwise send sample ages.
+    const time_t epochNow = time(nullptr);
+    const uint32_t epoch = epochNow > 1600000000 ? static_cast<uint32_t>(epochNow) : 0;
 
-    if (!pidController.initialized)
+    static char payload[768];
+    const size_t batch = offlineQueue.buildBatch(payload, sizeof(payload), OFFLINE_FLUSH_BATCH_SAMPLES, now / 1000UL, epoch);
+    if (batch == 0)
     {
-        pidController.initialized = true;
-        pidController.output = constrain(static_cast<float>(baseTarget), static_cast<float>(configuredMin), static_cast<float>(configuredMax));
-        pidController.integral = 0.0f;
-        pidController.previousError = 0.0f;
+        return;
     }
 
-    // PID setpoint is the desired inverter target. PID input is the last commanded target.
-    const float error = static_cast<float>(baseTarget) - pidController.output;
-    const float candidateIntegral = constrain(pidController.integral + error * dtSeconds, -5000.0f, 5000.0f);
-    const float derivative = (error - pidController.previousError) / dtSeconds;
-    const float delta = limiterSettings.pidKp.get() * error +
-                        limiterSettings.pidKi.get() * candidateIntegral +
-                        limiterSettings.pidKd.get() * derivative;
+    if (!mqtt.publish(topicPublishHistory.c_str(), payload, false))
+    {
+        lmg.logTag(LL::Debug, "MQTT", "History flush failed, %u samples pending", static_cast<unsigned>(offlineQueue.size()));
+        return;
+    }
 
-    const float candidateOutput = pidController.output + delta;
-    const float clampedOutput = constrain(candidateOutput, static_cast<float>(configuredMin), static_cast<float>(configuredMax));
+    offlineQueue.drop(batch);
+    if (offlineQueue.empty())
+    {
+        lmg.logTag(LL::Info, "MQTT", "Offline history flushed");
+    }
+}
 
-    if (candidateOutput == clampedOutput ||
-        (candidateOutput > static_cast<float>(configuredMax) && error < 0.0f) ||
-        (candidateOutput < static_cast<float>(configuredMin) && error > 0.0f))
+#if FEATURE_FLIGHT_RECORDER_ENABLED
+static void setupFlightRecorder()
+{
+    const esp_reset_reason_t reason = esp_reset_reason();
+    flightRecorder.begin(static_cast<uint8_t>(reason), resetReasonToText(reason), reason == ESP_RST_POWERON);
+
+    const size_t count = flightRecorder.previousCount();
+    if (count == 0)
     {
-        pidController.integral = candidateIntegral;
+        return;
     }
+    flightRecorderPublishPending = true;
 
-    pidController.output = clampedOutput;
+    const bool crashed = reason == ESP_RST_PANIC || reason == ESP_RST_INT_WDT || reason == ESP_RST_TASK_WDT ||
+                         reason == ESP_RST_WDT || reason == ESP_RST_BROWNOUT;
+    const LL level = crashed ? LL::Warn : LL::Info;
+    lmg.logTag(level, "FDR", "Boot %lu after %s: %u ticks recorded before reset (/flightrec.json)",
+               static_cast<unsigned long>(flightRecorder.bootCount()), flightRecorder.resetReasonText(), static_cast<unsigned>(count));
+    if (!crashed)
+    {
+        return;
+    }
 
-    pidController.previousError = error;
-    pidController.lastUpdateMs = nowMs;
+    for (size_t i = count > FLIGHT_RECORDER_LOG_TICKS ? count - FLIGHT_RECORDER_LOG_TICKS : 0; i < count; ++i)
+    {
+        const FlightTick &t = flightRecorder.previousTick(i);
+        lmg.logTag(LL::Warn, "FDR", "t=%lu grid=%d solar=%d calc=%d set=%d loop=%uus heap=%lu flags=%u",
+                   static_cast<unsigned long>(t.uptimeMs), t.gridW, t.solarW, t.calcW, t.setW,
+                   static_cast<unsigned>(t.loopMaxUs), static_cast<unsigned long>(t.freeHeap), static_cast<unsigned>(t.flags));
+    }
+}
 
-    return static_cast<int>(roundf(pidController.output));
+static void publishFlightRecorder()
+{
+    if (!flightRecorderPublishPending)
+    {
+        return;
+    }
+
+    // Newest ticks only; the full record stays on /flightrec.json.
+    static char payload[144 + FLIGHT_RECORDER_MQTT_TICKS * 64];
+    FlightRecorder::JsonCursor cursor;
+    cursor.lastTicks = FLIGHT_RECORDER_MQTT_TICKS;
+    const size_t length = flightRecorder.readJson(cursor, reinterpret_cast<uint8_t *>(payload), sizeof(payload) - 1);
+    payload[length] = '\0';
+    if (!cursor.done)
+    {
+        lmg.logTag(LL::Warn, "FDR", "MQTT payload truncated, not published");
+        flightRecorderPublishPending = false;
+        return;
+    }
+
+    if (mqtt.publish(topicPublishFlightRecorder.c_str(), payload, false))
+    {
+        flightRecorderPublishPending = false;
+    }
+}
+
+static void recordFlightTick()
+{
+    FlightTick tick = {};
+    tick.uptimeMs = millis();
+    tick.gridW = static_cast<int16_t>(constrain(currentGridImportW, INT16_MIN, INT16_MAX));
+    tick.solarW = static_cast<int16_t>(constrain(solarPowerW, INT16_MIN, INT16_MAX));
+    tick.calcW = static_cast<int16_t>(constrain(inverterCalculatedValue, INT16_MIN, INT16_MAX));
+    tick.setW = static_cast<int16_t>(constrain(inverterSetValue, INT16_MIN, INT16_MAX));
+    tick.loopMaxUs = static_cast<uint16_t>(loopMaxUsSinceTick > UINT16_MAX ? UINT16_MAX : loopMaxUsSinceTick);
+    tick.flags = (limiterParams.current().usePid ? CONTROL_LOG_FLAG_PID : 0) |
+                 (limiterParams.current().controllerEnabled ? CONTROL_LOG_FLAG_ENABLED : 0) |
+                 (negativePriceActive ? CONTROL_LOG_FLAG_NEGATIVE_PRICE : 0);
+    tick.freeHeap = ESP.getFreeHeap();
+    flightRecorder.record(tick);
+    loopMaxUsSinceTick = 0;
+}
+#endif
+
+static int64_t wallClockMs()
+{
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return static_cast<int64_t>(tv.tv_sec) * 1000LL + tv.tv_usec / 1000;
+}
+
+// Shutdown handler: a restart (OTA, reboot from the UI, factory reset) inside the debounce window
+// would otherwise lose the pending keys.
+static void flushSettingsOnShutdown()
+{
+    settingsSaver.flush();
+}
+
+#if FEATURE_CONTROL_LOG_ENABLED
+// Shutdown handler: the open block and the sealed ones waiting for service() would otherwise be lost.
+// Does nothing before the "routes" boot stage opened the partition.
+static void flushControlLogOnShutdown()
+{
+    controlLog.flush();
+}
+#endif
+
+// Shutdown handler: runs inside esp_restart() (OTA, reboot from the UI, factory reset), not after a crash.
+static void saveControllerCheckpoint()
+{
+    ControllerCheckpoint &checkpoint = controllerCheckpointRtc;
+    checkpoint.setpointW = inverterSetValue;
+    checkpoint.calculatedW = inverterCalculatedValue;
+    const PidControllerState &pid = limiterCore.pid();
+    checkpoint.usePid = limiterCore.modeIsPid() ? 1 : 0;
+    checkpoint.pidInitialized = pid.initialized ? 1 : 0;
+    checkpoint.pidOutput = pid.output;
+    checkpoint.pidIntegral = pid.integral;
+    checkpoint.pidPreviousError = pid.previousError;
+    checkpoint.smootherSize = 0;
+    checkpoint.smootherIndex = 0;
+    const Smoother *smoother = limiterCore.smoother();
+    if (!limiterCore.modeIsPid() && smoother != nullptr)
+    {
+        int values[CONTROLLER_CHECKPOINT_SMOOTHER_MAX];
+        int index = 0;
+        const int count = smoother->exportState(values, CONTROLLER_CHECKPOINT_SMOOTHER_MAX, &index);
+        for (int i = 0; i < count; ++i)
+        {
+            checkpoint.smoother[i] = values[i];
+        }
+        checkpoint.smootherSize = static_cast<int16_t>(count);
+        checkpoint.smootherIndex = index;
+    }
+    sealControllerCheckpoint(checkpoint, wallClockMs());
+}
+
+static void restoreControllerCheckpoint()
+{
+    ControllerCheckpoint checkpoint;
+    const CheckpointStatus status = takeControllerCheckpoint(controllerCheckpointRtc, wallClockMs(), checkpoint);
+    if (status != CheckpointStatus::Restored)
+    {
+        if (status != CheckpointStatus::Missing)
+        {
+            lmg.logTag(LL::Info, "WARM", "Controller checkpoint %s -> cold start", checkpointStatusText(status));
+        }
+        return;
+    }
+
+    const LimiterParams &params = limiterParams.current();
+    if ((checkpoint.usePid != 0) != params.usePid)
+    {
+        lmg.logTag(LL::Info, "WARM", "Limiter mode changed since checkpoint -> cold start");
+        return;
+    }
+
+    if (params.usePid)
+    {
+        PidControllerState &pid = limiterCore.pid();
+        pid.initialized = checkpoint.pidInitialized != 0;
+        pid.output = constrain(checkpoint.pidOutput, static_cast<float>(params.minOutputW), static_cast<float>(params.maxOutputW));
+        pid.integral = constrain(checkpoint.pidIntegral, -LIMITER_PID_INTEGRAL_LIMIT, LIMITER_PID_INTEGRAL_LIMIT);
+        pid.previousError = checkpoint.pidPreviousError;
+        pid.lastUpdateMs = millis();
+    }
+    else if (checkpoint.smootherSize > 0 && ensurePowerSmoother(checkpoint.calculatedW))
+    {
+        int values[CONTROLLER_CHECKPOINT_SMOOTHER_MAX];
+        for (int i = 0; i < checkpoint.smootherSize; ++i)
+        {
+            values[i] = checkpoint.smoother[i];
+        }
+        if (!limiterCore.smoother()->restoreState(values, checkpoint.smootherSize, checkpoint.smootherIndex))
+        {
+            lmg.logTag(LL::Debug, "WARM", "Smoothing level changed -> smoother primed with %d W", checkpoint.calculatedW);
+        }
+    }
+    limiterCore.setModeIsPid(params.usePid);
+    inverterCalculatedValue = checkpoint.calculatedW;
+    warmRestartSetpointW = constrain(static_cast<int>(checkpoint.setpointW), 0, params.maxOutputW);
+    lmg.logTag(LL::Info, "WARM", "Warm restart: resuming at %d W (%s, checkpoint %ld ms old)", warmRestartSetpointW,
+               params.usePid ? "PID" : "smoother", static_cast<long>(wallClockMs() - checkpoint.savedAtMs));
 }
 
 //----------------------------------------
@@ -1451,89 +2089,162 @@ static bool timeReached(unsigned long now, unsigned long target)
 
 static bool ensurePowerSmoother(int initialValue)
 {
-    if (powerSmoother != nullptr)
+    if (limiterCore.ensureSmoother(limiterParams.current().smoothingSize, initialValue))
     {
-        if (!powerSmoother->isReady())
-        {
-            delete powerSmoother;
-            powerSmoother = nullptr;
-        }
-        else
-        {
-            return true;
-        }
+        return true;
     }
+    lmg.logTag(LL::Warn, "SMOOTH", "Buffer allocation failed");
+    return false;
+}
 
-    const int requestedSize = limiterSettings.smoothingSize.get();
-    powerSmoother = new (std::nothrow) Smoother(requestedSize);
-    if (powerSmoother == nullptr || !powerSmoother->isReady())
+static void observeMeterReadings()
+{
+    // Messages are only delivered inside mqtt.loop(), which runs just before this in loop(),
+    // so now is their arrival time to within that call.
+    const unsigned long now = millis();
+    int value;
+    if (gridInbox.take(value))
     {
-        delete powerSmoother;
-        powerSmoother = nullptr;
-        lastSmootherRequestedSize = -1;
-        lmg.logTag(LL::Warn, "SMOOTH", "Buffer allocation failed");
-        return false;
+        currentGridImportW = value;
+        powerEstimator.updateGrid(value, now);
+    }
+    if (solarInbox.take(value))
+    {
+        solarPowerW = value;
+        powerEstimator.updateSolar(value, now);
     }
-
-    lastSmootherRequestedSize = requestedSize;
-    powerSmoother->fillBufferOnStart(initialValue);
-    return true;
 }
 
-static bool updatePowerSmootherSizeIfNeeded(int initialValue)
+static void handleRS485Scheduler()
 {
-    if (!ensurePowerSmoother(initialValue) || powerSmoother == nullptr)
+    if (!rs485TickDue)
     {
-        return false;
+        return;
     }
 
-    const int requestedSize = limiterSettings.smoothingSize.get();
-    if (requestedSize == lastSmootherRequestedSize)
+    rs485TickDue = false;
+    processRS485Tick();
+#if FEATURE_CONTROL_LOG_ENABLED
+    // Control log flash work (block write or sector pre-erase) right behind the tick,
+    // the furthest point from the next one.
+    controlLog.service(millis());
+#endif
+}
+
+#if FEATURE_TASK_MONITOR_ENABLED
+static void serviceTaskMonitor()
+{
+    const unsigned long now = millis();
+    if (!taskMonitor.service(now))
     {
-        return powerSmoother->isReady();
+        return;
     }
-
-    const int previousSize = powerSmoother->size();
-    powerSmoother->setBufferSize(requestedSize);
-    lastSmootherRequestedSize = requestedSize;
-    if (powerSmoother->size() != previousSize)
+    if (timeReached(now, nextTaskMonitorPublishMs))
     {
-        powerSmoother->fillBufferOnStart(initialValue);
+        nextTaskMonitorPublishMs = now + TASK_MONITOR_PUBLISH_PERIOD_MS;
+        taskMonitorPublishPending = true;
+    }
+    if (taskStackWarned)
+    {
+        return;
+    }
+    for (size_t i = 0; i < taskMonitor.count(); ++i)
+    {
+        const TaskMonitorEntry &task = taskMonitor.task(i);
+        if (task.stackFreeMinBytes < TASK_STACK_WARN_BYTES)
+        {
+            lmg.logTag(LL::Warn, "TASKS", "Task %s has only %lu B of stack left at its deepest", task.name,
+                       static_cast<unsigned long>(task.stackFreeMinBytes));
+            taskStackWarned = true;
+        }
     }
+}
 
-    return powerSmoother->isReady();
+static void publishTaskMonitor()
+{
+    if (!taskMonitorPublishPending)
+    {
+        return;
+    }
+    static char payload[900]; // below the 1024 byte MQTT buffer together with the topic
+    if (taskMonitor.formatCompactJson(payload, sizeof(payload)) == 0 || mqtt.publish(topicPublishTasks.c_str(), payload, false))
+    {
+        taskMonitorPublishPending = false;
+    }
 }
+#endif
 
-static void handleRS485Scheduler()
+static void serviceHeapTrace()
 {
-    if (!rs485TickDue)
+    if (!heapTraceCompiledIn())
+    {
+        return;
+    }
+    const unsigned long now = millis();
+    if (!heapTraceSteadyState())
     {
+        if (timeReached(now, heapSteadyStateAtMs))
+        {
+            heapTraceArmSteadyState();
+            const HeapCounters totals = heapTraceTotals();
+            lmg.logTag(LL::Info, "HEAP", "Steady state: %lu allocations since boot, free %lu B, largest block %lu B",
+                       static_cast<unsigned long>(totals.allocs), static_cast<unsigned long>(ESP.getFreeHeap()),
+                       static_cast<unsigned long>(heap_caps_get_largest_free_block(MALLOC_CAP_8BIT)));
+        }
         return;
     }
 
-    rs485TickDue = false;
-    processRS485Tick();
+    const HeapScopeStats tick = heapScopeStats(HeapTag::ControlTick);
+    const HeapScopeStats publish = heapScopeStats(HeapTag::Publish);
+    const uint32_t violations = tick.violations + publish.violations;
+    if (violations == reportedHeapViolations || (lastHeapWarnMs != 0 && now - lastHeapWarnMs < HEAP_TRACE_WARN_INTERVAL_MS))
+    {
+        return;
+    }
+    lmg.logTag(LL::Warn, "HEAP", "Allocations in steady state: control tick %lu passes (max %u allocs), publish %lu passes (max %u allocs)",
+               static_cast<unsigned long>(tick.violations), static_cast<unsigned int>(tick.maxAllocs),
+               static_cast<unsigned long>(publish.violations), static_cast<unsigned int>(publish.maxAllocs));
+    reportedHeapViolations = violations;
+    lastHeapWarnMs = now;
 }
 
 #if FEATURE_BME280_ENABLED
-static bool handleTemperatureScheduler()
+static void handleTemperatureScheduler()
 {
     if (!bme280Initialized)
     {
-        return false;
+        return;
     }
 
+    // Collect a finished conversion first, then start the next one when due.
     const unsigned long now = millis();
+    bme280.poll(now);
+
+    Bme280Reading reading;
+    if (bme280.takeReading(reading) && applyBme280Reading(reading))
+    {
+        temperatureUpdatePending = true;
+    }
+    if (bme280.failures() != lastBme280Failures)
+    {
+        lastBme280Failures = bme280.failures();
+        lmg.logTag(LL::Warn, "BME280", "Measurement failed (%lu total) -> keep last", static_cast<unsigned long>(lastBme280Failures));
+    }
+
     if (!timeReached(now, nextTemperatureReadMs))
     {
-        return false;
+        return;
     }
 
     const unsigned long intervalMs = secondsToMsClamped(tempSettings.readIntervalSec.get(),
                                                         MIN_TEMPERATURE_READ_INTERVAL_MS,
                                                         MAX_TEMPERATURE_READ_INTERVAL_MS);
     nextTemperatureReadMs = now + intervalMs;
-    return readBme280();
+
+    if (!bme280.trigger(intervalMs))
+    {
+        APP_LOG_DEBUG("BME280", "Previous measurement pending or I2C queue full -> skip");
+    }
 }
 #endif
 
@@ -1576,105 +2287,114 @@ void cb_RS485Listener()
 
 static void processRS485Tick()
 {
-    int configuredMin = limiterSettings.minOutput.get();
-    int configuredMax = limiterSettings.maxOutput.get();
-    if (configuredMin > configuredMax)
-    {
-        const int tmp = configuredMin;
-        configuredMin = configuredMax;
-        configuredMax = tmp;
-    }
-
-    const bool usePidSmoothing = limiterSettings.usePidSmoothing.get();
-    if (usePidSmoothing != lastLimiterModeWasPid)
-    {
-        resetPidController();
-        if (!usePidSmoothing && ensurePowerSmoother(currentGridImportW))
+    HeapTraceScope heapScope(HeapTag::ControlTick);
+    const LimiterParams &params = limiterParams.current();
+    observeMeterReadings();
+    const uint32_t nowMs = millis();
+    LimiterInputs inputs;
+    inputs.gridW = currentGridImportW;
+    inputs.solarW = solarPowerW;
+    inputs.negativePriceActive = negativePriceActive;
+    if (params.useEstimator && powerEstimator.ready())
+    {
+        // Regulate on the estimate at this instant instead of two readings taken at different times.
+        const PowerEstimate estimate = powerEstimator.estimate(nowMs);
+        inputs.gridW = estimate.gridW;
+        inputs.solarW = estimate.outputW;
+    }
+    const LimiterStep step = limiterCore.step(inputs, params, nowMs);
+
+    if (step.negativePriceTargetW != lastNegativePriceOverrideTarget)
+    {
+        if (step.negativePriceTargetW >= 0)
         {
-            powerSmoother->fillBufferOnStart(currentGridImportW);
-        }
-        lastLimiterModeWasPid = usePidSmoothing;
-    }
-
-    if (!usePidSmoothing)
-    {
-        updatePowerSmootherSizeIfNeeded(currentGridImportW);
-    }
-
-    const int offset = limiterSettings.inputCorrectionOffset.get();
-    const int currentInverterOutputW = solarPowerW;
-    const int signedGridPowerW = currentGridImportW;
-    const int gridImportW = max(signedGridPowerW, 0);
-    const int gridExportW = max(-signedGridPowerW, 0);
-    const bool negativePriceForceMinEnabled = limiterSettings.forceMinOnNegativePrice.get();
-    const bool negativePriceSetZeroEnabled = !negativePriceForceMinEnabled && limiterSettings.setZeroOnNegativePrice.get();
-    const bool negativePriceMinActive = negativePriceActive && negativePriceForceMinEnabled;
-    const bool negativePriceZeroActive = negativePriceActive && negativePriceSetZeroEnabled;
-    const int negativePriceOverrideTarget = negativePriceZeroActive ? 0 : (negativePriceMinActive ? configuredMin : -1);
-    if (negativePriceOverrideTarget != lastNegativePriceOverrideTarget)
-    {
-        if (negativePriceOverrideTarget >= 0)
-        {
-            lmg.logTag(LL::Info, "PRICE", "Negative price active (%.3f EUR/kWh) -> forcing %d W", electricityPriceEurKwh, negativePriceOverrideTarget);
+            lmg.logTag(LL::Info, "PRICE", "Negative price active (%.3f EUR/kWh) -> forcing %d W", electricityPriceEurKwh, step.negativePriceTargetW);
         }
         else
         {
             lmg.logTag(LL::Info, "PRICE", "Negative price inactive (%.3f EUR/kWh) -> resuming normal output path", electricityPriceEurKwh);
         }
-        lastNegativePriceOverrideTarget = negativePriceOverrideTarget;
-    }
-    int pidBaseTarget = 0;
-    int pidClampedBaseTarget = 0;
-    int pidInput = 0;
-
-    if (negativePriceOverrideTarget >= 0)
-    {
-        resetPidController();
-        inverterCalculatedValue = negativePriceOverrideTarget;
+        lastNegativePriceOverrideTarget = step.negativePriceTargetW;
     }
-    else if (usePidSmoothing)
+    if (step.smootherMissing)
     {
-        pidBaseTarget = currentInverterOutputW + signedGridPowerW + offset;
-        pidClampedBaseTarget = constrain(pidBaseTarget, configuredMin, configuredMax);
-        pidInput = pidController.initialized ? static_cast<int>(roundf(pidController.output)) : pidClampedBaseTarget;
-        inverterCalculatedValue = computePidStabilizedTarget(pidBaseTarget, configuredMin, configuredMax);
-    }
-    else if (powerSmoother != nullptr && powerSmoother->isReady())
-    {
-        inverterCalculatedValue = powerSmoother->smooth(currentGridImportW);
-    }
-    else
-    {
-        inverterCalculatedValue = configuredMax;
         lmg.logTag(LL::Warn, "RS485", "Smoother not initialized -> fallback to MAX");
     }
 
-    if (negativePriceOverrideTarget >= 0)
-    {
-        inverterSetValue = negativePriceOverrideTarget;
-        sendToRS485(static_cast<uint16_t>(inverterSetValue));
-    }
-    else if (limiterSettings.enableController.get())
+    inverterCalculatedValue = step.calculatedW;
+    inverterSetValue = step.setW;
+    sendToRS485(static_cast<uint16_t>(inverterSetValue));
+    powerEstimator.setCommand(inverterSetValue, nowMs);
+
+    if (step.path == LimiterPath::Controller)
     {
-        const int correctedValue = usePidSmoothing ? inverterCalculatedValue : inverterCalculatedValue + offset;
-        inverterSetValue = constrain(correctedValue, configuredMin, configuredMax);
-        sendToRS485(static_cast<uint16_t>(inverterSetValue));
-        lmg.logTag(LL::Trace, "RS485", "Controller enabled -> set inverter to %d W (calc=%d, corr=%d)", inverterSetValue, inverterCalculatedValue, correctedValue);
-        if (usePidSmoothing)
+        if (params.useEstimator)
+        {
+            BINLOG_TRACE("EST", "grid raw=%d est=%d solar raw=%d est=%d", currentGridImportW, inputs.gridW, solarPowerW, inputs.solarW);
+        }
+        BINLOG_TRACE("RS485", "Controller enabled -> set inverter to %d W (calc=%d, corr=%d)", inverterSetValue, inverterCalculatedValue, step.correctedW);
+        if (params.usePid)
         {
-            lmg.logTag(LL::Trace, "PID", "inv=%d gridSigned=%d gridIn=%d gridOut=%d off=%d base=%d clamp=%d in=%d out=%d min=%d max=%d set=%d",
-                       currentInverterOutputW, signedGridPowerW, gridImportW, gridExportW, offset, pidBaseTarget, pidClampedBaseTarget,
-                       pidInput, inverterCalculatedValue, configuredMin, configuredMax, inverterSetValue);
+            BINLOG_TRACE("PID", "inv=%d gridSigned=%d gridIn=%d gridOut=%d off=%d base=%d clamp=%d in=%d out=%d min=%d max=%d set=%d",
+                         inputs.solarW, inputs.gridW, max(inputs.gridW, 0), max(-inputs.gridW, 0), params.correctionOffsetW,
+                         step.pidBaseW, step.pidClampedBaseW, step.pidInputW, inverterCalculatedValue, params.minOutputW,
+                         params.maxOutputW, inverterSetValue);
         }
     }
-    else
+    else if (step.path == LimiterPath::Disabled)
+    {
+        APP_LOG_INFO("RS485", "Controller disabled -> using MAX output");
+    }
+
+#if FEATURE_HISTORY_ENABLED
+    recordHistorySample();
+#endif
+#if FEATURE_CONTROL_LOG_ENABLED
+    recordControlLogTick();
+#endif
+#if FEATURE_FLIGHT_RECORDER_ENABLED
+    recordFlightTick();
+#endif
+}
+
+#if FEATURE_HISTORY_ENABLED
+static void recordHistorySample()
+{
+#if FEATURE_BME280_ENABLED
+    const int32_t temperatureDeci = static_cast<int32_t>(lroundf(temperature * 10.0f));
+#else
+    const int32_t temperatureDeci = 0;
+#endif
+    const int32_t values[HistoryStore::CHANNELS] = {currentGridImportW, inverterSetValue, solarPowerW, temperatureDeci};
+    historyStore.addSample(millis() / 1000UL, values);
+}
+#endif
+
+#if FEATURE_CONTROL_LOG_ENABLED
+static void recordControlLogTick()
+{
+    const unsigned long now = millis();
+    if (!timeReached(now, nextControlLogRecordMs))
     {
-        inverterSetValue = configuredMax;
-        resetPidController();
-        lmg.logTag(LL::Info, "RS485", "Controller disabled -> using MAX output");
-        sendToRS485(static_cast<uint16_t>(inverterSetValue));
+        return;
     }
+    nextControlLogRecordMs = now + CONTROL_LOG_RECORD_PERIOD_MS;
+
+    const time_t epochNow = time(nullptr);
+    const bool epochValid = epochNow > 1600000000;
+
+    ControlLogRecord record;
+    record.time = epochValid ? static_cast<uint32_t>(epochNow) : static_cast<uint32_t>(now / 1000UL);
+    record.gridW = static_cast<int16_t>(constrain(currentGridImportW, INT16_MIN, INT16_MAX));
+    record.solarW = static_cast<int16_t>(constrain(solarPowerW, INT16_MIN, INT16_MAX));
+    record.calcW = static_cast<int16_t>(constrain(inverterCalculatedValue, INT16_MIN, INT16_MAX));
+    record.setW = static_cast<int16_t>(constrain(inverterSetValue, INT16_MIN, INT16_MAX));
+    record.flags = (limiterParams.current().usePid ? CONTROL_LOG_FLAG_PID : 0) |
+                   (limiterParams.current().controllerEnabled ? CONTROL_LOG_FLAG_ENABLED : 0) |
+                   (negativePriceActive ? CONTROL_LOG_FLAG_NEGATIVE_PRICE : 0);
+    controlLog.record(record, epochValid);
 }
+#endif
 
 void testRS232()
 {
@@ -1697,17 +2417,8 @@ void testRS232()
 #if FEATURE_BME280_ENABLED
 void SetupStartTemperatureMeasuring()
 {
-    // init BME280 for temperature and humidity sensor
-    bme280.setAddress(BME280_ADDRESS, i2cSettings.sdaPin.get(), i2cSettings.sclPin.get());
-    bool isStatus = bme280.begin(
-        bme280.BME280_STANDBY_0_5,
-        bme280.BME280_FILTER_16,
-        bme280.BME280_SPI3_DISABLE,
-        bme280.BME280_OVERSAMPLING_2,
-        bme280.BME280_OVERSAMPLING_16,
-        bme280.BME280_OVERSAMPLING_1,
-        bme280.BME280_MODE_NORMAL);
-    if (!isStatus)
+    // init BME280 for temperature and humidity sensor (forced mode, sleeps between readings)
+    if (!bme280.begin(BME280_I2C_ADDRESS))
     {
         bme280Initialized = false;
         lmg.logTag(LL::Error, "BME280", "BME280 init failed");
@@ -1717,10 +2428,8 @@ void SetupStartTemperatureMeasuring()
         bme280Initialized = true;
         lmg.logTag(LL::Info, "BME280", "BME280 ready. Starting measurement scheduler...");
 
-        readBme280();
-        nextTemperatureReadMs = millis() + secondsToMsClamped(tempSettings.readIntervalSec.get(),
-                                                              MIN_TEMPERATURE_READ_INTERVAL_MS,
-                                                              MAX_TEMPERATURE_READ_INTERVAL_MS);
+        // first conversion starts now; the result is collected by handleTemperatureScheduler()
+        nextTemperatureReadMs = millis();
     }
 }
 #endif
@@ -1746,23 +2455,11 @@ void onWiFiAPMode()
 }
 
 #if FEATURE_BME280_ENABLED
-bool readBme280()
+bool applyBme280Reading(const Bme280Reading &reading)
 {
-    if (!bme280Initialized)
-    {
-        lmg.logTag(LL::Warn, "BME280", "Skip read: sensor not initialized");
-        return false;
-    }
-
-    // todo: add settings for correcting the values!!!
-    //   set sea-level pressure
-    bme280.setSeaLevelPressure(tempSettings.seaLevelPressure.get());
-
-    bme280.read();
-
-    const float measuredTemperature = bme280.data.temperature + tempSettings.tempCorrection.get();
-    const float measuredHumidity = bme280.data.humidity + tempSettings.humidityCorrection.get();
-    const float measuredPressure = bme280.data.pressure;
+    const float measuredTemperature = reading.temperatureC + tempSettings.tempCorrection.get();
+    const float measuredHumidity = reading.humidityPct + tempSettings.humidityCorrection.get();
+    const float measuredPressure = reading.pressureHpa;
 
     const bool temperatureValid = isfinite(measuredTemperature) && measuredTemperature >= -20.0f && measuredTemperature <= 70.0f;
     const bool humidityValid = isfinite(measuredHumidity) && measuredHumidity >= 0.0f && measuredHumidity <= 100.0f;
@@ -1780,13 +2477,15 @@ bool readBme280()
     Dewpoint = cm::helpers::computeDewPoint(temperature, Humidity);
 
     // output formatted values to serial console
-    lmg.logTag(LL::Trace, "BME280", "-----------------------");
-    lmg.logTag(LL::Trace, "BME280", "Temperature: %.1f C", temperature);
-    lmg.logTag(LL::Trace, "BME280", "Humidity   : %.1f %%", Humidity);
-    lmg.logTag(LL::Trace, "BME280", "Dewpoint   : %.1f C", Dewpoint);
-    lmg.logTag(LL::Trace, "BME280", "Pressure   : %.0f hPa", Pressure);
-    lmg.logTag(LL::Trace, "BME280", "Altitude   : %.2f m", bme280.data.altitude);
-    lmg.logTag(LL::Trace, "BME280", "-----------------------");
+    APP_LOG_TRACE("BME280", "-----------------------");
+    APP_LOG_TRACE("BME280", "Temperature: %.1f C", temperature);
+    APP_LOG_TRACE("BME280", "Humidity   : %.1f %%", Humidity);
+    APP_LOG_TRACE("BME280", "Dewpoint   : %.1f C", Dewpoint);
+    APP_LOG_TRACE("BME280", "Pressure   : %.0f hPa", Pressure);
+    APP_LOG_TRACE("BME280", "Altitude   : %.2f m",
+                  44330.0f * (1.0f - powf(Pressure / static_cast<float>(tempSettings.seaLevelPressure.get()), 0.1903f)));
+    APP_LOG_TRACE("BME280", "Conversion : %lu ms", static_cast<unsigned long>(bme280.conversionTimeMs()));
+    APP_LOG_TRACE("BME280", "-----------------------");
     return true;
 }
 #endif
@@ -1822,11 +2521,8 @@ static void handleDisplayPowerScheduler()
 
 void SetupStartDisplay()
 {
-    Wire.begin(i2cSettings.sdaPin.get(), i2cSettings.sclPin.get());
-    Wire.setClock(i2cSettings.busFreq.get());
-
     const uint8_t address = static_cast<uint8_t>(i2cSettings.displayAddr.get());
-    if (!display.begin(SSD1306_SWITCHCAPVCC, address))
+    if (!oledPanel.begin(address))
     {
         displayInitialized = false;
         displayActive = false;
@@ -1837,13 +2533,12 @@ void SetupStartDisplay()
     displayInitialized = true;
     displayActive = true;
 
-    display.clearDisplay();
-    display.drawRect(0, 0, 128, 25, WHITE);
-    display.setTextSize(2);
-    display.setTextColor(WHITE);
-    display.setCursor(10, 5);
-    display.println("Starting!");
-    display.display();
+    display.clear();
+    display.setFrame(3);
+    display.setLine(1, "      Starting!");
+    display.invalidate();
+    display.flush(oledPanel);
+    i2cBus.service(UINT32_MAX); // setup: show the splash now, the queue starts empty for loop()
 }
 
 void WriteToDisplay()
@@ -1853,62 +2548,66 @@ void WriteToDisplay()
         return; // exit the function if the display is not active
     }
 
-    // display.clearDisplay();
-    display.fillRect(0, 0, 128, 24, BLACK); // Clear the previous message area
-    display.drawRect(0, 0, 128, 24, WHITE);
-
-    display.setTextSize(1);
-    display.setTextColor(WHITE);
+    char line[OLED_TEXT_COLS + 1];
 
     // When running in AP mode, show connection info prominently.
     if (WiFi.getMode() == WIFI_AP && WiFi.status() != WL_CONNECTED)
     {
         const IPAddress apIp = WiFi.softAPIP();
-        const String apSsid = WiFi.softAPSSID();
 
-        display.setCursor(3, 3);
-        display.printf("AP: %s", apIp.toString().c_str());
-        display.setCursor(3, 13);
-        display.printf("SSID: %s", apSsid.c_str());
-        display.display();
-        return;
-    }
-
-    display.setCursor(3, 3);
-#if FEATURE_BME280_ENABLED
-    if (temperature > 0)
-    {
-        display.printf("<- %d W|Temp: %2.1f", currentGridImportW, temperature);
+        snprintf(line, sizeof(line), "AP: %u.%u.%u.%u", apIp[0], apIp[1], apIp[2], apIp[3]);
+        display.setLine(0, line);
+        snprintf(line, sizeof(line), "SSID: %s", WiFi.softAPSSID().c_str());
+        display.setLine(1, line);
     }
     else
     {
-        display.printf("<- %d W", currentGridImportW);
+#if FEATURE_BME280_ENABLED
+        if (temperature > 0)
+        {
+            snprintf(line, sizeof(line), "<- %d W|Temp: %2.1f", currentGridImportW, temperature);
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "<- %d W", currentGridImportW);
+        }
+        display.setLine(0, line);
+
+        if (Dewpoint != 0)
+        {
+            snprintf(line, sizeof(line), "-> %d W|DP-T: %2.1f", inverterSetValue, Dewpoint);
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "-> %d W", inverterSetValue);
+        }
+        display.setLine(1, line);
+#else
+        snprintf(line, sizeof(line), "<- %d W", currentGridImportW);
+        display.setLine(0, line);
+        snprintf(line, sizeof(line), "-> %d W", inverterSetValue);
+        display.setLine(1, line);
+#endif
     }
 
-    display.setCursor(3, 13);
-    if (Dewpoint != 0)
+    // Only cells that changed since the last refresh are queued. A failed transfer
+    // leaves the panel content unknown, so the next refresh resends everything;
+    // a full queue keeps the dirty cells for the next refresh.
+    if (oledPanel.takeRedrawRequest())
     {
-        display.printf("-> %d W|DP-T: %2.1f", inverterSetValue, Dewpoint);
+        display.invalidate();
     }
-    else
+    if (display.flush(oledPanel) < 0)
     {
-        display.printf("-> %d W", inverterSetValue);
+        APP_LOG_DEBUG("Display", "I2C queue full -> retry next refresh");
     }
-#else
-    display.printf("<- %d W", currentGridImportW);
-
-    display.setCursor(3, 13);
-    display.printf("-> %d W", inverterSetValue);
-#endif
-
-    display.display();
 }
 
 void ShowDisplayOn()
 {
     if (!displayInitialized)
         return;
-    display.ssd1306_command(SSD1306_DISPLAYON); // Turn on the display
+    oledPanel.setPower(true); // GDDRAM keeps the last frame while the panel is off
     displayActive = true;
     displayOffAtMs = millis() + secondsToMsClamped(displaySettings.onTimeSec.get(),
                                                    MIN_DISPLAY_ON_MS,
@@ -1920,8 +2619,7 @@ void ShowDisplayOff()
 {
     if (!displayInitialized)
         return;
-    display.ssd1306_command(SSD1306_DISPLAYOFF); // Turn off the display
-    // display.fillRect(0, 0, 128, 24, BLACK); // Clear the previous message area
+    oledPanel.setPower(false); // Turn off the display
 
     if (displaySettings.turnDisplayOff.get())
     {
@@ -0,0 +1,167 @@
+#include <stdarg.h>
+#include <unity.h>
+
+#include "FixedString/FixedString.h"
+
+namespace
+{
+template <size_t N>
+void appendVa(FixedString<N> &text, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    text.vappendf(fmt, args);
+    va_end(args);
+}
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+// --- Truncation --------------------------------------------------------------
+
+void test_assign_cuts_at_capacity()
+{
+    FixedString<8> text("SolarLimiter");
+    TEST_ASSERT_EQUAL_STRING("SolarLim", text.c_str());
+    TEST_ASSERT_EQUAL_UINT32(8, text.length());
+    TEST_ASSERT_TRUE(text.truncated());
+
+    text.assign("Solar");
+    TEST_ASSERT_EQUAL_STRING("Solar", text.c_str());
+    TEST_ASSERT_FALSE(text.truncated());
+}
+
+void test_append_cuts_and_stays_terminated()
+{
+    FixedString<8> text("base");
+    text.append("/topic");
+    TEST_ASSERT_EQUAL_STRING("base/top", text.c_str());
+    TEST_ASSERT_TRUE(text.truncated());
+
+    // Full: further appends change nothing but keep the flag.
+    text.append('x');
+    TEST_ASSERT_EQUAL_STRING("base/top", text.c_str());
+    TEST_ASSERT_EQUAL_UINT32(8, text.length());
+    TEST_ASSERT_TRUE(text.truncated());
+    TEST_ASSERT_EQUAL('\0', text[8]);
+}
+
+void test_append_null_is_ignored()
+{
+    FixedString<8> text("abc");
+    text.append(static_cast<const char *>(nullptr));
+    TEST_ASSERT_EQUAL_STRING("abc", text.c_str());
+    TEST_ASSERT_FALSE(text.truncated());
+}
+
+void test_format_replaces_and_resets_flag()
+{
+    FixedString<6> text;
+    text.format("%d", 1234567);
+    TEST_ASSERT_EQUAL_STRING("123456", text.c_str());
+    TEST_ASSERT_TRUE(text.truncated());
+
+    text.format("%d", -42);
+    TEST_ASSERT_EQUAL_STRING("-42", text.c_str());
+    TEST_ASSERT_EQUAL_UINT32(3, text.length());
+    TEST_ASSERT_FALSE(text.truncated());
+}
+
+// --- vappendf at the capacity boundary ---------------------------------------
+
+void test_vappendf_exact_fit_is_not_truncated()
+{
+    FixedString<8> text("ab");
+    appendVa(text, "%s", "cdefgh"); // 2 + 6 = 8
+    TEST_ASSERT_EQUAL_STRING("abcdefgh", text.c_str());
+    TEST_ASSERT_EQUAL_UINT32(8, text.length());
+    TEST_ASSERT_FALSE(text.truncated());
+}
+
+void test_vappendf_one_over_is_truncated()
+{
+    FixedString<8> text("ab");
+    appendVa(text, "%s", "cdefghi"); // 2 + 7 = 9
+    TEST_ASSERT_EQUAL_STRING("abcdefgh", text.c_str());
+    TEST_ASSERT_EQUAL_UINT32(8, text.length());
+    TEST_ASSERT_TRUE(text.truncated());
+}
+
+void test_vappendf_when_full()
+{
+    FixedString<4> text("abcd");
+    appendVa(text, "%s", "");
+    TEST_ASSERT_EQUAL_STRING("abcd", text.c_str());
+    TEST_ASSERT_FALSE(text.truncated());
+
+    appendVa(text, "%d", 5);
+    TEST_ASSERT_EQUAL_STRING("abcd", text.c_str());
+    TEST_ASSERT_EQUAL_UINT32(4, text.length());
+    TEST_ASSERT_TRUE(text.truncated());
+}
+
+void test_appendf_builds_topic()
+{
+    FixedString<32> topic;
+    topic.appendf("%s/%s", "SolarLimiter", "SetValue");
+    topic.appendf("_%d", 2);
+    TEST_ASSERT_EQUAL_STRING("SolarLimiter/SetValue_2", topic.c_str());
+    TEST_ASSERT_TRUE(topic == "SolarLimiter/SetValue_2");
+    TEST_ASSERT_FALSE(topic.truncated());
+}
+
+// --- trim --------------------------------------------------------------------
+
+void test_trim_both_ends()
+{
+    FixedString<16> text(" \t 123 W\r\n");
+    text.trim();
+    TEST_ASSERT_EQUAL_STRING("123 W", text.c_str());
+    TEST_ASSERT_EQUAL_UINT32(5, text.length());
+}
+
+void test_trim_only_whitespace()
+{
+    FixedString<8> text(" \r\n\t ");
+    text.trim();
+    TEST_ASSERT_TRUE(text.isEmpty());
+    TEST_ASSERT_EQUAL_STRING("", text.c_str());
+}
+
+void test_trim_without_whitespace_and_empty()
+{
+    FixedString<8> text("abc");
+    text.trim();
+    TEST_ASSERT_EQUAL_STRING("abc", text.c_str());
+
+    FixedString<8> empty;
+    empty.trim();
+    TEST_ASSERT_TRUE(empty.isEmpty());
+}
+
+void test_trim_full_buffer()
+{
+    FixedString<6> text("  ab  ");
+    text.trim();
+    TEST_ASSERT_EQUAL_STRING("ab", text.c_str());
+    TEST_ASSERT_EQUAL('\0', text[2]);
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_assign_cuts_at_capacity);
+    RUN_TEST(test_append_cuts_and_stays_terminated);
+    RUN_TEST(test_append_null_is_ignored);
+    RUN_TEST(test_format_replaces_and_resets_flag);
+    RUN_TEST(test_vappendf_exact_fit_is_not_truncated);
+    RUN_TEST(test_vappendf_one_over_is_truncated);
+    RUN_TEST(test_vappendf_when_full);
+    RUN_TEST(test_appendf_builds_topic);
+    RUN_TEST(test_trim_both_ends);
+    RUN_TEST(test_trim_only_whitespace);
+    RUN_TEST(test_trim_without_whitespace_and_empty);
+    RUN_TEST(test_trim_full_buffer);
+    return UNITY_END();
+}
@@ -0,0 +1,241 @@
+#include <stdio.h>
+#include <unity.h>
+
+#include "ControlLog/ControlLogFormat.h"
+#include "FixedString/FixedString.h"
+#include "FlightRecorder/FlightRecorder.h"
+#include "HeapTrace/HeapTrace.h"
+#include "History/HistoryStore.h"
+#include "LimiterCore/LimiterCore.h"
+#include "LimiterParams/LimiterParams.h"
+#include "OfflineQueue/OfflineQueue.h"
+#include "PowerEstimator/PowerEstimator.h"
+#include "RS485Module/RS485Frame.h"
+
+// The portable parts of processRS485Tick() and publishMqttNow() in firmware order, counted by
+// HeapTrace (the native env builds with -DHEAP_TRACE_ENABLED, which replaces operator new/delete).
+// The MQTT client, logging and the web server are not covered; usb_heaptrace watches them on the device.
+
+namespace
+{
+constexpr uint32_t SERIES_LEN = 256;
+constexpr uint32_t TICKS = 2000;
+constexpr uint32_t PUBLISHES = 200;
+
+int gridSeries[SERIES_LEN];
+int solarSeries[SERIES_LEN];
+volatile int sink = 0; // keeps results alive so the compiler cannot drop the work
+
+struct PathState
+{
+    LimiterCore core;
+    PowerEstimator estimator;
+    HistoryStore history;
+    ControlLogBlockBuilder controlLog;
+    uint8_t controlLogBlock[CONTROL_LOG_BLOCK_BYTES];
+    uint32_t controlLogSequence = 0;
+    FlightRecorderStore flightStore;
+    FlightRecorder flight{flightStore};
+    OfflineQueue offline;
+    char payload[768];
+    FixedString<24> value;
+    uint32_t ticks = 0;
+    uint32_t publishes = 0;
+};
+
+PathState state;
+LimiterParams smootherParams;
+LimiterParams pidParams;
+
+// Grid power as a bounded random walk with load steps, solar as a slow ramp.
+void fillInputs()
+{
+    uint32_t seed = 0x1234567u;
+    int grid = 150;
+    for (uint32_t i = 0; i < SERIES_LEN; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        grid += static_cast<int>((seed >> 16) % 201) - 100;
+        if ((seed & 0x1F) == 0)
+        {
+            grid += (seed & 0x20) ? 900 : -900;
+        }
+        grid = grid < -1500 ? -1500 : (grid > 2500 ? 2500 : grid);
+        gridSeries[i] = grid;
+        solarSeries[i] = 200 + static_cast<int>(i * 3) % 500;
+    }
+}
+
+LimiterParams makeParams(bool usePid, int smoothingSize)
+{
+    LimiterSettingsValues values;
+    values.minOutputW = 0;
+    values.maxOutputW = 800;
+    values.correctionOffsetW = 30;
+    values.smoothingSize = smoothingSize;
+    values.usePid = usePid;
+    values.pidKp = 0.5f;
+    values.pidKi = 0.1f;
+    values.pidKd = 0.05f;
+    values.publishPeriodSec = 2.0f;
+    return buildLimiterParams(values, 1);
+}
+
+// processRS485Tick(): readings into the estimator, control step, frame and hex dump, then the
+// per-tick recorders (history, control log RAM block, flight recorder).
+void runTickPath(PathState &st, const LimiterParams &params)
+{
+    const uint32_t i = st.ticks++;
+    const uint32_t nowMs = i * 2000u;
+    const int gridW = gridSeries[i % SERIES_LEN];
+    const int solarW = solarSeries[i % SERIES_LEN];
+    st.estimator.updateGrid(gridW, nowMs);
+    st.estimator.updateSolar(solarW, nowMs);
+
+    LimiterInputs inputs;
+    const PowerEstimate estimate = st.estimator.estimate(nowMs);
+    inputs.gridW = estimate.gridW;
+    inputs.solarW = estimate.outputW;
+    const LimiterStep step = st.core.step(inputs, params, nowMs);
+
+    uint8_t frame[RS485_FRAME_BYTES];
+    char hex[RS485_FRAME_BYTES * 3 + 1];
+    encodeSetpointFrame(static_cast<uint16_t>(step.setW), frame);
+    formatHexBytes(frame, RS485_FRAME_BYTES, hex, sizeof(hex));
+    st.estimator.setCommand(step.setW, nowMs);
+
+    const int32_t values[HistoryStore::CHANNELS] = {gridW, step.setW, solarW, 215};
+    st.history.addSample(nowMs / 1000u, values);
+
+    if (i % 5 == 0) // every 10 s, like recordControlLogTick()
+    {
+        ControlLogRecord record;
+        record.time = nowMs / 1000u;
+        record.gridW = static_cast<int16_t>(gridW);
+        record.solarW = static_cast<int16_t>(solarW);
+        record.calcW = static_cast<int16_t>(step.calculatedW);
+        record.setW = static_cast<int16_t>(step.setW);
+        if (!st.controlLog.add(record))
+        {
+            st.controlLog.encode(st.controlLogBlock, st.controlLogSequence++, false);
+            st.controlLog.reset();
+            st.controlLog.add(record);
+        }
+    }
+
+    FlightTick tick = {};
+    tick.uptimeMs = nowMs;
+    tick.gridW = static_cast<int16_t>(gridW);
+    tick.solarW = static_cast<int16_t>(solarW);
+    tick.calcW = static_cast<int16_t>(step.calculatedW);
+    tick.setW = static_cast<int16_t>(step.setW);
+    st.flight.record(tick);
+    sink = step.setW + hex[0];
+}
+
+// publishMqttNow() after an outage: the offline queue is flushed in batches, the flight
+// recorder JSON is built and the values are formatted.
+void runPublishPath(PathState &st)
+{
+    const uint32_t i = st.publishes++;
+    const uint32_t baseSec = i * 400u;
+    for (uint32_t n = 0; n < 40; ++n)
+    {
+        st.offline.record(baseSec + n * 10u, 300 + static_cast<int>(n), 310, gridSeries[n % SERIES_LEN]);
+    }
+    while (!st.offline.empty())
+    {
+        const size_t batch = st.offline.buildBatch(st.payload, sizeof(st.payload), 16, baseSec + 400u, 1750000000u);
+        if (batch == 0)
+        {
+            break;
+        }
+        st.offline.drop(batch);
+    }
+
+    FlightRecorder::JsonCursor cursor;
+    cursor.lastTicks = 12;
+    const size_t length = st.flight.readJson(cursor, reinterpret_cast<uint8_t *>(st.payload), sizeof(st.payload) - 1);
+    st.payload[length] = '\0';
+
+    st.value.format("%d", gridSeries[i % SERIES_LEN]);
+    sink = static_cast<int>(length + st.value.length());
+}
+
+// Startup work outside the measurement: the smoother allocates its window on the first step,
+// and the flight recorder needs a previous run to publish.
+void warmUp()
+{
+    fillInputs();
+    smootherParams = makeParams(false, 10);
+    pidParams = makeParams(true, 1);
+    state.flight.begin(0, "POWERON", true);
+    for (uint32_t i = 0; i < FLIGHT_RECORDER_TICKS; ++i)
+    {
+        runTickPath(state, smootherParams);
+    }
+    state.flight.begin(12, "SW_CPU", false);
+}
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_heap_trace_is_compiled_in()
+{
+    TEST_ASSERT_TRUE(heapTraceCompiledIn());
+}
+
+// Guards the tests below: without a working counter they would pass for the wrong reason.
+void test_allocation_is_counted()
+{
+    static int *volatile probe = nullptr;
+    HeapTraceScope scope(HeapTag::Bench);
+    probe = new int(1);
+    delete probe;
+    TEST_ASSERT_EQUAL_UINT32(1, scope.allocs());
+}
+
+void test_tick_path_smoother_does_not_allocate()
+{
+    HeapTraceScope scope(HeapTag::ControlTick);
+    for (uint32_t i = 0; i < TICKS; ++i)
+    {
+        runTickPath(state, smootherParams);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, scope.allocs());
+}
+
+void test_tick_path_pid_does_not_allocate()
+{
+    runTickPath(state, pidParams); // mode switch outside the measurement
+    HeapTraceScope scope(HeapTag::ControlTick);
+    for (uint32_t i = 0; i < TICKS; ++i)
+    {
+        runTickPath(state, pidParams);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, scope.allocs());
+}
+
+void test_publish_path_does_not_allocate()
+{
+    HeapTraceScope scope(HeapTag::Publish);
+    for (uint32_t i = 0; i < PUBLISHES; ++i)
+    {
+        runPublishPath(state);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, scope.allocs());
+}
+
+int main(int, char **)
+{
+    heapTraceBegin();
+    warmUp();
+    UNITY_BEGIN();
+    RUN_TEST(test_heap_trace_is_compiled_in);
+    RUN_TEST(test_allocation_is_counted);
+    RUN_TEST(test_tick_path_smoother_does_not_allocate);
+    RUN_TEST(test_tick_path_pid_does_not_allocate);
+    RUN_TEST(test_publish_path_does_not_allocate);
+    return UNITY_END();
+}
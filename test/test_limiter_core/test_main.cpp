@@ -0,0 +1,286 @@
+#include <string.h>
+#include <unity.h>
+
+#include "LimiterCore/LimiterCore.h"
+#include "LimiterParams/LimiterParams.h"
+#include "RS485Module/RS485Frame.h"
+
+namespace
+{
+LimiterParams makeParams(bool usePid)
+{
+    LimiterSettingsValues values;
+    values.minOutputW = 0;
+    values.maxOutputW = 800;
+    values.usePid = usePid;
+    values.smoothingSize = 4;
+    values.publishPeriodSec = 1.0f;
+    return buildLimiterParams(values, 1);
+}
+
+LimiterInputs makeInputs(int gridW, int solarW, bool negativePrice = false)
+{
+    LimiterInputs inputs;
+    inputs.gridW = gridW;
+    inputs.solarW = solarW;
+    inputs.negativePriceActive = negativePrice;
+    return inputs;
+}
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+// --- LimiterCore::step -------------------------------------------------------
+
+void test_step_pid_tracks_consumption()
+{
+    LimiterParams params = makeParams(true);
+    params.pidKp = 0.5f;
+    LimiterCore core;
+
+    // First step starts the PID at the target (grid + solar), no jump.
+    LimiterStep first = core.step(makeInputs(100, 300), params, 1000);
+    TEST_ASSERT_EQUAL(static_cast<int>(LimiterPath::Controller), static_cast<int>(first.path));
+    TEST_ASSERT_EQUAL_INT(400, first.pidBaseW);
+    TEST_ASSERT_EQUAL_INT(400, first.pidInputW);
+    TEST_ASSERT_EQUAL_INT(400, first.calculatedW);
+    TEST_ASSERT_EQUAL_INT(400, first.setW);
+
+    // Target 600, error 200, Kp 0.5 -> half way.
+    LimiterStep second = core.step(makeInputs(200, 400), params, 2000);
+    TEST_ASSERT_EQUAL_INT(600, second.pidBaseW);
+    TEST_ASSERT_EQUAL_INT(400, second.pidInputW);
+    TEST_ASSERT_EQUAL_INT(500, second.calculatedW);
+    TEST_ASSERT_EQUAL_INT(500, second.setW);
+    TEST_ASSERT_TRUE(core.modeIsPid());
+}
+
+void test_step_smoother_averages_grid()
+{
+    LimiterParams params = makeParams(false);
+    params.correctionOffsetW = 50;
+    LimiterCore core;
+
+    // The buffer is primed with the first reading.
+    LimiterStep first = core.step(makeInputs(100, 0), params, 1000);
+    TEST_ASSERT_FALSE(first.smootherMissing);
+    TEST_ASSERT_EQUAL_INT(100, first.calculatedW);
+    TEST_ASSERT_EQUAL_INT(150, first.correctedW);
+    TEST_ASSERT_EQUAL_INT(150, first.setW);
+
+    // (100 + 500 + 100 + 100) / 4
+    LimiterStep second = core.step(makeInputs(500, 0), params, 2000);
+    TEST_ASSERT_EQUAL_INT(200, second.calculatedW);
+    TEST_ASSERT_EQUAL_INT(250, second.setW);
+    TEST_ASSERT_NOT_NULL(core.smoother());
+    TEST_ASSERT_EQUAL_INT(4, core.smoother()->size());
+}
+
+void test_step_clamps_set_value()
+{
+    LimiterParams params = makeParams(false);
+    params.correctionOffsetW = 400;
+    LimiterCore core;
+
+    LimiterStep step = core.step(makeInputs(600, 0), params, 1000);
+    TEST_ASSERT_EQUAL_INT(1000, step.correctedW);
+    TEST_ASSERT_EQUAL_INT(800, step.setW);
+}
+
+void test_step_disabled_sends_max()
+{
+    LimiterParams params = makeParams(true);
+    params.controllerEnabled = false;
+    LimiterCore core;
+
+    LimiterStep step = core.step(makeInputs(100, 300), params, 1000);
+    TEST_ASSERT_EQUAL(static_cast<int>(LimiterPath::Disabled), static_cast<int>(step.path));
+    TEST_ASSERT_EQUAL_INT(800, step.setW);
+    TEST_ASSERT_FALSE(core.pid().initialized);
+}
+
+// --- PID step ----------------------------------------------------------------
+
+void test_pid_integral_accumulates_when_unsaturated()
+{
+    LimiterParams params = makeParams(true);
+    params.pidKp = 0.1f;
+    params.pidKi = 0.1f;
+    PidControllerState pid;
+    pid.initialized = true;
+    pid.output = 400.0f;
+    pid.lastUpdateMs = 1000;
+
+    // error 100 over 1 s: integral 100, delta 0.1 * 100 + 0.1 * 100
+    TEST_ASSERT_EQUAL_INT(420, computePidStep(pid, 500, params, 2000));
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, pid.integral);
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, pid.previousError);
+    TEST_ASSERT_EQUAL_UINT32(2000, pid.lastUpdateMs);
+}
+
+void test_pid_clamps_output_and_holds_integral()
+{
+    LimiterParams params = makeParams(true);
+    params.pidKp = 1.0f;
+    params.pidKi = 0.5f;
+    PidControllerState pid;
+    pid.initialized = true;
+    pid.output = 700.0f;
+    pid.lastUpdateMs = 1000;
+
+    // 700 + 300 + 150 is above max: output clamped, integral not wound up.
+    TEST_ASSERT_EQUAL_INT(800, computePidStep(pid, 1000, params, 2000));
+    TEST_ASSERT_EQUAL_FLOAT(800.0f, pid.output);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, pid.integral);
+
+    // Below min with a negative error: clamped to min, integral still held.
+    TEST_ASSERT_EQUAL_INT(0, computePidStep(pid, -2000, params, 3000));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, pid.integral);
+}
+
+void test_pid_integral_and_dt_limits()
+{
+    LimiterParams params = makeParams(true);
+    PidControllerState pid;
+    pid.initialized = true;
+    pid.output = 400.0f;
+    pid.lastUpdateMs = 0;
+
+    // 60 s gap counts as 10 s; 19600 W * 10 s is capped at the integral limit.
+    computePidStep(pid, 20000, params, 60000);
+    TEST_ASSERT_EQUAL_FLOAT(LIMITER_PID_INTEGRAL_LIMIT, pid.integral);
+}
+
+void test_pid_first_step_starts_at_clamped_target()
+{
+    LimiterParams params = makeParams(true);
+    params.pidKp = 1.0f;
+    PidControllerState pid;
+
+    TEST_ASSERT_EQUAL_INT(800, computePidStep(pid, 1500, params, 5000));
+    TEST_ASSERT_TRUE(pid.initialized);
+    TEST_ASSERT_EQUAL_UINT32(5000, pid.lastUpdateMs);
+}
+
+// --- Negative price ----------------------------------------------------------
+
+void test_negative_price_target()
+{
+    LimiterParams params = makeParams(true);
+    params.minOutputW = 120;
+
+    params.negativePriceMode = NegativePriceMode::Off;
+    TEST_ASSERT_EQUAL_INT(-1, negativePriceTargetW(true, params));
+
+    params.negativePriceMode = NegativePriceMode::ForceMin;
+    TEST_ASSERT_EQUAL_INT(-1, negativePriceTargetW(false, params));
+    TEST_ASSERT_EQUAL_INT(120, negativePriceTargetW(true, params));
+
+    params.negativePriceMode = NegativePriceMode::SetZero;
+    TEST_ASSERT_EQUAL_INT(0, negativePriceTargetW(true, params));
+}
+
+void test_step_negative_price_overrides_and_resets_pid()
+{
+    LimiterParams params = makeParams(true);
+    params.pidKp = 0.5f;
+    params.minOutputW = 120;
+    params.negativePriceMode = NegativePriceMode::SetZero;
+    LimiterCore core;
+
+    core.step(makeInputs(100, 300), params, 1000);
+    TEST_ASSERT_TRUE(core.pid().initialized);
+
+    LimiterStep step = core.step(makeInputs(100, 300, true), params, 2000);
+    TEST_ASSERT_EQUAL(static_cast<int>(LimiterPath::NegativePrice), static_cast<int>(step.path));
+    TEST_ASSERT_EQUAL_INT(0, step.negativePriceTargetW);
+    TEST_ASSERT_EQUAL_INT(0, step.setW);
+    TEST_ASSERT_FALSE(core.pid().initialized);
+
+    params.negativePriceMode = NegativePriceMode::ForceMin;
+    step = core.step(makeInputs(100, 300, true), params, 3000);
+    TEST_ASSERT_EQUAL_INT(120, step.setW);
+}
+
+void test_params_force_min_wins_over_set_zero()
+{
+    LimiterSettingsValues values;
+    values.maxOutputW = 800;
+    values.forceMinOnNegativePrice = true;
+    values.setZeroOnNegativePrice = true;
+    TEST_ASSERT_EQUAL(static_cast<int>(NegativePriceMode::ForceMin),
+                      static_cast<int>(buildLimiterParams(values, 1).negativePriceMode));
+
+    values.forceMinOnNegativePrice = false;
+    TEST_ASSERT_EQUAL(static_cast<int>(NegativePriceMode::SetZero),
+                      static_cast<int>(buildLimiterParams(values, 1).negativePriceMode));
+}
+
+void test_resolve_negative_price_preference()
+{
+    using P = NegativePriceSettingPreference;
+    // The setting just enabled wins.
+    TEST_ASSERT_EQUAL(static_cast<int>(P::ForceMin), static_cast<int>(resolveNegativePricePreference(P::ForceMin, P::SetZero)));
+    TEST_ASSERT_EQUAL(static_cast<int>(P::SetZero), static_cast<int>(resolveNegativePricePreference(P::SetZero, P::ForceMin)));
+    // Otherwise the last winner.
+    TEST_ASSERT_EQUAL(static_cast<int>(P::SetZero), static_cast<int>(resolveNegativePricePreference(P::None, P::SetZero)));
+    TEST_ASSERT_EQUAL(static_cast<int>(P::ForceMin), static_cast<int>(resolveNegativePricePreference(P::None, P::ForceMin)));
+    // Otherwise ForceMin.
+    TEST_ASSERT_EQUAL(static_cast<int>(P::ForceMin), static_cast<int>(resolveNegativePricePreference(P::None, P::None)));
+}
+
+// --- RS485 frame -------------------------------------------------------------
+
+void test_setpoint_frame_bytes()
+{
+    uint8_t frame[RS485_FRAME_BYTES];
+
+    const uint8_t expected800[RS485_FRAME_BYTES] = {0x24, 0x56, 0x00, 0x21, 0x03, 0x20, 0x80, 0xE5};
+    encodeSetpointFrame(800, frame);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected800, frame, RS485_FRAME_BYTES);
+
+    const uint8_t expected0[RS485_FRAME_BYTES] = {0x24, 0x56, 0x00, 0x21, 0x00, 0x00, 0x80, 0x08};
+    encodeSetpointFrame(0, frame);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected0, frame, RS485_FRAME_BYTES);
+
+    // Checksum wraps: 264 - 0xFF - 0xFF
+    const uint8_t expectedMax[RS485_FRAME_BYTES] = {0x24, 0x56, 0x00, 0x21, 0xFF, 0xFF, 0x80, 0x0A};
+    encodeSetpointFrame(0xFFFF, frame);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedMax, frame, RS485_FRAME_BYTES);
+}
+
+void test_format_hex_bytes()
+{
+    uint8_t frame[RS485_FRAME_BYTES];
+    encodeSetpointFrame(800, frame);
+
+    char text[32];
+    TEST_ASSERT_EQUAL_UINT32(24, formatHexBytes(frame, RS485_FRAME_BYTES, text, sizeof(text)));
+    TEST_ASSERT_EQUAL_STRING("24 56 00 21 03 20 80 E5 ", text);
+
+    // Only whole bytes that fit, always terminated.
+    char small[8];
+    TEST_ASSERT_EQUAL_UINT32(6, formatHexBytes(frame, RS485_FRAME_BYTES, small, sizeof(small)));
+    TEST_ASSERT_EQUAL_STRING("24 56 ", small);
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_step_pid_tracks_consumption);
+    RUN_TEST(test_step_smoother_averages_grid);
+    RUN_TEST(test_step_clamps_set_value);
+    RUN_TEST(test_step_disabled_sends_max);
+    RUN_TEST(test_pid_integral_accumulates_when_unsaturated);
+    RUN_TEST(test_pid_clamps_output_and_holds_integral);
+    RUN_TEST(test_pid_integral_and_dt_limits);
+    RUN_TEST(test_pid_first_step_starts_at_clamped_target);
+    RUN_TEST(test_negative_price_target);
+    RUN_TEST(test_step_negative_price_overrides_and_resets_pid);
+    RUN_TEST(test_params_force_min_wins_over_set_zero);
+    RUN_TEST(test_resolve_negative_price_preference);
+    RUN_TEST(test_setpoint_frame_bytes);
+    RUN_TEST(test_format_hex_bytes);
+    return UNITY_END();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// dumpAscii() of the WriteToDisplay layout: frame around three rows,
+// "<- 120 W|Temp: 21.5" and "-> 800 W|DP-T: 12.3" (one row per pixel line, # = lit).
+// After an intended rendering change, print the dump from test_write_to_display_matches_golden
+// and paste it here.
+static const char GOLDEN_WRITE_TO_DISPLAY[] =
+    "################################################################################################################################\n"
+    "#....#...............#....###...###........#...#...#...#####................................###....#.........#####.............#\n"
+    "#...#...............##...#...#.#...#.......#...#...#...#.#.#...............................#...#..##.........#.................#\n"
+    "#..#.................#.......#.#..##.......#...#...#.....#....###..##.#..#.##....#.............#...#.........####..............#\n"
+    "#.#....#####.........#....###..#.#.#.......#.#.#.........#...#...#.#.#.#.##..#..............###....#.............#.............#\n"
+    "#..#.................#...#.....##..#.......#.#.#...#.....#...#####.#.#.#.##..#...#.........#.......#.............#.............#\n"
+    "#...#................#...#.....#...#.......#.#.#...#.....#...#.....#.#.#.#.##..............#.......#.....##..#...#.............#\n"
+    "#....#..............###..#####..###.........#.#....#.....#....###..#.#.#.#.................#####..###....##...###..............#\n"
+    "#..............................................................................................................................#\n"
+    "#.......#...........###...###...###........#...#...#...####..####........#####...............#....###........#####.............#\n"
+    "#........#.........#...#.#...#.#...#.......#...#...#...#...#.#...#.......#.#.#..............##...#...#...........#.............#\n"
+    "#.........#........#...#.#..##.#..##.......#...#...#...#...#.#...#.........#.....#...........#.......#..........#..............#\n"
+    "######.....#........###..#.#.#.#.#.#.......#.#.#.......#...#.####..#####...#.................#....###..........##..............#\n"
+    "#.........#........#...#.##..#.##..#.......#.#.#...#...#...#.#.............#.....#...........#...#...............#.............#\n"
+    "#........#.........#...#.#...#.#...#.......#.#.#...#...#...#.#.............#.................#...#.......##..#...#.............#\n"
+    "#.......#...........###...###...###.........#.#....#...####..#.............#................###..#####...##...###..............#\n"
+    "#..............................................................................................................................#\n"
+    "#..............................................................................................................................#\n"
+    "#..............................................................................................................................#\n"
+    "#..............................................................................................................................#\n"
+    "#..............................................................................................................................#\n"
+    "#..............................................................................................................................#\n"
+    "#..............................................................................................................................#\n"
+    "################################################################################################################################\n"
+    "................................................................................................................................\n"
+    "................................................................................................................................\n"
+    "................................................................................................................................\n"
+    "................................................................................................................................\n"
+    "................................................................................................................................\n"
+    "................................................................................................................................\n"
+    "................................................................................................................................\n"
+    "................................................................................................................................\n";
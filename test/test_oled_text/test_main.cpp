@@ -0,0 +1,95 @@
+#include <string.h>
+#include <unity.h>
+
+#include "OledText/OledText.h"
+#include "golden_write_to_display.h"
+
+namespace
+{
+constexpr size_t DUMP_BYTES = OLED_PAGES * 8 * (OLED_COLUMNS + 1) + 1;
+
+char dump[DUMP_BYTES];
+char expected[DUMP_BYTES];
+
+// The layout WriteToDisplay() draws with the BME280 values: the setup frame around
+// three rows, grid import and temperature on row 0, set value and dew point on row 1.
+void drawLayout(OledTextCanvas &canvas, const char *gridLine)
+{
+    canvas.setFrame(3);
+    canvas.setLine(0, gridLine);
+    canvas.setLine(1, "-> 800 W|DP-T: 12.3");
+}
+} // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_write_to_display_matches_golden()
+{
+    OledTextCanvas canvas;
+    OledFramebufferSink sink;
+    drawLayout(canvas, "<- 120 W|Temp: 21.5");
+    TEST_ASSERT_EQUAL_INT(OLED_PAGES * OLED_COLUMNS, canvas.flush(sink));
+
+    TEST_ASSERT_EQUAL_UINT32(DUMP_BYTES - 1, sink.dumpAscii(dump, sizeof(dump)));
+    TEST_ASSERT_EQUAL_STRING(GOLDEN_WRITE_TO_DISPLAY, dump);
+}
+
+void test_unchanged_flush_sends_nothing()
+{
+    OledTextCanvas canvas;
+    OledFramebufferSink sink;
+    drawLayout(canvas, "<- 120 W|Temp: 21.5");
+    canvas.flush(sink);
+    const size_t calls = sink.writeCalls;
+
+    drawLayout(canvas, "<- 120 W|Temp: 21.5");
+    TEST_ASSERT_FALSE(canvas.dirty());
+    TEST_ASSERT_EQUAL_INT(0, canvas.flush(sink));
+    TEST_ASSERT_EQUAL_UINT32(calls, sink.writeCalls);
+}
+
+void test_one_digit_change_sends_one_cell()
+{
+    OledTextCanvas canvas;
+    OledFramebufferSink sink;
+    drawLayout(canvas, "<- 120 W|Temp: 21.5");
+    canvas.flush(sink);
+    const size_t calls = sink.writeCalls;
+    const size_t bytes = sink.bytesWritten;
+
+    drawLayout(canvas, "<- 121 W|Temp: 21.5");
+    TEST_ASSERT_EQUAL_INT(OLED_CELL_WIDTH, canvas.flush(sink));
+    TEST_ASSERT_EQUAL_UINT32(calls + 1, sink.writeCalls);
+    TEST_ASSERT_EQUAL_UINT32(bytes + OLED_CELL_WIDTH, sink.bytesWritten);
+}
+
+void test_partial_update_matches_full_redraw()
+{
+    OledTextCanvas canvas;
+    OledFramebufferSink sink;
+    drawLayout(canvas, "<- 120 W|Temp: 21.5");
+    canvas.flush(sink);
+    drawLayout(canvas, "<- 121 W|Temp: 21.5");
+    canvas.flush(sink);
+
+    OledTextCanvas fresh;
+    OledFramebufferSink full;
+    drawLayout(fresh, "<- 121 W|Temp: 21.5");
+    fresh.flush(full);
+
+    sink.dumpAscii(dump, sizeof(dump));
+    full.dumpAscii(expected, sizeof(expected));
+    TEST_ASSERT_EQUAL_STRING(expected, dump);
+    TEST_ASSERT_TRUE(strcmp(GOLDEN_WRITE_TO_DISPLAY, dump) != 0); // the digit did reach the panel
+}
+
+int main(int, char **)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_write_to_display_matches_golden);
+    RUN_TEST(test_unchanged_flush_sends_nothing);
+    RUN_TEST(test_one_digit_change_sends_one_cell);
+    RUN_TEST(test_partial_update_matches_full_redraw);
+    return UNITY_END();
+}
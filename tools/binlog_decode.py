@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""
+Format a binary log download (http://<device>/binlog.bin) as text.
+
+Usage:
+    python tools/binlog_decode.py binlog.bin                          # scans ./src for the format strings
+    python tools/binlog_decode.py binlog.bin --strings strings.json   # table from /binlog-strings.json
+    python tools/binlog_decode.py binlog.bin --src path/to/src
+
+The dump layout is documented in src/BinLog/BinLog.h.
+Use the string table of the firmware that produced the dump; unknown ids are printed raw.
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+from datetime import datetime, timezone
+from pathlib import Path
+
+from binlog_strings import scan
+
+MAGIC = b"BLG1"
+HEADER_BYTES = 20
+LEVEL_NAMES = {1: "E", 2: "W", 3: "I", 4: "D", 5: "T"}
+SPEC_RE = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)(hh|h|ll|l|z|j|t)?([diouxXcfFeEgGsp%])")
+
+
+def as_float(word: int) -> float:
+    return struct.unpack("<f", struct.pack("<I", word))[0]
+
+
+def as_signed(word: int) -> int:
+    return word - 0x100000000 if word & 0x80000000 else word
+
+
+def format_record(fmt: str, args) -> str:
+    """printf subset: every conversion consumes one 32-bit argument word."""
+    values = iter(args)
+
+    def convert(match):
+        flags, _, conv = match.groups()
+        if conv == "%":
+            return "%"
+        word = next(values, None)
+        if word is None:
+            return "<?>"
+        if conv in "di":
+            return ("%" + flags + "d") % as_signed(word)
+        if conv in "ouxX":
+            return ("%" + flags + conv) % word
+        if conv == "c":
+            return chr(word & 0xFF)
+        if conv in "fFeEgG":
+            return ("%" + flags + conv) % as_float(word)
+        if conv == "p":
+            return f"0x{word:08x}"
+        return f"<s:{word:#x}>"
+
+    return SPEC_RE.sub(convert, fmt)
+
+
+def parse_dump(data: bytes):
+    """Returns (uptime_ms, epoch_offset, overwritten, [(id, ts_ms, level, seq, args)])."""
+    if len(data) < HEADER_BYTES or data[:4] != MAGIC:
+        raise ValueError("not a binlog dump (bad magic)")
+    uptime_ms, epoch_offset, overwritten, word_count = struct.unpack_from("<IIII", data, 4)
+    words = struct.unpack_from(f"<{word_count}I", data, HEADER_BYTES)
+    records = []
+    pos = 0
+    while pos + 3 <= len(words):
+        record_id, ts_ms, meta = words[pos:pos + 3]
+        argc = (meta >> 8) & 0xFF
+        args = words[pos + 3:pos + 3 + argc]
+        if len(args) != argc:
+            raise ValueError(f"record at word {pos} truncated")
+        records.append((record_id, ts_ms, meta & 0xFF, meta >> 16, list(args)))
+        pos += 3 + argc
+    return uptime_ms, epoch_offset, overwritten, records
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Format SolarInverterLimiter binary log downloads")
+    parser.add_argument("file", help="binlog.bin downloaded from the device")
+    parser.add_argument("--strings", help="string table JSON (/binlog-strings.json or tools/binlog_strings.py)")
+    parser.add_argument("--src", default="src", help="source directory to scan when --strings is not given")
+    args = parser.parse_args()
+
+    if args.strings:
+        with open(args.strings, encoding="utf-8") as f:
+            table = json.load(f)
+    else:
+        table, collisions = scan(Path(args.src))
+        for message in collisions:
+            print(f"[W] hash collision: {message}", file=sys.stderr)
+
+    with open(args.file, "rb") as f:
+        uptime_ms, epoch_offset, overwritten, records = parse_dump(f.read())
+
+    print(f"# uptime={uptime_ms} ms records={len(records)} overwritten={overwritten}")
+    for record_id, ts_ms, level, seq, values in records:
+        if epoch_offset:
+            stamp = datetime.fromtimestamp(epoch_offset + ts_ms / 1000.0, tz=timezone.utc).strftime("%H:%M:%S.%f")[:-3]
+        else:
+            stamp = f"{ts_ms / 1000.0:10.3f}"
+        entry = table.get(f"{record_id:08x}")
+        if entry is None:
+            text = f"[{record_id:08x}] " + " ".join(f"{v:#x}" for v in values)
+            tag = "?"
+        else:
+            text = format_record(entry["fmt"], values)
+            tag = entry["tag"]
+        print(f"{stamp} {seq:5d} [{LEVEL_NAMES.get(level, level)}][{tag}] {text}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""
+Collect the BINLOG_* call sites from the firmware sources into an id -> (tag, format) table.
+
+Usage:
+    python tools/binlog_strings.py [--src src] > binlog_strings.json
+
+The id is the 32-bit FNV-1a hash of "<tag>|<format>" as computed by binLogHash() in src/BinLog/BinLog.h.
+The pre-build step (tools/precompile_wrapper.py) embeds the same table as /binlog-strings.json.
+"""
+
+import argparse
+import json
+import re
+import sys
+from pathlib import Path
+
+LEVELS = {"TRACE": 5, "DEBUG": 4, "INFO": 3, "WARN": 2, "ERROR": 1}
+SOURCE_SUFFIXES = (".cpp", ".h", ".hpp", ".c")
+_STRING = r'"(?:[^"\\\n]|\\.)*"'
+_LITERALS = rf'((?:\s*{_STRING})+)'
+CALL_RE = re.compile(rf'\bBINLOG_(TRACE|DEBUG|INFO|WARN|ERROR)\s*\(\s*{_LITERALS}\s*,{_LITERALS}')
+SIMPLE_ESCAPES = {"n": "\n", "t": "\t", "r": "\r", "\\": "\\", '"': '"', "'": "'", "0": "\0"}
+
+
+def fnv1a(data: bytes) -> int:
+    value = 2166136261
+    for b in data:
+        value = ((value ^ b) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def c_literals(text: str) -> str:
+    """Concatenates adjacent C string literals and resolves the common escapes."""
+    out = []
+    for literal in re.findall(_STRING, text):
+        body = literal[1:-1]
+        i = 0
+        while i < len(body):
+            ch = body[i]
+            if ch == "\\" and i + 1 < len(body):
+                nxt = body[i + 1]
+                if nxt == "x":
+                    match = re.match(r"[0-9a-fA-F]+", body[i + 2:])
+                    digits = match.group(0) if match else "0"
+                    out.append(chr(int(digits, 16) & 0xFF))
+                    i += 2 + len(digits)
+                    continue
+                out.append(SIMPLE_ESCAPES.get(nxt, nxt))
+                i += 2
+                continue
+            out.append(ch)
+            i += 1
+    return "".join(out)
+
+
+def scan(src_dir: Path):
+    """Returns ({id_hex: {tag, fmt, level, site}}, [collision messages])."""
+    table = {}
+    collisions = []
+    for path in sorted(p for p in src_dir.rglob("*") if p.suffix in SOURCE_SUFFIXES and "generated" not in p.parts):
+        text = path.read_text(encoding="utf-8", errors="replace")
+        for match in CALL_RE.finditer(text):
+            if "//" in text[text.rfind("\n", 0, match.start()) + 1:match.start()]:
+                continue  # usage example in a comment
+            tag = c_literals(match.group(2))
+            fmt = c_literals(match.group(3))
+            key = f"{fnv1a((tag + '|' + fmt).encode('utf-8')):08x}"
+            line = text.count("\n", 0, match.start()) + 1
+            entry = {"tag": tag, "fmt": fmt, "level": LEVELS[match.group(1)],
+                     "site": f"{path.relative_to(src_dir).as_posix()}:{line}"}
+            previous = table.get(key)
+            if previous and (previous["tag"], previous["fmt"]) != (tag, fmt):
+                collisions.append(f"id {key}: {previous['site']} and {entry['site']}")
+                continue
+            table.setdefault(key, entry)
+    return table, collisions
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--src", default="src", help="firmware source directory (default: src)")
+    args = parser.parse_args()
+
+    table, collisions = scan(Path(args.src))
+    for message in collisions:
+        print(f"hash collision: {message}", file=sys.stderr)
+    json.dump(table, sys.stdout, indent=1, sort_keys=True)
+    print()
+    return 1 if collisions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
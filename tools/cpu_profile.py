@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+"""
+Capture and symbolize CPU profiles from the usb_cpuprofile build (src/CpuProfiler/).
+
+Usage:
+    python tools/cpu_profile.py capture --host 192.168.1.50 --seconds 30 -o profile.cpf
+    python tools/cpu_profile.py fold profile.cpf > profile.folded        # flame-graph input
+    python tools/cpu_profile.py fold profile.cpf --top 30 --by-task > /dev/null
+
+`capture` repeats short captures (the device buffer holds CPU_PROFILER_SAMPLES samples)
+until --seconds have passed and appends every dump to the output file.
+`fold` symbolizes the PCs with addr2line against the firmware ELF (default: the newest
+.pio/build/usb_cpuprofile/firmware.elf) and prints one folded stack per line,
+"cpu0;loopTask;loop();processRS485Tick();... 12", ready for flamegraph.pl or speedscope.
+A flat profile of the hottest functions (self samples) goes to stderr.
+"""
+
+import argparse
+import glob
+import os
+import shutil
+import struct
+import subprocess
+import sys
+import time
+import urllib.request
+from collections import Counter
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+MAGIC = b"CPF1"
+HEADER = struct.Struct("<4sIIIIHH")
+TASK_NAME_BYTES = 16
+
+
+def request(host, path, method="GET"):
+    url = "http://%s%s" % (host, path)
+    req = urllib.request.Request(url, data=b"" if method == "POST" else None, method=method)
+    with urllib.request.urlopen(req, timeout=10) as response:
+        return response.read()
+
+
+def capture(args):
+    import json
+
+    deadline = time.monotonic() + args.seconds
+    total = 0
+    dumps = 0
+    with open(args.output, "ab" if args.append else "wb") as out:
+        while True:
+            status = json.loads(request(args.host, "/profiler/start?divider=%d" % args.divider, "POST"))
+            if not status.get("available"):
+                sys.exit("profiler not available (flash the usb_cpuprofile environment)")
+            while time.monotonic() < deadline:
+                time.sleep(0.25)
+                status = json.loads(request(args.host, "/profiler/status"))
+                if not status["armed"]:
+                    break
+            dump = request(args.host, "/profile.bin")
+            out.write(dump)
+            dumps += 1
+            total += HEADER.unpack_from(dump)[3]
+            if time.monotonic() >= deadline:
+                break
+    print("%d samples in %d capture(s) -> %s" % (total, dumps, args.output), file=sys.stderr)
+    return 0
+
+
+def read_dumps(path):
+    """Yields (core, task name, [pc, ...]) per sample from one or more concatenated dumps."""
+    data = Path(path).read_bytes()
+    offset = 0
+    while offset + HEADER.size <= len(data):
+        magic, _tick_hz, _divider, samples, _skipped, depth, tasks = HEADER.unpack_from(data, offset)
+        if magic != MAGIC:
+            sys.exit("%s: bad dump header at byte %d" % (path, offset))
+        offset += HEADER.size
+        names = []
+        for _ in range(tasks):
+            raw = data[offset:offset + TASK_NAME_BYTES]
+            names.append(raw.split(b"\0", 1)[0].decode("ascii", "replace") or "?")
+            offset += TASK_NAME_BYTES
+        record = struct.Struct("<BBBB%dI" % depth)
+        for _ in range(samples):
+            if offset + record.size > len(data):
+                sys.exit("%s: truncated dump" % path)
+            fields = record.unpack_from(data, offset)
+            offset += record.size
+            core, task, used = fields[0], fields[1], min(fields[2], depth)
+            name = names[task] if task < len(names) else "?"
+            yield core, name, list(fields[4:4 + used])
+
+
+def code_address(pc, leaf):
+    """Return addresses hold the window increment in the top bits and point after the call."""
+    if leaf:
+        return pc
+    if pc & 0x80000000:
+        pc = (pc & 0x3FFFFFFF) | 0x40000000
+    return pc - 3
+
+
+def find_elf():
+    candidates = glob.glob(str(ROOT / ".pio" / "build" / "usb_cpuprofile" / "firmware.elf"))
+    candidates += glob.glob(str(ROOT / ".pio" / "build" / "*" / "firmware.elf"))
+    return max(candidates, key=os.path.getmtime) if candidates else None
+
+
+def find_addr2line():
+    home = Path.home() / ".platformio" / "packages"
+    for pattern in ("toolchain-xtensa-esp32*/bin/xtensa-esp32-elf-addr2line*", "toolchain-xtensa*/bin/*addr2line*"):
+        found = sorted(glob.glob(str(home / pattern)))
+        if found:
+            return found[0]
+    return shutil.which("xtensa-esp32-elf-addr2line")
+
+
+def symbolize(addresses, elf, addr2line):
+    """Maps address -> [outermost inlined function, ..., innermost]."""
+    ordered = sorted(addresses)
+    result = subprocess.run([addr2line, "-e", elf, "-f", "-i", "-C", "-p"],
+                            input="\n".join("0x%08x" % a for a in ordered) + "\n",
+                            capture_output=True, text=True, check=True)
+    entries = []
+    for line in result.stdout.splitlines():
+        inlined = line.startswith(" (inlined by) ")
+        text = line[len(" (inlined by) "):] if inlined else line
+        function = text.split(" at ", 1)[0].strip().replace(";", ":")
+        if inlined and entries:
+            entries[-1].append(function)
+        else:
+            entries.append([function])
+    if len(entries) != len(ordered):
+        sys.exit("addr2line returned %d entries for %d addresses" % (len(entries), len(ordered)))
+    symbols = {}
+    for address, chain in zip(ordered, entries):
+        frames = [("0x%08x" % address) if f in ("", "??") else f for f in chain]
+        symbols[address] = list(reversed(frames))
+    return symbols
+
+
+def fold(args):
+    elf = args.elf or find_elf()
+    if not elf or not Path(elf).exists():
+        sys.exit("firmware ELF not found (build usb_cpuprofile or pass --elf)")
+    addr2line = args.addr2line or find_addr2line()
+    if not addr2line:
+        sys.exit("xtensa addr2line not found (install the PlatformIO toolchain or pass --addr2line)")
+
+    samples = []
+    for core, task, pcs in read_dumps(args.profile):
+        if pcs:
+            samples.append((core, task, [code_address(pc, i == 0) for i, pc in enumerate(pcs)]))
+    if not samples:
+        sys.exit("no samples in " + args.profile)
+
+    symbols = symbolize({pc for _, _, pcs in samples for pc in pcs}, elf, addr2line)
+    stacks = Counter()
+    self_time = Counter()
+    for core, task, pcs in samples:
+        frames = []
+        for pc in reversed(pcs):  # outermost caller first
+            frames.extend(symbols[pc])
+        root = ["cpu%d" % core] if not args.merge_cores else []
+        stacks[";".join(root + [task] + frames)] += 1
+        leaf = symbols[pcs[0]][-1]
+        self_time[(task, leaf) if args.by_task else leaf] += 1
+
+    for stack, count in sorted(stacks.items()):
+        print("%s %d" % (stack, count))
+
+    total = len(samples)
+    print("%d samples" % total, file=sys.stderr)
+    for key, count in self_time.most_common(args.top):
+        label = "%s: %s" % key if args.by_task else key
+        print("%6.2f%% %6d  %s" % (count * 100.0 / total, count, label), file=sys.stderr)
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    cap = sub.add_parser("capture", help="record samples from the device")
+    cap.add_argument("--host", required=True, help="device address")
+    cap.add_argument("--seconds", type=float, default=10.0)
+    cap.add_argument("--divider", type=int, default=1, help="sample every Nth tick per core")
+    cap.add_argument("-o", "--output", default="profile.cpf")
+    cap.add_argument("--append", action="store_true", help="append to an existing capture file")
+
+    fld = sub.add_parser("fold", help="symbolize a capture into folded stacks")
+    fld.add_argument("profile")
+    fld.add_argument("--elf", help="firmware ELF of the profiled build")
+    fld.add_argument("--addr2line", help="addr2line for the target (default: PlatformIO xtensa toolchain)")
+    fld.add_argument("--top", type=int, default=20, help="rows of the flat profile on stderr")
+    fld.add_argument("--by-task", action="store_true", help="flat profile per task")
+    fld.add_argument("--merge-cores", action="store_true", help="omit the cpuN root frame")
+
+    args = parser.parse_args()
+    return capture(args) if args.command == "capture" else fold(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""
+Decode a control log download (http://<device>/ctrllog.bin) into CSV.
+
+Usage:
+    python tools/ctrllog_decode.py ctrllog.bin > ctrllog.csv
+    python tools/ctrllog_decode.py ctrllog.bin --stats
+
+The block format is documented in src/ControlLog/ControlLogFormat.h.
+Blocks are sorted by sequence number; blocks with a bad CRC are skipped and reported on stderr.
+"""
+
+import argparse
+import csv
+import struct
+import sys
+from datetime import datetime, timezone
+
+BLOCK_BYTES = 512
+HEADER_BYTES = 32
+PAYLOAD_BYTES = BLOCK_BYTES - HEADER_BYTES
+MAGIC = b"CLG1"
+COLUMNS = ("time", "grid_w", "solar_w", "calc_w", "set_w", "flags")
+FLAG_NAMES = ((0x01, "pid"), (0x02, "enabled"), (0x04, "neg_price"))
+
+
+def crc16(data: bytes, crc: int = 0xFFFF) -> int:
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def read_varints(data: bytes, count: int):
+    values = []
+    pos = 0
+    for _ in range(count):
+        value = 0
+        shift = 0
+        while True:
+            if pos >= len(data):
+                raise ValueError("column truncated")
+            b = data[pos]
+            pos += 1
+            value |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80:
+                break
+        values.append(value)
+    return values
+
+
+def unzigzag(value: int) -> int:
+    return (value >> 1) ^ -(value & 1)
+
+
+def decode_block(block: bytes):
+    """Returns (sequence, epoch_flag, rows) or None for blank/invalid blocks."""
+    if block[:4] != MAGIC:
+        return None
+    seq, base_time, count, flags, column_count = struct.unpack_from("<IIHBB", block, 4)
+    if column_count != len(COLUMNS):
+        return None
+    lengths = struct.unpack_from("<6H", block, 16)
+    (stored_crc,) = struct.unpack_from("<H", block, 28)
+    payload_len = sum(lengths)
+    if payload_len > PAYLOAD_BYTES:
+        return None
+    payload = block[HEADER_BYTES:HEADER_BYTES + payload_len]
+    if crc16(payload, crc16(block[:28])) != stored_crc:
+        raise ValueError(f"CRC mismatch in block seq={seq}")
+
+    columns = []
+    pos = 0
+    for index, length in enumerate(lengths):
+        raw = read_varints(payload[pos:pos + length], count)
+        pos += length
+        if index == 0:
+            acc = base_time
+            col = []
+            for delta in raw:
+                acc = (acc + delta) & 0xFFFFFFFF
+                col.append(acc)
+        else:
+            acc = 0
+            col = []
+            for code in raw:
+                acc += unzigzag(code)
+                col.append(acc)
+        columns.append(col)
+
+    rows = list(zip(*columns))
+    return seq, bool(flags & 0x01), rows
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Decode SolarInverterLimiter control log downloads")
+    parser.add_argument("file", help="ctrllog.bin downloaded from the device")
+    parser.add_argument("--stats", action="store_true", help="print block statistics instead of CSV")
+    args = parser.parse_args()
+
+    with open(args.file, "rb") as f:
+        data = f.read()
+
+    blocks = []
+    bad = 0
+    for offset in range(0, len(data) - BLOCK_BYTES + 1, BLOCK_BYTES):
+        try:
+            decoded = decode_block(data[offset:offset + BLOCK_BYTES])
+        except ValueError as exc:
+            print(f"[W] {exc}", file=sys.stderr)
+            bad += 1
+            continue
+        if decoded is not None:
+            blocks.append(decoded)
+
+    # The pending RAM block is sent last and may share its sequence number with the next flash block.
+    blocks.sort(key=lambda b: b[0])
+    seen = set()
+    unique = []
+    for block in blocks:
+        if block[0] in seen:
+            continue
+        seen.add(block[0])
+        unique.append(block)
+
+    if args.stats:
+        records = sum(len(b[2]) for b in unique)
+        print(f"blocks={len(unique)} bad={bad} records={records}")
+        if records:
+            print(f"bytes/record={len(unique) * BLOCK_BYTES / records:.2f}")
+        return 0
+
+    writer = csv.writer(sys.stdout)
+    writer.writerow(["seq", "time", "time_utc"] + list(COLUMNS[1:5]) + [name for _, name in FLAG_NAMES])
+    for seq, epoch, rows in unique:
+        for t, grid, solar, calc, setw, flags in rows:
+            utc = datetime.fromtimestamp(t, tz=timezone.utc).isoformat() if epoch else ""
+            writer.writerow([seq, t, utc, grid, solar, calc, setw] + [1 if flags & bit else 0 for bit, _ in FLAG_NAMES])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
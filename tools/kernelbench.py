@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""
+Hot-path kernel benchmarks (src/KernelBench/).
+
+Usage:
+    python tools/kernelbench.py host > host.txt                  # build and run on this machine (ns per op)
+    python tools/kernelbench.py compare host.txt                 # compare with tools/kernelbench_baseline.json
+    python tools/kernelbench.py compare serial.log --update      # store the results as the new baseline
+    python tools/kernelbench.py compare serial.log --threshold 5
+
+Device numbers (cycles per op) come from the usb_kernelbench environment: flash it,
+capture the serial log after startup and pass the log file to `compare`.
+Results are compared only against baseline entries with the same unit, so host and
+device baselines live side by side in one file.
+The host build counts heap allocations (src/HeapTrace); `compare` also fails when a kernel
+marked "alloc_free" (it runs inside processRS485Tick) allocated, regardless of the baseline.
+"""
+
+import argparse
+import glob
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+SRC = ROOT / "src"
+DEFAULT_BASELINE = Path(__file__).resolve().parent / "kernelbench_baseline.json"
+LINE_RE = re.compile(r"KBENCH (\{.*\})")
+
+HOST_SOURCES = [
+    "HeapTrace/HeapTrace.cpp",
+    "KernelBench/KernelBench.cpp",
+    "LimiterCore/LimiterCore.cpp",
+    "LimiterParams/LimiterParams.cpp",
+    "PowerEstimator/PowerEstimator.cpp",
+    "RS485Module/RS485Frame.cpp",
+    "Smoother/Smoother.cpp",
+]
+
+
+def find_arduinojson():
+    """ArduinoJson is header-only; reuse the copy PlatformIO downloaded, if any."""
+    for candidate in sorted(glob.glob(str(ROOT / ".pio" / "libdeps" / "*" / "ArduinoJson" / "src"))):
+        if (Path(candidate) / "ArduinoJson.h").exists():
+            return candidate
+    return None
+
+
+def run_host(args):
+    cxx = args.cxx or os.environ.get("CXX") or shutil.which("g++") or shutil.which("clang++")
+    if not cxx:
+        sys.exit("no C++ compiler found (set CXX or pass --cxx)")
+
+    include_dirs = [str(SRC)]
+    json_dir = args.arduinojson or find_arduinojson()
+    if json_dir:
+        include_dirs.append(json_dir)
+    else:
+        print("ArduinoJson not found -> json_extract kernels skipped (build once with PlatformIO or pass --arduinojson)",
+              file=sys.stderr)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        binary = Path(tmp) / "kernelbench"
+        cmd = [cxx, "-std=gnu++17", "-O2", "-DKERNEL_BENCHMARK", "-DKERNEL_BENCH_HOST_MAIN", "-DHEAP_TRACE_ENABLED"]
+        cmd += ["-I" + d for d in include_dirs]
+        cmd += [str(SRC / s) for s in HOST_SOURCES]
+        cmd += ["-o", str(binary)]
+        subprocess.run(cmd, check=True)
+        subprocess.run([str(binary)], check=True)
+
+
+def parse_results(path):
+    """Returns ({(unit, name): per_op}, {name: allocs per op} for alloc_free kernels)."""
+    results = {}
+    alloc_free = {}
+    with open(path, encoding="utf-8", errors="replace") as handle:
+        for line in handle:
+            match = LINE_RE.search(line)
+            if not match:
+                continue
+            entry = json.loads(match.group(1))
+            name = entry["kernel"] + " | " + entry["input"]
+            results[(entry["unit"], name)] = float(entry["per_op"])
+            if entry.get("alloc_free") and "allocs" in entry:
+                alloc_free[name] = float(entry["allocs"])
+    return results, alloc_free
+
+
+def compare(args):
+    results, alloc_free = parse_results(args.results)
+    if not results:
+        sys.exit("no KBENCH lines in " + args.results)
+
+    allocating = sorted(name for name, allocs in alloc_free.items() if allocs > 0)
+    for name in allocating:
+        print("%s allocates %.2f times per op, expected 0" % (name, alloc_free[name]))
+
+    baseline_path = Path(args.baseline)
+    baseline = json.loads(baseline_path.read_text()) if baseline_path.exists() else {}
+
+    if args.update:
+        for (unit, name), value in results.items():
+            baseline.setdefault(unit, {})[name] = value
+        baseline_path.write_text(json.dumps(baseline, indent=2, sort_keys=True) + "\n")
+        print("baseline updated: %d results -> %s" % (len(results), baseline_path))
+        return 0
+
+    regressions = 0
+    width = max(len(name) for _, name in results)
+    for (unit, name), value in sorted(results.items()):
+        base = baseline.get(unit, {}).get(name)
+        if base is None:
+            print("%-*s %10.1f %-6s (no baseline)" % (width, name, value, unit))
+            continue
+        change = (value - base) / base * 100.0 if base > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        elif change < -args.threshold:
+            flag = "  faster"
+        print("%-*s %10.1f %-6s base %10.1f  %+6.1f%%%s" % (width, name, value, unit, base, change, flag))
+
+    if regressions:
+        print("%d kernel(s) slower than baseline by more than %.1f%%" % (regressions, args.threshold))
+    if allocating:
+        print("%d control-path kernel(s) allocate on the heap" % len(allocating))
+    return 1 if regressions or allocating else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    host = sub.add_parser("host", help="build and run the suite on this machine")
+    host.add_argument("--cxx", help="C++ compiler (default: $CXX, g++ or clang++)")
+    host.add_argument("--arduinojson", help="directory containing ArduinoJson.h")
+
+    cmp = sub.add_parser("compare", help="compare KBENCH lines with the baseline")
+    cmp.add_argument("results", help="host output or serial log containing KBENCH lines")
+    cmp.add_argument("--baseline", default=str(DEFAULT_BASELINE))
+    cmp.add_argument("--threshold", type=float, default=10.0, help="allowed slowdown in percent (default 10)")
+    cmp.add_argument("--update", action="store_true", help="write the results into the baseline instead")
+
+    args = parser.parse_args()
+    if args.command == "host":
+        run_host(args)
+        return 0
+    return compare(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
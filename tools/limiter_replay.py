@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""
+Replay recorded MQTT traces through the limiter logic (src/LimiterCore) on the host.
+
+Usage:
+    python tools/limiter_replay.py day.jsonl                          # firmware defaults, KPIs on stdout
+    python tools/limiter_replay.py day.jsonl --out setpoints.csv      # plus one row per controller tick
+    python tools/limiter_replay.py week.jsonl.gz --pid 1 --kp 0.5 --ki 0.08
+    python tools/limiter_replay.py day.jsonl --negative min --tau 5 --pv-cap none
+
+Trace format: one JSON object per line with a timestamp, the topic and the payload, e.g.
+    {"ts": "2025-06-01T12:00:02Z", "topic": "tele/powerMeter/powerMeter/SENSOR", "payload": "{\"E320\":{...}}"}
+The timestamp key may be ts, tst, time or timestamp (ISO 8601, or epoch seconds/milliseconds);
+the payload may be a JSON string or an object. `mosquitto_sub -v -F "%J"` output works as is.
+
+The simulation model is described in tools/replay/ReplaySim.h. Controller ticks run on a
+virtual clock, so a day of readings replays in well under a second.
+"""
+
+import argparse
+import gzip
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+from datetime import datetime
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parent.parent
+SRC = ROOT / "src"
+REPLAY_DIR = Path(__file__).resolve().parent / "replay"
+BUILD_DIR = Path(tempfile.gettempdir()) / "solar-limiter-host-tools"
+
+CORE_SOURCES = [
+    SRC / "LimiterCore" / "LimiterCore.cpp",
+    SRC / "LimiterParams" / "LimiterParams.cpp",
+    SRC / "PowerEstimator" / "PowerEstimator.cpp",
+    SRC / "Smoother" / "Smoother.cpp",
+    REPLAY_DIR / "ReplaySim.cpp",
+]
+
+TIME_KEYS = ("ts", "tst", "time", "timestamp")
+
+# Options passed through to the replay binary unchanged.
+LIMITER_OPTIONS = [
+    ("--min", "W", "minimum output"),
+    ("--max", "W", "maximum output"),
+    ("--offset", "W", "input correction offset"),
+    ("--smoothing", "N", "smoothing level"),
+    ("--pid", "0|1", "use PID instead of the smoother"),
+    ("--kp", "F", "PID Kp"),
+    ("--ki", "F", "PID Ki"),
+    ("--kd", "F", "PID Kd"),
+    ("--period", "S", "RS485 publish period"),
+    ("--negative", "off|min|zero", "negative-price mode"),
+    ("--estimator", "0|1", "regulate on the load/output estimate (default 1)"),
+    ("--tau", "S", "inverter response time constant (default 3)"),
+    ("--pv-cap", "recorded|none", "cap the simulated output at the recorded output (default recorded)"),
+]
+
+
+def build_host_tool(name, main_source, extra_flags=()):
+    """Compiles a host tool from tools/replay plus the portable core; rebuilt when a source changed."""
+    cxx = os.environ.get("CXX") or shutil.which("g++") or shutil.which("clang++")
+    if not cxx:
+        sys.exit("no C++ compiler found (set CXX)")
+    BUILD_DIR.mkdir(parents=True, exist_ok=True)
+    binary = BUILD_DIR / name
+    sources = CORE_SOURCES + [REPLAY_DIR / main_source]
+    headers = list(REPLAY_DIR.glob("*.h")) + list(SRC.glob("*/*.h"))
+    if binary.exists():
+        built = binary.stat().st_mtime
+        if all(path.stat().st_mtime <= built for path in sources + headers):
+            return binary
+    cmd = [cxx, "-std=gnu++17", "-O2", "-I" + str(SRC), "-I" + str(REPLAY_DIR), *extra_flags]
+    cmd += [str(s) for s in sources] + ["-o", str(binary)]
+    subprocess.run(cmd, check=True)
+    return binary
+
+
+def parse_time_ms(value):
+    if isinstance(value, (int, float)):
+        return int(value if value > 1e12 else value * 1000)
+    text = str(value).strip()
+    try:
+        return parse_time_ms(float(text))
+    except ValueError:
+        pass
+    if text.endswith("Z"):
+        text = text[:-1] + "+00:00"
+    return int(datetime.fromisoformat(text).timestamp() * 1000)
+
+
+def lookup(payload, path):
+    value = payload
+    for part in path.split("."):
+        if not isinstance(value, dict) or part not in value:
+            return None
+        value = value[part]
+    return value
+
+
+def open_trace(path):
+    if str(path).endswith(".gz"):
+        return gzip.open(path, "rt", encoding="utf-8", errors="replace")
+    return open(path, encoding="utf-8", errors="replace")
+
+
+def read_events(paths, args):
+    """Returns sorted (time_ms, kind, value) tuples; kind g = grid, s = solar, n = negative price."""
+    events = []
+    skipped = 0
+    for path in paths:
+        with open_trace(path) as handle:
+            for line in handle:
+                line = line.strip()
+                if not line:
+                    continue
+                try:
+                    record = json.loads(line)
+                    stamp = next(record[k] for k in TIME_KEYS if k in record)
+                    time_ms = parse_time_ms(stamp)
+                except (ValueError, StopIteration, TypeError):
+                    skipped += 1
+                    continue
+                topic = record.get("topic")
+                payload = record.get("payload")
+                if isinstance(payload, str) and topic in (args.grid_topic, args.solar_topic):
+                    try:
+                        payload = json.loads(payload)
+                    except ValueError:
+                        skipped += 1
+                        continue
+                if topic == args.grid_topic:
+                    value = lookup(payload, args.grid_path)
+                    kind = "g"
+                elif topic == args.solar_topic:
+                    value = lookup(payload, args.solar_path)
+                    kind = "s"
+                elif topic == args.price_topic:
+                    value = 1 if str(payload).strip().lower() in ("1", "true", "on") else 0
+                    kind = "n"
+                else:
+                    continue
+                if not isinstance(value, (int, float)):
+                    skipped += 1
+                    continue
+                events.append((time_ms, kind, value))
+    events.sort(key=lambda e: e[0])
+    if skipped:
+        print("skipped %d unreadable lines" % skipped, file=sys.stderr)
+    return events
+
+
+def write_events(events, handle):
+    """Event file for the replay binary; times relative to the first event."""
+    origin = events[0][0]
+    for time_ms, kind, value in events:
+        handle.write("%d %s %g\n" % (time_ms - origin, kind, value))
+
+
+def add_trace_arguments(parser):
+    parser.add_argument("traces", nargs="+", help="JSONL trace files (.gz allowed), concatenated in time order")
+    parser.add_argument("--grid-topic", default="tele/powerMeter/powerMeter/SENSOR")
+    parser.add_argument("--grid-path", default="E320.Power_in")
+    parser.add_argument("--solar-topic", default="tele/tasmota_1DEE45/SENSOR")
+    parser.add_argument("--solar-path", default="ENERGY.Power")
+    parser.add_argument("--price-topic", default="SolarLimiter/Input/NegativePrice")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    add_trace_arguments(parser)
+    parser.add_argument("--out", help="CSV with one row per controller tick")
+    parser.add_argument("--kpi", help="also write the KPIs (JSON) to this file")
+    for flag, metavar, text in LIMITER_OPTIONS:
+        parser.add_argument(flag, metavar=metavar, help=text)
+    args = parser.parse_args()
+
+    events = read_events(args.traces, args)
+    if not any(kind == "g" for _, kind, _ in events):
+        sys.exit("no grid readings (%s %s) in the trace" % (args.grid_topic, args.grid_path))
+
+    binary = build_host_tool("limiter_replay", "limiter_replay.cpp")
+    cmd = [str(binary)]
+    for flag, _, _ in LIMITER_OPTIONS:
+        value = getattr(args, flag[2:].replace("-", "_"))
+        if value is not None:
+            cmd += [flag, str(value)]
+    if args.out:
+        cmd += ["--rows", args.out]
+
+    with tempfile.NamedTemporaryFile("w", suffix=".events", delete=False) as handle:
+        write_events(events, handle)
+        events_path = handle.name
+    try:
+        result = subprocess.run(cmd + ["--events", events_path], check=True, stdout=subprocess.PIPE, text=True)
+    finally:
+        os.unlink(events_path)
+
+    kpis = json.loads(result.stdout)
+    print(json.dumps(kpis, indent=2))
+    if args.kpi:
+        Path(args.kpi).write_text(json.dumps(kpis, indent=2) + "\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
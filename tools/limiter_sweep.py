@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""
+Grid-search limiter parameters on recorded MQTT traces, using all CPU cores.
+
+Usage:
+    python tools/limiter_sweep.py week.jsonl --mode pid --kp 0.1:1.0:0.05 --ki 0:0.2:0.02 --kd 0,0.02,0.05
+    python tools/limiter_sweep.py week.jsonl --mode smoother --smoothing 1:30:1 --offset 0:100:10
+    python tools/limiter_sweep.py week.jsonl --mode both --csv all.csv --change-cost 2
+
+SPEC values are from:to:step, a comma list or a single value. Unset ranges use the firmware
+default. Each candidate is replayed with the same model as tools/limiter_replay.py and
+scored on grid import Wh, export Wh and setpoint changes (RS485 writes that change the
+inverter limit). The Pareto front is printed best first, where "best" means lowest
+import + export + change-cost Wh per change. The recommended settings follow, named as
+in the settings UI.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+from limiter_replay import add_trace_arguments, build_host_tool, read_events, write_events
+
+SWEEP_OPTIONS = [
+    ("--mode", "pid|smoother|both", "controller mode(s) to sweep (default pid)"),
+    ("--kp", "SPEC", "PID Kp values"),
+    ("--ki", "SPEC", "PID Ki values"),
+    ("--kd", "SPEC", "PID Kd values"),
+    ("--smoothing", "SPEC", "smoothing levels"),
+    ("--offset", "SPEC", "input correction offsets (W)"),
+    ("--min", "W", "minimum output (fixed)"),
+    ("--max", "W", "maximum output (fixed)"),
+    ("--period", "S", "RS485 publish period (fixed)"),
+    ("--estimator", "0|1", "regulate on the load/output estimate (default 1)"),
+    ("--tau", "S", "inverter response time constant (default 3)"),
+    ("--pv-cap", "recorded|none", "cap the simulated output at the recorded output (default recorded)"),
+    ("--threads", "N", "worker threads (default: all cores)"),
+    ("--change-cost", "WH", "Wh one setpoint change is worth when ranking (default 1)"),
+    ("--csv", "FILE", "write every candidate with its scores"),
+]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    add_trace_arguments(parser)
+    for flag, metavar, text in SWEEP_OPTIONS:
+        parser.add_argument(flag, metavar=metavar, help=text)
+    args = parser.parse_args()
+
+    events = read_events(args.traces, args)
+    if not any(kind == "g" for _, kind, _ in events):
+        sys.exit("no grid readings (%s %s) in the trace" % (args.grid_topic, args.grid_path))
+
+    binary = build_host_tool("limiter_sweep", "limiter_sweep.cpp", ["-pthread"])
+    cmd = [str(binary)]
+    for flag, _, _ in SWEEP_OPTIONS:
+        value = getattr(args, flag[2:].replace("-", "_"))
+        if value is not None:
+            cmd += [flag, str(value)]
+
+    with tempfile.NamedTemporaryFile("w", suffix=".events", delete=False) as handle:
+        write_events(events, handle)
+        events_path = handle.name
+    try:
+        return subprocess.run(cmd + ["--events", events_path]).returncode
+    finally:
+        os.unlink(events_path)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
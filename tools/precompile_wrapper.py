@@ -57,6 +57,102 @@ def vlog(message):
         return
     log(message)
 
+WEB_ASSET_TYPES = {
+    '.html': 'text/html',
+    '.css': 'text/css',
+    '.js': 'application/javascript',
+    '.json': 'application/json',
+    '.svg': 'image/svg+xml',
+}
+
+# Pages of the diagnostics modules; a page is left out when its FEATURE_* flag is 0 (see src/main.cpp).
+WEB_ASSET_FEATURES = {
+    'binlog.html': 'FEATURE_BINLOG_ENABLED',
+    'heap.html': 'FEATURE_HEAP_STATS_ENABLED',
+    'history.html': 'FEATURE_HISTORY_ENABLED',
+    'live.html': 'FEATURE_LIVE_PUSH_ENABLED',
+    'tasks.html': 'FEATURE_TASK_MONITOR_ENABLED',
+}
+
+
+def _web_asset_enabled(name: str) -> bool:
+    flag = WEB_ASSET_FEATURES.get(name)
+    return flag is None or _get_define_from_scons(flag, 1) == 1
+
+
+def _binlog_string_table(project_dir: Path) -> bytes:
+    """Scan src/ for BINLOG_* call sites (see tools/binlog_strings.py). Hash collisions fail the build."""
+    import json
+
+    tools_dir = str(project_dir / 'tools')  # __file__ is not defined when SCons runs this script
+    if tools_dir not in sys.path:
+        sys.path.insert(0, tools_dir)
+    from binlog_strings import scan
+
+    table, collisions = scan(project_dir / 'src')
+    if collisions:
+        raise RuntimeError('BINLOG id collision: ' + '; '.join(collisions))
+    vlog(f"[precompile_wrapper] BINLOG string table: {len(table)} entries")
+    return json.dumps(table, sort_keys=True, separators=(',', ':')).encode('utf-8')
+
+
+def _build_web_assets(project_dir: Path) -> None:
+    """Gzip the project web assets (web/*) into src/generated/web_assets.h.
+    Each asset gets a strong ETag (content hash). gzip runs with mtime=0 so unchanged sources
+    produce identical bytes and ETags across builds. The header is only rewritten when its content changes.
+    URL mapping: web/<name>.html -> /<name>, every other file -> /<file name>.
+    The BINLOG_* format-string table (tools/binlog_strings.py) is added as /binlog-strings.json
+    (not below /binlog/: the /binlog page handler would also match that prefix).
+    Pages of disabled diagnostics features (WEB_ASSET_FEATURES) are skipped.
+    """
+    import gzip
+    import hashlib
+
+    web_dir = project_dir / 'web'
+    out_path = project_dir / 'src' / 'generated' / 'web_assets.h'
+    files = sorted(p for p in web_dir.glob('*') if p.is_file() and p.suffix in WEB_ASSET_TYPES and _web_asset_enabled(p.name)) if web_dir.exists() else []
+    assets = [('/' + (p.stem if p.suffix == '.html' else p.name), WEB_ASSET_TYPES[p.suffix], p.read_bytes(), p.name) for p in files]
+    if _get_define_from_scons('FEATURE_BINLOG_ENABLED', 1) == 1:
+        assets.append(('/binlog-strings.json', WEB_ASSET_TYPES['.json'], _binlog_string_table(project_dir), 'BINLOG string table'))
+
+    lines = [
+        '#pragma once',
+        '// Generated by tools/precompile_wrapper.py from web/ - do not edit.',
+        '#include <pgmspace.h>',
+        '#include "WebAssets/WebAssets.h"',
+        '',
+    ]
+    entries = []
+    raw_total = 0
+    gz_total = 0
+    for index, (url, mime, raw, label) in enumerate(assets):
+        packed = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = hashlib.sha256(raw).hexdigest()[:16]
+        raw_total += len(raw)
+        gz_total += len(packed)
+
+        lines.append(f'// {label}: {len(raw)} -> {len(packed)} bytes')
+        lines.append(f'static const uint8_t WEB_ASSET_{index}[] PROGMEM = {{')
+        for offset in range(0, len(packed), 20):
+            lines.append('    ' + ', '.join(f'0x{b:02X}' for b in packed[offset:offset + 20]) + ',')
+        lines.append('};')
+        lines.append('')
+        entries.append(f'    {{"{url}", "{mime}", WEB_ASSET_{index}, {len(packed)}, "\\"{etag}\\""}},')
+
+    lines.append('static const WebAsset WEB_ASSETS[] = {')
+    lines.extend(entries if entries else ['    {nullptr, nullptr, nullptr, 0, nullptr},'])
+    lines.append('};')
+    lines.append(f'static constexpr size_t WEB_ASSET_COUNT = {len(entries)};')
+    content = '\n'.join(lines) + '\n'
+
+    if out_path.exists() and out_path.read_text(encoding='utf-8') == content:
+        log(f"[precompile_wrapper] Web assets unchanged ({len(entries)} files)")
+        return
+    out_path.parent.mkdir(parents=True, exist_ok=True)
+    out_path.write_text(content, encoding='utf-8')
+    print(f"[precompile_wrapper] Web assets: {len(entries)} files, {raw_total} -> {gz_total} bytes gzip")
+
+
 def main():
     if not SCONS_AVAILABLE:
         print("[precompile_wrapper] Starting precompile wrapper...")
@@ -66,6 +162,13 @@ def main():
     
     if not SCONS_AVAILABLE:
         print(f"[precompile_wrapper] Project directory: {project_dir}")
+
+    # Project web assets do not depend on the ConfigManager library, build them first.
+    try:
+        _build_web_assets(project_dir)
+    except Exception as e:
+        print(f"[precompile_wrapper] Error building web assets: {e}")
+        sys.exit(1)
     
     # Determine active PlatformIO environment (fallback to 'usb' if undetermined)
     try:
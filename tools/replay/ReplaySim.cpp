@@ -0,0 +1,186 @@
+#include "ReplaySim.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "LimiterCore/LimiterCore.h"
+#include "PowerEstimator/MeterInbox.h"
+#include "PowerEstimator/PowerEstimator.h"
+
+namespace
+{
+double clampOutput(double value, double cap)
+{
+    return value < 0.0 ? 0.0 : (value > cap ? cap : value);
+}
+} // namespace
+
+ReplayKpis runReplay(const std::vector<ReplayEvent> &events, const ReplayConfig &config, FILE *rows)
+{
+    ReplayKpis kpis;
+    if (events.empty())
+    {
+        return kpis;
+    }
+
+    const LimiterParams params = buildLimiterParams(config.limiter, 1);
+    const int64_t periodMs = static_cast<int64_t>(lroundf(params.publishPeriodSec * 1000.0f));
+    const double periodH = static_cast<double>(periodMs) / 3600000.0;
+    const double lag = config.inverterTauSec > 0.0f ? 1.0 - exp(-params.publishPeriodSec / config.inverterTauSec) : 1.0;
+
+    LimiterCore core;
+    PowerEstimator estimator;
+    MeterInbox gridInbox;
+    MeterInbox solarInbox;
+    double recordedGridW = 0.0;
+    double recordedSolarW = 0.0;
+    double outputW = 0.0;
+    bool haveGrid = false;
+    bool haveSolar = false;
+    LimiterInputs inputs;
+    int lastSetW = -1;
+    double absGridSum = 0.0;
+
+    // Readings between two ticks are applied before the tick; the simulated output only changes at ticks.
+    auto apply = [&](const ReplayEvent &event)
+    {
+        switch (event.kind)
+        {
+        case ReplayEventKind::Grid:
+            recordedGridW = event.value;
+            haveGrid = true;
+            // Meter sees the reconstructed load minus what the simulated inverter delivers.
+            *gridInbox.slot() = static_cast<int>(lround(recordedGridW + recordedSolarW - outputW));
+            break;
+        case ReplayEventKind::Solar:
+            recordedSolarW = event.value;
+            if (!haveSolar)
+            {
+                outputW = recordedSolarW;
+                haveSolar = true;
+            }
+            *solarInbox.slot() = static_cast<int>(lround(outputW)); // the plug reports the simulated output
+            break;
+        case ReplayEventKind::NegativePrice:
+            inputs.negativePriceActive = event.value != 0.0f;
+            break;
+        }
+        // Same as observeMeterReadings() right after the message was delivered.
+        int value;
+        if (gridInbox.take(value))
+        {
+            inputs.gridW = value;
+            estimator.updateGrid(value, static_cast<uint32_t>(event.timeMs));
+        }
+        if (solarInbox.take(value))
+        {
+            inputs.solarW = value;
+            estimator.updateSolar(value, static_cast<uint32_t>(event.timeMs));
+        }
+    };
+
+    // Ticking starts with the first grid reading, like the device after boot.
+    size_t next = 0;
+    while (next < events.size() && !haveGrid)
+    {
+        apply(events[next++]);
+    }
+    if (!haveGrid)
+    {
+        return kpis;
+    }
+
+    const int64_t endMs = events.back().timeMs;
+    for (int64_t tickMs = events[next - 1].timeMs; tickMs <= endMs; tickMs += periodMs)
+    {
+        while (next < events.size() && events[next].timeMs <= tickMs)
+        {
+            apply(events[next++]);
+        }
+
+        LimiterInputs stepInputs = inputs;
+        if (params.useEstimator && estimator.ready())
+        {
+            const PowerEstimate estimate = estimator.estimate(static_cast<uint32_t>(tickMs));
+            stepInputs.gridW = estimate.gridW;
+            stepInputs.solarW = estimate.outputW;
+        }
+        const LimiterStep step = core.step(stepInputs, params, static_cast<uint32_t>(tickMs));
+        estimator.setCommand(step.setW, static_cast<uint32_t>(tickMs));
+        const double cap = config.pvCapFromRecording ? recordedSolarW : static_cast<double>(params.maxOutputW);
+        outputW += (clampOutput(step.setW, cap) - outputW) * lag;
+
+        const double gridTrueW = recordedGridW + recordedSolarW - outputW;
+        if (gridTrueW > 0.0)
+        {
+            kpis.importKwh += gridTrueW * periodH / 1000.0;
+        }
+        else
+        {
+            kpis.exportKwh += -gridTrueW * periodH / 1000.0;
+        }
+        kpis.inverterKwh += outputW * periodH / 1000.0;
+        absGridSum += fabs(gridTrueW);
+        if (lastSetW >= 0 && step.setW != lastSetW)
+        {
+            const int stepW = abs(step.setW - lastSetW);
+            ++kpis.setpointChanges;
+            kpis.setpointTravelW += stepW;
+            if (stepW > kpis.maxSetpointStepW)
+            {
+                kpis.maxSetpointStepW = stepW;
+            }
+        }
+        lastSetW = step.setW;
+        ++kpis.ticks;
+
+        if (rows != nullptr)
+        {
+            fprintf(rows, "%lld,%d,%.0f,%d,%d,%d,%.0f\n", static_cast<long long>(tickMs), inputs.gridW, gridTrueW,
+                    inputs.solarW, step.calculatedW, step.setW, outputW);
+        }
+    }
+
+    kpis.simulatedHours = kpis.ticks * periodH;
+    kpis.meanAbsGridW = kpis.ticks > 0 ? absGridSum / kpis.ticks : 0.0;
+    return kpis;
+}
+
+bool loadReplayEvents(FILE *in, std::vector<ReplayEvent> &events)
+{
+    long long timeMs = 0;
+    char kind = 0;
+    float value = 0.0f;
+    int fields = 0;
+    while ((fields = fscanf(in, "%lld %c %f", &timeMs, &kind, &value)) == 3)
+    {
+        ReplayEvent event;
+        event.timeMs = timeMs;
+        event.value = value;
+        switch (kind)
+        {
+        case 'g':
+            event.kind = ReplayEventKind::Grid;
+            break;
+        case 's':
+            event.kind = ReplayEventKind::Solar;
+            break;
+        case 'n':
+            event.kind = ReplayEventKind::NegativePrice;
+            break;
+        default:
+            return false;
+        }
+        events.push_back(event);
+    }
+    return fields == EOF;
+}
+
+void printReplayKpis(FILE *out, const ReplayKpis &kpis)
+{
+    fprintf(out,
+            "{\"ticks\":%lu,\"simulated_h\":%.3f,\"import_kwh\":%.4f,\"export_kwh\":%.4f,\"inverter_kwh\":%.4f,"
+            "\"mean_abs_grid_w\":%.1f,\"setpoint_changes\":%lu,\"setpoint_travel_w\":%.0f,\"max_setpoint_step_w\":%d}",
+            static_cast<unsigned long>(kpis.ticks), kpis.simulatedHours, kpis.importKwh, kpis.exportKwh, kpis.inverterKwh,
+            kpis.meanAbsGridW, static_cast<unsigned long>(kpis.setpointChanges), kpis.setpointTravelW, kpis.maxSetpointStepW);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+#include "LimiterParams/LimiterParams.h"
+
+// Closed-loop replay of recorded meter readings through LimiterCore with a virtual clock.
+//
+// The household load is reconstructed from the recording (load = grid + inverter output at
+// the time of the reading). The simulated inverter follows the new setpoint with a first
+// order lag, capped by the recorded output (or not at all with pvCapFromRecording = false),
+// and the simulated meter reports load - output at the recorded reading times, so the
+// controller sees the same update rate as on the device. With limiter.useEstimator the
+// readings also feed a PowerEstimator and the controller regulates on its estimate.
+
+enum class ReplayEventKind : uint8_t
+{
+    Grid,          // value: signed grid W (E320.Power_in)
+    Solar,         // value: inverter output W (ENERGY.Power)
+    NegativePrice, // value: 0/1
+};
+
+struct ReplayEvent
+{
+    int64_t timeMs;
+    ReplayEventKind kind;
+    float value;
+};
+
+struct ReplayConfig
+{
+    LimiterSettingsValues limiter;
+    float inverterTauSec = 3.0f;     // first order lag of the inverter output
+    bool pvCapFromRecording = true;  // output never exceeds the recorded output at that time
+};
+
+struct ReplayKpis
+{
+    uint32_t ticks = 0;
+    double simulatedHours = 0.0;
+    double importKwh = 0.0;
+    double exportKwh = 0.0;
+    double inverterKwh = 0.0;
+    double meanAbsGridW = 0.0;
+    uint32_t setpointChanges = 0;
+    double setpointTravelW = 0.0; // sum of |setpoint step|
+    int maxSetpointStepW = 0;
+};
+
+// Events must be sorted by time. rows (optional) receives one CSV row per controller tick:
+// t_ms,grid_meas_w,grid_true_w,solar_meas_w,calc_w,set_w,output_w
+ReplayKpis runReplay(const std::vector<ReplayEvent> &events, const ReplayConfig &config, FILE *rows);
+
+// Reads "t_ms kind value" lines (kind g/s/n) as written by tools/limiter_replay.py.
+bool loadReplayEvents(FILE *in, std::vector<ReplayEvent> &events);
+
+void printReplayKpis(FILE *out, const ReplayKpis &kpis);
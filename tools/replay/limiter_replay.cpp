@@ -0,0 +1,170 @@
+// Host replay of recorded meter readings through the limiter; built and driven by tools/limiter_replay.py.
+//
+//   limiter_replay --events events.txt [--rows setpoints.csv] [--pid 1 --kp 0.35 ...]
+//
+// Prints the KPIs as one JSON object on stdout.
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ReplaySim.h"
+
+namespace
+{
+// Firmware defaults of the Limiter settings.
+ReplayConfig defaultConfig()
+{
+    ReplayConfig config;
+    config.limiter.controllerEnabled = true;
+    config.limiter.maxOutputW = 1100;
+    config.limiter.minOutputW = 500;
+    config.limiter.correctionOffsetW = 50;
+    config.limiter.smoothingSize = 10;
+    config.limiter.usePid = false;
+    config.limiter.pidKp = 0.35f;
+    config.limiter.pidKi = 0.05f;
+    config.limiter.pidKd = 0.02f;
+    config.limiter.publishPeriodSec = 2.0f;
+    config.limiter.useEstimator = true;
+    return config;
+}
+
+void usage()
+{
+    fprintf(stderr,
+            "usage: limiter_replay --events FILE [--rows FILE] [--min W] [--max W] [--offset W] [--smoothing N]\n"
+            "                      [--pid 0|1] [--kp F] [--ki F] [--kd F] [--period S] [--negative off|min|zero]\n"
+            "                      [--estimator 0|1] [--tau S] [--pv-cap recorded|none]\n");
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ReplayConfig config = defaultConfig();
+    const char *eventsPath = nullptr;
+    const char *rowsPath = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (value == nullptr)
+        {
+            usage();
+            return 2;
+        }
+        ++i;
+        if (strcmp(arg, "--events") == 0)
+        {
+            eventsPath = value;
+        }
+        else if (strcmp(arg, "--rows") == 0)
+        {
+            rowsPath = value;
+        }
+        else if (strcmp(arg, "--min") == 0)
+        {
+            config.limiter.minOutputW = atoi(value);
+        }
+        else if (strcmp(arg, "--max") == 0)
+        {
+            config.limiter.maxOutputW = atoi(value);
+        }
+        else if (strcmp(arg, "--offset") == 0)
+        {
+            config.limiter.correctionOffsetW = atoi(value);
+        }
+        else if (strcmp(arg, "--smoothing") == 0)
+        {
+            config.limiter.smoothingSize = atoi(value);
+        }
+        else if (strcmp(arg, "--pid") == 0)
+        {
+            config.limiter.usePid = atoi(value) != 0;
+        }
+        else if (strcmp(arg, "--kp") == 0)
+        {
+            config.limiter.pidKp = static_cast<float>(atof(value));
+        }
+        else if (strcmp(arg, "--ki") == 0)
+        {
+            config.limiter.pidKi = static_cast<float>(atof(value));
+        }
+        else if (strcmp(arg, "--kd") == 0)
+        {
+            config.limiter.pidKd = static_cast<float>(atof(value));
+        }
+        else if (strcmp(arg, "--period") == 0)
+        {
+            config.limiter.publishPeriodSec = static_cast<float>(atof(value));
+        }
+        else if (strcmp(arg, "--negative") == 0)
+        {
+            config.limiter.forceMinOnNegativePrice = strcmp(value, "min") == 0;
+            config.limiter.setZeroOnNegativePrice = strcmp(value, "zero") == 0;
+        }
+        else if (strcmp(arg, "--estimator") == 0)
+        {
+            config.limiter.useEstimator = atoi(value) != 0;
+        }
+        else if (strcmp(arg, "--tau") == 0)
+        {
+            config.inverterTauSec = static_cast<float>(atof(value));
+        }
+        else if (strcmp(arg, "--pv-cap") == 0)
+        {
+            config.pvCapFromRecording = strcmp(value, "none") != 0;
+        }
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+
+    FILE *in = eventsPath != nullptr ? fopen(eventsPath, "r") : stdin;
+    if (in == nullptr)
+    {
+        perror(eventsPath);
+        return 1;
+    }
+    std::vector<ReplayEvent> events;
+    const bool parsed = loadReplayEvents(in, events);
+    if (in != stdin)
+    {
+        fclose(in);
+    }
+    if (!parsed)
+    {
+        fprintf(stderr, "malformed event file\n");
+        return 1;
+    }
+
+    FILE *rows = nullptr;
+    if (rowsPath != nullptr)
+    {
+        rows = fopen(rowsPath, "w");
+        if (rows == nullptr)
+        {
+            perror(rowsPath);
+            return 1;
+        }
+        fputs("t_ms,grid_meas_w,grid_true_w,solar_meas_w,calc_w,set_w,output_w\n", rows);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const ReplayKpis kpis = runReplay(events, config, rows);
+    const double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (rows != nullptr)
+    {
+        fclose(rows);
+    }
+
+    printReplayKpis(stdout, kpis);
+    fputc('\n', stdout);
+    fprintf(stderr, "%zu events, %.2f h simulated in %.3f s (%.0fx real time)\n", events.size(), kpis.simulatedHours, wallSec,
+            wallSec > 0.0 ? kpis.simulatedHours * 3600.0 / wallSec : 0.0);
+    return 0;
+}
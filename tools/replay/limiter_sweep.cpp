@@ -0,0 +1,338 @@
+// Parallel parameter sweep over recorded readings; built and driven by tools/limiter_sweep.py.
+//
+//   limiter_sweep --events events.txt --mode pid --kp 0.1:1:0.1 --ki 0:0.2:0.02 --offset 0,25,50
+//
+// Every candidate is replayed through ReplaySim on all cores. Prints the Pareto front over
+// (import Wh, export Wh, setpoint changes) and the recommended settings.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "ReplaySim.h"
+
+namespace
+{
+constexpr size_t SWEEP_PRINT_ROWS = 20;
+
+struct Candidate
+{
+    ReplayConfig config;
+    ReplayKpis kpis;
+    bool pareto = false;
+};
+
+// "from:to:step", "a,b,c" or a single value.
+bool expandSpec(const char *spec, std::vector<float> &values)
+{
+    values.clear();
+    float from = 0.0f;
+    float to = 0.0f;
+    float step = 0.0f;
+    if (sscanf(spec, "%f:%f:%f", &from, &to, &step) == 3)
+    {
+        if (step <= 0.0f || to < from)
+        {
+            return false;
+        }
+        const int count = static_cast<int>((to - from) / step + 1.0001f);
+        for (int i = 0; i < count; ++i)
+        {
+            values.push_back(from + step * static_cast<float>(i));
+        }
+        return true;
+    }
+    const char *cursor = spec;
+    while (*cursor != '\0')
+    {
+        char *end = nullptr;
+        const float value = strtof(cursor, &end);
+        if (end == cursor)
+        {
+            return false;
+        }
+        values.push_back(value);
+        cursor = *end == ',' ? end + 1 : end;
+    }
+    return !values.empty();
+}
+
+double importWh(const Candidate &c) { return c.kpis.importKwh * 1000.0; }
+double exportWh(const Candidate &c) { return c.kpis.exportKwh * 1000.0; }
+
+bool dominates(const Candidate &a, const Candidate &b)
+{
+    const bool noWorse = importWh(a) <= importWh(b) && exportWh(a) <= exportWh(b) && a.kpis.setpointChanges <= b.kpis.setpointChanges;
+    const bool better = importWh(a) < importWh(b) || exportWh(a) < exportWh(b) || a.kpis.setpointChanges < b.kpis.setpointChanges;
+    return noWorse && better;
+}
+
+void printCandidateRow(FILE *out, const Candidate &c)
+{
+    const LimiterSettingsValues &l = c.config.limiter;
+    fprintf(out, "%-8s %6.3f %6.3f %6.3f %6d %6d %10.0f %10.0f %8lu\n", l.usePid ? "pid" : "smoother",
+            l.usePid ? l.pidKp : 0.0f, l.usePid ? l.pidKi : 0.0f, l.usePid ? l.pidKd : 0.0f, l.usePid ? 0 : l.smoothingSize,
+            l.correctionOffsetW, importWh(c), exportWh(c), static_cast<unsigned long>(c.kpis.setpointChanges));
+}
+
+void usage()
+{
+    fprintf(stderr,
+            "usage: limiter_sweep --events FILE [--mode pid|smoother|both] [--kp SPEC] [--ki SPEC] [--kd SPEC]\n"
+            "                     [--smoothing SPEC] [--offset SPEC] [--min W] [--max W] [--period S] [--estimator 0|1]\n"
+            "                     [--tau S] [--pv-cap recorded|none] [--threads N] [--change-cost WH] [--csv FILE]\n"
+            "SPEC: from:to:step, a,b,c or a single value\n");
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    ReplayConfig base;
+    base.limiter.controllerEnabled = true;
+    base.limiter.maxOutputW = 1100;
+    base.limiter.minOutputW = 500;
+    base.limiter.publishPeriodSec = 2.0f;
+    base.limiter.useEstimator = true;
+
+    const char *eventsPath = nullptr;
+    const char *csvPath = nullptr;
+    const char *mode = "pid";
+    std::vector<float> kp{0.35f}, ki{0.05f}, kd{0.02f}, smoothing{10.0f}, offset{50.0f};
+    unsigned threads = std::thread::hardware_concurrency();
+    double changeCostWh = 1.0;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const char *arg = argv[i];
+        const char *value = argv[i + 1];
+        bool ok = true;
+        if (strcmp(arg, "--events") == 0)
+        {
+            eventsPath = value;
+        }
+        else if (strcmp(arg, "--csv") == 0)
+        {
+            csvPath = value;
+        }
+        else if (strcmp(arg, "--mode") == 0)
+        {
+            mode = value;
+        }
+        else if (strcmp(arg, "--kp") == 0)
+        {
+            ok = expandSpec(value, kp);
+        }
+        else if (strcmp(arg, "--ki") == 0)
+        {
+            ok = expandSpec(value, ki);
+        }
+        else if (strcmp(arg, "--kd") == 0)
+        {
+            ok = expandSpec(value, kd);
+        }
+        else if (strcmp(arg, "--smoothing") == 0)
+        {
+            ok = expandSpec(value, smoothing);
+        }
+        else if (strcmp(arg, "--offset") == 0)
+        {
+            ok = expandSpec(value, offset);
+        }
+        else if (strcmp(arg, "--min") == 0)
+        {
+            base.limiter.minOutputW = atoi(value);
+        }
+        else if (strcmp(arg, "--max") == 0)
+        {
+            base.limiter.maxOutputW = atoi(value);
+        }
+        else if (strcmp(arg, "--period") == 0)
+        {
+            base.limiter.publishPeriodSec = static_cast<float>(atof(value));
+        }
+        else if (strcmp(arg, "--estimator") == 0)
+        {
+            base.limiter.useEstimator = atoi(value) != 0;
+        }
+        else if (strcmp(arg, "--tau") == 0)
+        {
+            base.inverterTauSec = static_cast<float>(atof(value));
+        }
+        else if (strcmp(arg, "--pv-cap") == 0)
+        {
+            base.pvCapFromRecording = strcmp(value, "none") != 0;
+        }
+        else if (strcmp(arg, "--threads") == 0)
+        {
+            threads = static_cast<unsigned>(atoi(value));
+        }
+        else if (strcmp(arg, "--change-cost") == 0)
+        {
+            changeCostWh = atof(value);
+        }
+        else
+        {
+            ok = false;
+        }
+        if (!ok)
+        {
+            fprintf(stderr, "bad argument: %s %s\n", arg, value);
+            usage();
+            return 2;
+        }
+    }
+    if (eventsPath == nullptr || (argc % 2) == 0)
+    {
+        usage();
+        return 2;
+    }
+
+    FILE *in = fopen(eventsPath, "r");
+    if (in == nullptr)
+    {
+        perror(eventsPath);
+        return 1;
+    }
+    std::vector<ReplayEvent> events;
+    const bool parsed = loadReplayEvents(in, events);
+    fclose(in);
+    if (!parsed || events.empty())
+    {
+        fprintf(stderr, "malformed or empty event file\n");
+        return 1;
+    }
+
+    const bool sweepPid = strcmp(mode, "pid") == 0 || strcmp(mode, "both") == 0;
+    const bool sweepSmoother = strcmp(mode, "smoother") == 0 || strcmp(mode, "both") == 0;
+    std::vector<Candidate> candidates;
+    for (float off : offset)
+    {
+        Candidate candidate;
+        candidate.config = base;
+        candidate.config.limiter.correctionOffsetW = static_cast<int>(off);
+        if (sweepPid)
+        {
+            candidate.config.limiter.usePid = true;
+            for (float p : kp)
+            {
+                for (float i : ki)
+                {
+                    for (float d : kd)
+                    {
+                        candidate.config.limiter.pidKp = p;
+                        candidate.config.limiter.pidKi = i;
+                        candidate.config.limiter.pidKd = d;
+                        candidates.push_back(candidate);
+                    }
+                }
+            }
+        }
+        if (sweepSmoother)
+        {
+            candidate.config.limiter.usePid = false;
+            for (float s : smoothing)
+            {
+                candidate.config.limiter.smoothingSize = static_cast<int>(s);
+                candidates.push_back(candidate);
+            }
+        }
+    }
+    if (candidates.empty())
+    {
+        usage();
+        return 2;
+    }
+
+    // Candidates differ a lot in cost (PID vs. large smoother windows), so workers pull the next
+    // index from a shared counter instead of getting fixed slices.
+    threads = std::max(1u, std::min<unsigned>(threads == 0 ? 1u : threads, static_cast<unsigned>(candidates.size())));
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> nextCandidate{0};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&]()
+                          {
+            for (size_t i = nextCandidate.fetch_add(1); i < candidates.size(); i = nextCandidate.fetch_add(1))
+            {
+                candidates[i].kpis = runReplay(events, candidates[i].config, nullptr);
+            } });
+    }
+    for (std::thread &worker : pool)
+    {
+        worker.join();
+    }
+    const double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<size_t> front;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        bool dominated = false;
+        for (size_t j = 0; j < candidates.size() && !dominated; ++j)
+        {
+            dominated = j != i && dominates(candidates[j], candidates[i]);
+        }
+        candidates[i].pareto = !dominated;
+        if (!dominated)
+        {
+            front.push_back(i);
+        }
+    }
+    auto cost = [&](const Candidate &c)
+    { return importWh(c) + exportWh(c) + changeCostWh * c.kpis.setpointChanges; };
+    std::sort(front.begin(), front.end(), [&](size_t a, size_t b)
+              { return cost(candidates[a]) < cost(candidates[b]); });
+
+    if (csvPath != nullptr)
+    {
+        FILE *csv = fopen(csvPath, "w");
+        if (csv == nullptr)
+        {
+            perror(csvPath);
+            return 1;
+        }
+        fputs("mode,kp,ki,kd,smoothing,offset_w,import_wh,export_wh,setpoint_changes,mean_abs_grid_w,pareto\n", csv);
+        for (const Candidate &c : candidates)
+        {
+            const LimiterSettingsValues &l = c.config.limiter;
+            fprintf(csv, "%s,%.4f,%.4f,%.4f,%d,%d,%.1f,%.1f,%lu,%.1f,%d\n", l.usePid ? "pid" : "smoother", l.pidKp, l.pidKi,
+                    l.pidKd, l.smoothingSize, l.correctionOffsetW, importWh(c), exportWh(c),
+                    static_cast<unsigned long>(c.kpis.setpointChanges), c.kpis.meanAbsGridW, c.pareto ? 1 : 0);
+        }
+        fclose(csv);
+    }
+
+    printf("%zu candidates x %.1f h on %u threads in %.2f s\n\n", candidates.size(), candidates[0].kpis.simulatedHours,
+           threads, wallSec);
+    printf("Pareto front (%zu), best first by import + export + %.2f Wh per setpoint change:\n", front.size(), changeCostWh);
+    printf("%-8s %6s %6s %6s %6s %6s %10s %10s %8s\n", "mode", "kp", "ki", "kd", "smooth", "offset", "import_Wh",
+           "export_Wh", "changes");
+    for (size_t n = 0; n < front.size() && n < SWEEP_PRINT_ROWS; ++n)
+    {
+        printCandidateRow(stdout, candidates[front[n]]);
+    }
+    if (front.size() > SWEEP_PRINT_ROWS)
+    {
+        printf("... %zu more (--csv lists all candidates)\n", front.size() - SWEEP_PRINT_ROWS);
+    }
+
+    const LimiterSettingsValues &best = candidates[front.front()].config.limiter;
+    printf("\nRecommended settings (Settings -> Limiter):\n");
+    printf("  Use PID Smoothing = %s\n", best.usePid ? "true" : "false");
+    if (best.usePid)
+    {
+        printf("  PID Kp = %.3f\n  PID Ki = %.3f\n  PID Kd = %.3f\n", best.pidKp, best.pidKi, best.pidKd);
+    }
+    else
+    {
+        printf("  Smoothing Level = %d\n", best.smoothingSize);
+    }
+    printf("  Input Correction Offset (W) = %d\n", best.correctionOffsetW);
+    printf("  Use State Estimator = %s\n", best.useEstimator ? "true" : "false");
+    return 0;
+}
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""
+Load-test the RS485 transport (src/RS485Module) on Linux against tools/virtual_inverter.py.
+
+Usage:
+    python tools/rs485_loadtest.py                                   # 500 frames, 20 ms apart, 4800 baud
+    python tools/rs485_loadtest.py --frames 2000 --interval-ms 0     # back to back
+    python tools/rs485_loadtest.py --inverter "--corrupt-rate 0.01 --stall-every 100 --stall-ms 500"
+
+RS485Module.cpp is compiled unchanged against the host shim in tools/vinverter/shim:
+HardwareSerial writes to the PTY of the virtual inverter and flush() waits for the wire
+time at the configured baud rate, digitalWrite() logs DE edges with timestamps.
+Exit code 1 when a frame held DE high longer than wire time + guard delays + 2 ms.
+"""
+
+import argparse
+import json
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+from limiter_replay import BUILD_DIR, SRC
+
+TOOLS = Path(__file__).resolve().parent
+VINVERTER = TOOLS / "vinverter"
+
+
+def build_loadtest():
+    import shutil
+
+    cxx = os.environ.get("CXX") or shutil.which("g++") or shutil.which("clang++")
+    if not cxx:
+        sys.exit("no C++ compiler found (set CXX)")
+    BUILD_DIR.mkdir(parents=True, exist_ok=True)
+    binary = BUILD_DIR / "rs485_loadtest"
+    sources = [
+        VINVERTER / "rs485_loadtest.cpp",
+        VINVERTER / "HostArduino.cpp",
+        SRC / "RS485Module" / "RS485Module.cpp",
+        SRC / "RS485Module" / "RS485Frame.cpp",
+    ]
+    inputs = sources + list((VINVERTER / "shim").glob("*.h")) + list((SRC / "RS485Module").glob("*.h"))
+    if binary.exists() and all(p.stat().st_mtime <= binary.stat().st_mtime for p in inputs):
+        return binary
+    # The shim directory comes first so <Arduino.h> and "ConfigManager.h" resolve to it.
+    cmd = [cxx, "-std=gnu++17", "-O2", "-pthread", "-I" + str(VINVERTER / "shim"), "-I" + str(SRC)]
+    cmd += [str(s) for s in sources] + ["-o", str(binary)]
+    subprocess.run(cmd, check=True)
+    return binary
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--frames", type=int, default=500)
+    parser.add_argument("--interval-ms", type=int, default=20)
+    parser.add_argument("--baud", type=int, default=4800)
+    parser.add_argument("--inverter", default="", help="extra options for virtual_inverter.py (quoted)")
+    args = parser.parse_args()
+
+    binary = build_loadtest()
+    with tempfile.TemporaryDirectory() as tmp:
+        report_path = Path(tmp) / "inverter.json"
+        inverter = subprocess.Popen(
+            [sys.executable, str(TOOLS / "virtual_inverter.py"), "--report", str(report_path)] + shlex.split(args.inverter),
+            stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True)
+        try:
+            line = inverter.stdout.readline().strip()
+            if not line.startswith("PTY "):
+                sys.exit("virtual inverter did not start: %r" % line)
+            port = line[4:]
+            result = subprocess.run([str(binary), "--port", port, "--frames", str(args.frames),
+                                     "--interval-ms", str(args.interval_ms), "--baud", str(args.baud)])
+        finally:
+            inverter.terminate()
+            inverter.wait(timeout=5)
+
+        print("virtual inverter:")
+        if report_path.exists():
+            for key, value in json.loads(report_path.read_text()).items():
+                print("  %-18s %s" % (key, value))
+    return result.returncode
+
+
+if __name__ == "__main__":
+    sys.exit(main())
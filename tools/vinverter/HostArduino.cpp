@@ -0,0 +1,210 @@
+#include "Arduino.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+HardwareSerial Serial(0);
+HardwareSerial Serial2(2);
+
+namespace
+{
+const uint64_t startUs = hostMicros64();
+
+std::mutex gpioMutex;
+std::vector<HostGpioEdge> gpioLog;
+uint8_t pinLevels[64] = {};
+
+void waitUntil(uint64_t targetUs)
+{
+    // nanosleep overshoots by tens of µs; spin for the last part like the ROM delay does.
+    while (true)
+    {
+        const uint64_t now = hostMicros64();
+        if (now >= targetUs)
+        {
+            return;
+        }
+        if (targetUs - now > 200)
+        {
+            const timespec pause = {0, static_cast<long>((targetUs - now - 100) * 1000)};
+            nanosleep(&pause, nullptr);
+        }
+    }
+}
+} // namespace
+
+uint64_t hostMicros64()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000ULL + static_cast<uint64_t>(now.tv_nsec) / 1000ULL;
+}
+
+uint32_t micros()
+{
+    return static_cast<uint32_t>(hostMicros64() - startUs);
+}
+
+uint32_t millis()
+{
+    return static_cast<uint32_t>((hostMicros64() - startUs) / 1000ULL);
+}
+
+void delay(uint32_t ms)
+{
+    waitUntil(hostMicros64() + static_cast<uint64_t>(ms) * 1000ULL);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    waitUntil(hostMicros64() + us);
+}
+
+void pinMode(uint8_t, uint8_t)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t level)
+{
+    std::lock_guard<std::mutex> lock(gpioMutex);
+    if (pin < sizeof(pinLevels) && pinLevels[pin] == level && !gpioLog.empty())
+    {
+        return;
+    }
+    if (pin < sizeof(pinLevels))
+    {
+        pinLevels[pin] = level;
+    }
+    gpioLog.push_back(HostGpioEdge{pin, level, hostMicros64()});
+}
+
+int digitalRead(uint8_t pin)
+{
+    std::lock_guard<std::mutex> lock(gpioMutex);
+    return pin < sizeof(pinLevels) ? pinLevels[pin] : LOW;
+}
+
+size_t hostGpioEdges(HostGpioEdge *out, size_t maxEdges)
+{
+    std::lock_guard<std::mutex> lock(gpioMutex);
+    const size_t count = gpioLog.size() < maxEdges ? gpioLog.size() : maxEdges;
+    for (size_t i = 0; i < count; ++i)
+    {
+        out[i] = gpioLog[i];
+    }
+    gpioLog.erase(gpioLog.begin(), gpioLog.begin() + static_cast<long>(count));
+    return count;
+}
+
+void HardwareSerial::attach(const char *devicePath)
+{
+    snprintf(path, sizeof(path), "%s", devicePath);
+}
+
+void HardwareSerial::begin(unsigned long baudRate, uint32_t, int8_t, int8_t)
+{
+    end();
+    baud = baudRate;
+    const char *target = path[0] != '\0' ? path : "/dev/null";
+    fileDescriptor = open(target, O_RDWR | O_NOCTTY);
+    if (fileDescriptor < 0)
+    {
+        fprintf(stderr, "[HostSerial] UART%d: cannot open %s (%d)\n", uart, target, errno);
+        return;
+    }
+    termios tio;
+    if (tcgetattr(fileDescriptor, &tio) == 0)
+    {
+        cfmakeraw(&tio);
+        tcsetattr(fileDescriptor, TCSANOW, &tio);
+    }
+    txIdleAtUs = hostMicros64();
+}
+
+void HardwareSerial::end()
+{
+    if (fileDescriptor >= 0)
+    {
+        close(fileDescriptor);
+        fileDescriptor = -1;
+    }
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (fileDescriptor < 0 || size == 0)
+    {
+        return 0;
+    }
+    // 8N1: 10 bit times per byte. A full PTY buffer blocks here like a full TX FIFO.
+    const uint64_t now = hostMicros64();
+    const uint64_t wireUs = baud > 0 ? (static_cast<uint64_t>(size) * 10ULL * 1000000ULL) / baud : 0;
+    txIdleAtUs = (txIdleAtUs > now ? txIdleAtUs : now) + wireUs;
+
+    size_t written = 0;
+    while (written < size)
+    {
+        const ssize_t n = ::write(fileDescriptor, buffer + written, size - written);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return written;
+}
+
+void HardwareSerial::flush()
+{
+    if (fileDescriptor < 0)
+    {
+        return;
+    }
+    tcdrain(fileDescriptor);
+    waitUntil(txIdleAtUs);
+}
+
+int HardwareSerial::available()
+{
+    if (fileDescriptor < 0)
+    {
+        return 0;
+    }
+    int count = 0;
+    return ioctl(fileDescriptor, FIONREAD, &count) == 0 ? count : 0;
+}
+
+int HardwareSerial::read()
+{
+    uint8_t value = 0;
+    if (fileDescriptor < 0 || available() <= 0 || ::read(fileDescriptor, &value, 1) != 1)
+    {
+        return -1;
+    }
+    return value;
+}
+
+size_t HardwareSerial::readBytes(char *buffer, size_t length)
+{
+    size_t got = 0;
+    while (got < length && available() > 0)
+    {
+        const ssize_t n = ::read(fileDescriptor, buffer + got, length - got);
+        if (n <= 0)
+        {
+            break;
+        }
+        got += static_cast<size_t>(n);
+    }
+    return got;
+}
@@ -0,0 +1,142 @@
+// Drives the real RS485Module transport against a PTY; built and run by tools/rs485_loadtest.py.
+//
+//   rs485_loadtest --port /dev/pts/7 [--frames 500] [--interval-ms 20] [--baud 4800]
+//
+// Sends a setpoint ramp through sendToRS485(), drains anything echoed back through
+// reciveFromRS485(), and reports call time and DE-high time per frame against the
+// wire time the baud rate allows.
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "RS485Module/RS485Module.h"
+#include "RS485Module/RS485Frame.h"
+
+RS485_Settings rs485settings;
+
+namespace
+{
+struct Stats
+{
+    std::vector<uint32_t> samples;
+
+    void add(uint32_t value) { samples.push_back(value); }
+
+    void print(const char *name)
+    {
+        if (samples.empty())
+        {
+            printf("  %-12s no samples\n", name);
+            return;
+        }
+        std::sort(samples.begin(), samples.end());
+        uint64_t sum = 0;
+        for (uint32_t value : samples)
+        {
+            sum += value;
+        }
+        const size_t p99 = (samples.size() * 99) / 100;
+        printf("  %-12s min %6lu  avg %6lu  p99 %6lu  max %6lu us\n", name, static_cast<unsigned long>(samples.front()),
+               static_cast<unsigned long>(sum / samples.size()),
+               static_cast<unsigned long>(samples[p99 < samples.size() ? p99 : samples.size() - 1]),
+               static_cast<unsigned long>(samples.back()));
+    }
+};
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const char *port = nullptr;
+    int frames = 500;
+    int intervalMs = 20;
+    int baud = rs485settings.baudRate.get();
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--port") == 0)
+        {
+            port = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "--frames") == 0)
+        {
+            frames = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--interval-ms") == 0)
+        {
+            intervalMs = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--baud") == 0)
+        {
+            baud = atoi(argv[i + 1]);
+        }
+    }
+    if (port == nullptr || frames <= 0 || baud <= 0)
+    {
+        fprintf(stderr, "usage: rs485_loadtest --port PATH [--frames N] [--interval-ms MS] [--baud B]\n");
+        return 2;
+    }
+
+    rs485settings.baudRate.set(baud);
+    Serial2.attach(port);
+    RS485begin();
+    if (Serial2.fd() < 0)
+    {
+        return 1;
+    }
+
+    const uint8_t dePin = static_cast<uint8_t>(rs485settings.dePin.get());
+    const uint32_t wireUs = static_cast<uint32_t>((RS485_FRAME_BYTES * 10UL * 1000000UL) / static_cast<unsigned long>(baud));
+    const uint32_t budgetUs = wireUs + 200 + 2000; // wire + both DE guard delays + 2 ms scheduling slack
+
+    Stats callTime;
+    Stats deHigh;
+    int overBudget = 0;
+    size_t echoedBytes = 0;
+    HostGpioEdge edges[16];
+    uint64_t lastHighUs = 0;
+
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        const uint16_t demand = static_cast<uint16_t>((frame * 37) % 1200);
+        const uint32_t start = micros();
+        sendToRS485(demand);
+        const uint32_t elapsed = micros() - start;
+        callTime.add(elapsed);
+
+        const size_t count = hostGpioEdges(edges, sizeof(edges) / sizeof(edges[0]));
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (edges[i].pin != dePin)
+            {
+                continue;
+            }
+            if (edges[i].level == HIGH)
+            {
+                lastHighUs = edges[i].atUs;
+            }
+            else if (lastHighUs != 0)
+            {
+                const uint32_t highUs = static_cast<uint32_t>(edges[i].atUs - lastHighUs);
+                deHigh.add(highUs);
+                if (highUs > budgetUs)
+                {
+                    ++overBudget;
+                }
+                lastHighUs = 0;
+            }
+        }
+
+        echoedBytes += reciveFromRS485().length() / 3;
+        delay(static_cast<uint32_t>(intervalMs));
+    }
+
+    printf("%d frames at %d baud, wire time %lu us per frame, DE budget %lu us\n", frames, baud,
+           static_cast<unsigned long>(wireUs), static_cast<unsigned long>(budgetUs));
+    callTime.print("sendToRS485");
+    deHigh.print("DE high");
+    printf("  over budget  %d\n", overBudget);
+    printf("  echoed bytes %zu\n", echoedBytes);
+    return overBudget > 0 ? 1 : 0;
+}
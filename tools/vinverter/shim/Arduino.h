@@ -0,0 +1,89 @@
+#pragma once
+
+// Host stand-in for the parts of the Arduino core that RS485Module uses.
+// HardwareSerial talks to a file (normally the slave side of a PTY opened by
+// tools/virtual_inverter.py) and paces writes at the configured baud rate, so
+// flush() takes as long as the real UART would. digitalWrite() keeps a timestamped
+// log per pin so DE toggling can be checked.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+typedef uint8_t byte;
+
+static constexpr uint8_t LOW = 0;
+static constexpr uint8_t HIGH = 1;
+static constexpr uint8_t INPUT = 0;
+static constexpr uint8_t OUTPUT = 3;
+static constexpr uint32_t SERIAL_8N1 = 0x800001c;
+
+uint32_t micros();
+uint32_t millis();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+int digitalRead(uint8_t pin);
+
+class String
+{
+public:
+    String() = default;
+    String(const char *text) : value(text != nullptr ? text : "") {}
+    String &operator+=(const char *text)
+    {
+        value += text;
+        return *this;
+    }
+    const char *c_str() const { return value.c_str(); }
+    size_t length() const { return value.size(); }
+
+private:
+    std::string value;
+};
+
+class HardwareSerial
+{
+public:
+    explicit HardwareSerial(int uartNumber) : uart(uartNumber) {}
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+    void end();
+
+    size_t write(uint8_t value) { return write(&value, 1); }
+    size_t write(const uint8_t *buffer, size_t size);
+    void flush(); // returns when the last written bit would have left the UART
+    int available();
+    int read();
+    size_t readBytes(char *buffer, size_t length);
+
+    // Host only: file the next begin() opens (e.g. /dev/pts/7).
+    void attach(const char *path);
+    unsigned long baudRate() const { return baud; }
+    int fd() const { return fileDescriptor; }
+
+private:
+    int uart;
+    int fileDescriptor = -1;
+    char path[128] = {};
+    unsigned long baud = 0;
+    uint64_t txIdleAtUs = 0; // when the bytes written so far have been shifted out
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial2;
+
+// Host only: every level change per pin, for DE timing checks.
+struct HostGpioEdge
+{
+    uint8_t pin;
+    uint8_t level;
+    uint64_t atUs;
+};
+
+size_t hostGpioEdges(HostGpioEdge *out, size_t maxEdges); // drains the log
+uint64_t hostMicros64();
@@ -0,0 +1,45 @@
+#pragma once
+
+// Host stand-in for the ESP32 Configuration Manager: settings are plain values with their defaults.
+
+#include <stdio.h>
+
+template <typename T>
+struct ConfigOptions
+{
+    const char *key = nullptr;
+    const char *name = nullptr;
+    const char *category = nullptr;
+    T defaultValue{};
+    int sortOrder = 0;
+};
+
+template <typename T>
+class Config
+{
+public:
+    explicit Config(const ConfigOptions<T> &options) : value(options.defaultValue) {}
+    T get() const { return value; }
+    void set(T next) { value = next; }
+
+private:
+    T value;
+};
+
+class ConfigManagerClass
+{
+public:
+    template <typename T>
+    void addSetting(Config<T> *) {}
+};
+
+#define CM_LOG(...)                   \
+    do                                \
+    {                                 \
+        fprintf(stderr, __VA_ARGS__); \
+        fputc('\n', stderr);          \
+    } while (0)
+#define CM_LOG_VERBOSE(...) \
+    do                      \
+    {                       \
+    } while (0)
@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+"""
+Virtual inverter on a Linux pseudo-terminal, for exercising RS485Module without hardware.
+
+Usage:
+    python tools/virtual_inverter.py                         # prints "PTY /dev/pts/N", runs until Ctrl+C
+    python tools/virtual_inverter.py --corrupt-rate 0.01 --drop-rate 0.005
+    python tools/virtual_inverter.py --stall-every 50 --stall-ms 300 --echo
+
+It decodes the 8-byte setpoint frames (src/RS485Module/RS485Frame.h), checks the checksum,
+and models the inverter output ramping towards the last valid limit (--ramp, W/s, capped at --pv W).
+Fault injection on the received bytes: random bit flips (--corrupt-rate) and lost bytes (--drop-rate).
+--stall-every/--stall-ms stop reading for a while, so the sender runs into back-pressure.
+--echo writes every received byte back, like a transceiver with the receiver left enabled.
+A summary is printed on exit (Ctrl+C / SIGTERM), or written as JSON with --report.
+"""
+
+import argparse
+import json
+import os
+import random
+import select
+import signal
+import sys
+import time
+import tty
+
+HEADER = bytes([0x24, 0x56, 0x00, 0x21])
+FRAME_BYTES = 8
+
+
+class VirtualInverter:
+    def __init__(self, args):
+        self.args = args
+        self.rng = random.Random(args.seed)
+        self.buffer = bytearray()
+        self.frames = 0
+        self.bad_checksum = 0
+        self.bad_marker = 0
+        self.skipped_bytes = 0
+        self.corrupted = 0
+        self.dropped = 0
+        self.stalls = 0
+        self.limit_w = 0
+        self.output_w = 0.0
+        self.last_model_s = time.monotonic()
+        self.last_frame_s = None
+        self.gaps_ms = []
+
+    def inject(self, data):
+        out = bytearray()
+        for value in data:
+            if self.rng.random() < self.args.drop_rate:
+                self.dropped += 1
+                continue
+            if self.rng.random() < self.args.corrupt_rate:
+                value ^= 1 << self.rng.randrange(8)
+                self.corrupted += 1
+            out.append(value)
+        return bytes(out)
+
+    def update_model(self):
+        now = time.monotonic()
+        step = self.args.ramp * (now - self.last_model_s)
+        target = min(self.limit_w, self.args.pv)
+        if self.output_w < target:
+            self.output_w = min(target, self.output_w + step)
+        else:
+            self.output_w = max(target, self.output_w - step)
+        self.last_model_s = now
+
+    def feed(self, data):
+        self.buffer += data
+        while len(self.buffer) >= FRAME_BYTES:
+            start = self.buffer.find(HEADER)
+            if start < 0:
+                keep = len(HEADER) - 1
+                self.skipped_bytes += len(self.buffer) - keep
+                del self.buffer[:-keep]
+                return
+            if start > 0:
+                self.skipped_bytes += start
+                del self.buffer[:start]
+                continue
+            frame = bytes(self.buffer[:FRAME_BYTES])
+            high, low, marker, checksum = frame[4], frame[5], frame[6], frame[7]
+            if marker != 0x80:
+                self.bad_marker += 1
+                del self.buffer[:1]  # resync inside the frame
+                continue
+            if (264 - high - low) & 0xFF != checksum:
+                self.bad_checksum += 1
+                del self.buffer[:1]
+                continue
+            del self.buffer[:FRAME_BYTES]
+            self.accept((high << 8) | low)
+
+    def accept(self, limit_w):
+        now = time.monotonic()
+        if self.last_frame_s is not None:
+            self.gaps_ms.append((now - self.last_frame_s) * 1000.0)
+        self.last_frame_s = now
+        self.update_model()
+        self.limit_w = limit_w
+        self.frames += 1
+        if self.args.verbose:
+            print("frame %6d limit %5d W output %7.1f W" % (self.frames, limit_w, self.output_w), flush=True)
+
+    def report(self):
+        self.update_model()
+        gaps = sorted(self.gaps_ms)
+        return {
+            "frames": self.frames,
+            "bad_checksum": self.bad_checksum,
+            "bad_marker": self.bad_marker,
+            "skipped_bytes": self.skipped_bytes,
+            "injected_bit_flips": self.corrupted,
+            "injected_drops": self.dropped,
+            "stalls": self.stalls,
+            "limit_w": self.limit_w,
+            "output_w": round(self.output_w, 1),
+            "gap_ms_min": round(gaps[0], 2) if gaps else None,
+            "gap_ms_median": round(gaps[len(gaps) // 2], 2) if gaps else None,
+            "gap_ms_max": round(gaps[-1], 2) if gaps else None,
+        }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--ramp", type=float, default=200.0, help="output ramp in W/s (default 200)")
+    parser.add_argument("--pv", type=float, default=800.0, help="available PV power in W (default 800)")
+    parser.add_argument("--corrupt-rate", type=float, default=0.0, help="probability of a bit flip per byte")
+    parser.add_argument("--drop-rate", type=float, default=0.0, help="probability of losing a byte")
+    parser.add_argument("--stall-every", type=int, default=0, help="stop reading after every N frames")
+    parser.add_argument("--stall-ms", type=float, default=0.0, help="length of a read stall")
+    parser.add_argument("--echo", action="store_true", help="write received bytes back")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--report", help="write the summary as JSON to this file on exit")
+    parser.add_argument("--verbose", action="store_true", help="print every accepted frame")
+    args = parser.parse_args()
+
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    print("PTY %s" % os.ttyname(slave), flush=True)
+
+    inverter = VirtualInverter(args)
+    running = True
+
+    def stop(*_):
+        nonlocal running
+        running = False
+
+    signal.signal(signal.SIGTERM, stop)
+    signal.signal(signal.SIGINT, stop)
+
+    next_stall_at = args.stall_every
+    while running:
+        try:
+            ready, _, _ = select.select([master], [], [], 0.1)
+        except InterruptedError:
+            continue
+        if not ready:
+            continue
+        try:
+            data = os.read(master, 4096)
+        except OSError:
+            break  # sender closed the port
+        if args.echo:
+            os.write(master, data)
+        inverter.feed(inverter.inject(data))
+        if args.stall_every and inverter.frames >= next_stall_at:
+            next_stall_at = inverter.frames + args.stall_every
+            inverter.stalls += 1
+            time.sleep(args.stall_ms / 1000.0)
+
+    summary = inverter.report()
+    if args.report:
+        with open(args.report, "w") as handle:
+            json.dump(summary, handle, indent=2)
+    print(json.dumps(summary, indent=2), file=sys.stderr)
+    os.close(slave)
+    os.close(master)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())